@@ -38,12 +38,13 @@ namespace lmms
 class EffectChain;
 class FloatModel;
 class BoolModel;
+class FrozenAudio;
 
 /**
 	@brief Job between @ref PlayHandle and @ref MixerChannel
 
 	A @ref ThreadableJob class located at the exit point of each @ref PlayHandle into a @ref MixerChannel
-	(or into an audio device, in case of @ref AudioJack, but this is not supported in AudioBusHandle yet).
+	(and into an audio device, in case of the multi-output mode of @ref AudioJack).
 	It contains an optional @ref EffectChain which is e.g. visualized in the
 	@ref InstrumentTrackWindow or @ref SampleTrackWindow.
 	For processing, it adds all input play handles into an internal buffer,
@@ -60,7 +61,8 @@ public:
 
 	SampleFrame* buffer() { return m_buffer; }
 
-	// indicate whether JACK & Co should provide output-buffer at ext. port
+	// indicate whether JACK & Co should provide output-buffer at ext. port.
+	// While enabled, buffer() holds the output of the last period, even if it is silent.
 	bool extOutputEnabled() const { return m_extOutputEnabled; }
 	void setExtOutputEnabled(bool enabled);
 
@@ -78,10 +80,22 @@ public:
 	// ThreadableJob stuff
 	void doProcessing() override;
 	bool requiresProcessing() const override { return true; }
+	JobProfiler::SourceId profilerSource() const override { return m_profilerSource.id(); }
+
+	//! The source that the play handles rendering into this bus handle are accounted to
+	JobProfiler::SourceId playHandlesProfilerSource() const { return m_playHandlesProfilerSource.id(); }
 
 	void addPlayHandle(PlayHandle* handle);
 	void removePlayHandle(PlayHandle* handle);
 
+	//! While the song is played, send @p audio to the mixer instead of the play handles, which are ignored, and skip
+	//! volume, panning and effects. nullptr goes back to normal processing. Call between
+	//! AudioEngine::requestChangeInModel() and AudioEngine::doneChangeInModel().
+	void setFrozenAudio(const FrozenAudio* audio) { m_frozenAudio = audio; }
+	//! Additionally write everything sent to the mixer into @p audio while it is rendered by TrackFreezer, or stop
+	//! with nullptr. Call between AudioEngine::requestChangeInModel() and AudioEngine::doneChangeInModel().
+	void setFreezeCapture(FrozenAudio* audio) { m_freezeCapture = audio; }
+
 private:
 	volatile bool m_bufferUsage;
 
@@ -101,6 +115,12 @@ private:
 	FloatModel* m_panningModel;
 	BoolModel* m_mutedModel;
 
+	const FrozenAudio* m_frozenAudio = nullptr;
+	FrozenAudio* m_freezeCapture = nullptr;
+
+	JobProfiler::Source m_profilerSource;
+	JobProfiler::Source m_playHandlesProfilerSource;
+
 	friend class AudioEngine;
 	friend class AudioEngineWorkerThread;
 };
@@ -64,6 +64,33 @@ public:
 	virtual void registerPort(AudioBusHandle* port);
 	virtual void unregisterPort(AudioBusHandle* port);
 	virtual void renamePort(AudioBusHandle* port);
+	//! Carry out port changes that were requested while the engine was locked. Called once it is unlocked again.
+	virtual void applyPortChanges() {}
+
+	//! Whether the engine may render ahead on a separate thread instead of when the device asks for the next buffer.
+	//! Devices reading the buffers of bus handles need the latter, so that those belong to the period being output.
+	virtual bool allowsFifo() const
+	{
+		return true;
+	}
+
+	//! The frames the device asks for in each callback, or 0 if it does not have a fixed callback size
+	virtual fpp_t callbackFrames() const
+	{
+		return 0;
+	}
+
+	//! Frames it takes from the physical inputs until recorded audio reaches the device, if it knows
+	virtual f_cnt_t captureLatency() const
+	{
+		return 0;
+	}
+
+	//! Frames it takes from handing audio to the device until it reaches the physical outputs, if it knows
+	virtual f_cnt_t playbackLatency() const
+	{
+		return 0;
+	}
 
 	inline bool supportsCapture() const
 	{
@@ -48,6 +48,9 @@ namespace lmms
 class MidiClient;
 class AudioBusHandle;  // IWYU pragma: keep
 class AudioEngineWorkerThread;
+class SampleRecorder;
+template<class T> class LocklessRingBuffer;
+template<class T> class LocklessRingBufferReader;
 
 constexpr fpp_t MINIMUM_BUFFER_SIZE = 32;
 constexpr fpp_t DEFAULT_BUFFER_SIZE = 256;
@@ -106,7 +109,24 @@ public:
 		AudioEngine* m_audioEngine;
 	};
 
-	void initDevices();
+	//! How long audio takes from the inputs of the audio device through the engine to its outputs, by stage.
+	//! All stages are in frames.
+	struct LatencyReport
+	{
+		sample_rate_t sampleRate = 0;
+		f_cnt_t capture = 0;  //!< Reported by the audio device for its inputs
+		f_cnt_t input = 0;    //!< Recorded frames reach the engine once per device callback
+		f_cnt_t period = 0;   //!< Periods larger than the device callbacks are rendered before the first one is output
+		f_cnt_t fifo = 0;     //!< Rendered ahead of the audio device by the FIFO writer
+		f_cnt_t output = 0;   //!< Rendered frames are output once per device callback
+		f_cnt_t playback = 0; //!< Reported by the audio device for its outputs
+
+		f_cnt_t total() const { return capture + input + period + fifo + output + playback; }
+		float milliseconds(f_cnt_t frames) const { return 1000.f * frames / sampleRate; }
+	};
+
+	void initAudioDevice();
+	void initMidiClient();
 	void clear();
 	void clearNewPlayHandles();
 
@@ -130,6 +150,11 @@ public:
 	void setAudioDevice(AudioDevice* _dev, bool _needs_fifo, bool startNow);
 	void storeAudioDevice();
 	void restoreAudioDevice();
+	//! Whether the device for exporting or freezing temporarily replaces the one stored with storeAudioDevice()
+	bool hasStoredAudioDevice() const
+	{
+		return m_oldAudioDev != nullptr;
+	}
 	inline AudioDevice * audioDev()
 	{
 		return m_audioDev;
@@ -178,6 +203,14 @@ public:
 		return m_framesPerPeriod;
 	}
 
+	//! Whether the period was set to the callback size of the audio device, see "matchdeviceperiod"
+	bool matchesDevicePeriod() const { return m_matchesDevicePeriod; }
+
+	//! Whether samples are resampled to the engine sample rate in the background, see "resamplesamples"
+	bool resamplesSamples() const { return m_resampleSamples; }
+
+	LatencyReport latencyReport() const;
+
 
 	AudioEngineProfiler& profiler()
 	{
@@ -241,16 +274,24 @@ public:
 		return m_fifoWriter != nullptr;
 	}
 
-	void pushInputFrames( SampleFrame* _ab, const f_cnt_t _frames );
+	//! Called by the audio device with recorded frames. Realtime safe and lock-free, frames that don't fit into the
+	//! input queue are dropped.
+	void pushInputFrames(const SampleFrame* frames, f_cnt_t count);
 
+	//! The frames recorded during the previous period
 	inline const SampleFrame* inputBuffer()
 	{
-		return m_inputBuffer[ m_inputBufferRead ];
+		return m_inputBuffer.data();
 	}
 
 	inline f_cnt_t inputBufferFrames() const
 	{
-		return m_inputBufferFrames[ m_inputBufferRead ];
+		return m_inputBufferFrames;
+	}
+
+	SampleRecorder& sampleRecorder()
+	{
+		return *m_sampleRecorder;
 	}
 
 	inline const SampleFrame* nextBuffer()
@@ -267,6 +308,13 @@ public:
 		return RequestChangesGuard{this};
 	}
 
+	//! Lock the model for rendering from a realtime callback, which must not wait for it. The lock does not own the
+	//! mutex if the model is being changed, in which case the callback should output silence instead.
+	std::unique_lock<std::recursive_mutex> tryLockModel()
+	{
+		return std::unique_lock{m_changeMutex, std::try_to_lock};
+	}
+
 	static bool isAudioDevNameValid(QString name);
 	static bool isMidiDevNameValid(QString name);
 
@@ -309,6 +357,10 @@ private:
 	AudioDevice * tryAudioDevices();
 	MidiClient * tryMidiClients();
 
+	//! Render periods of the size the audio device asks for in each callback, if it has a fixed one. Must be called
+	//! before anything allocates buffers of the period size.
+	void adoptDevicePeriod();
+
 	void renderStageNoteSetup();
 	void renderStageInstruments();
 	void renderStageEffects();
@@ -325,13 +377,19 @@ private:
 	std::vector<AudioBusHandle*> m_audioBusHandles;
 
 	fpp_t m_framesPerPeriod;
+	bool m_matchDevicePeriod;
+	bool m_matchesDevicePeriod;
+	bool m_resampleSamples;
 
-	SampleFrame* m_inputBuffer[2];
-	f_cnt_t m_inputBufferFrames[2];
-	f_cnt_t m_inputBufferSize[2];
 	sample_rate_t m_baseSampleRate;
-	int m_inputBufferRead;
-	int m_inputBufferWrite;
+
+	//! Filled by the audio device and emptied into m_inputBuffer at the start of each period
+	std::unique_ptr<LocklessRingBuffer<SampleFrame>> m_inputQueue;
+	std::unique_ptr<LocklessRingBufferReader<SampleFrame>> m_inputReader;
+	std::vector<SampleFrame> m_inputBuffer;
+	f_cnt_t m_inputBufferFrames;
+
+	std::unique_ptr<SampleRecorder> m_sampleRecorder;
 
 	std::unique_ptr<SampleFrame[]> m_outputBufferRead;
 	std::unique_ptr<SampleFrame[]> m_outputBufferWrite;
@@ -27,10 +27,13 @@
 
 #include <array>
 #include <atomic>
+#include <cstdint>
 #include <QFile>
 
+#include "JobProfiler.h"
 #include "LmmsTypes.h"
 #include "MicroTimer.h"
+#include "TraceRecorder.h"
 
 namespace lmms
 {
@@ -44,6 +47,7 @@ public:
 	void startPeriod()
 	{
 		m_periodTimer.reset();
+		JobProfiler::instance().startPeriod();
 	}
 
 	void finishPeriod( sample_rate_t sampleRate, fpp_t framesPerPeriod );
@@ -70,12 +74,22 @@ public:
 		return m_detailLoad[static_cast<std::size_t>(type)].load(std::memory_order_relaxed);
 	}
 
+	//! Total time spent in @p type since the last call to resetDetailTotals(), in microseconds.
+	//! Not synchronized with the audio engine, so only meaningful while it is not processing.
+	std::uint64_t detailTotalTime(const DetailType type) const
+	{
+		return m_detailTotalTime[static_cast<std::size_t>(type)];
+	}
+
+	void resetDetailTotals() { m_detailTotalTime.fill(0); }
+
 	class Probe
 	{
 	public:
 		Probe(AudioEngineProfiler& profiler, AudioEngineProfiler::DetailType type)
 			: m_profiler(profiler)
 			, m_type(type)
+			, m_trace(TraceRecorder::Category::Engine, detailName(type))
 		{
 			profiler.startDetail(type);
 		}
@@ -87,13 +101,57 @@ public:
 	private:
 		AudioEngineProfiler &m_profiler;
 		const AudioEngineProfiler::DetailType m_type;
+		const TraceRecorder::Scope m_trace;
+	};
+
+	static auto detailName(DetailType type) -> const char*
+	{
+		switch (type)
+		{
+			case DetailType::NoteSetup: return "Note setup";
+			case DetailType::Instruments: return "Instruments";
+			case DetailType::Effects: return "Effects";
+			case DetailType::Mixing: return "Mixing";
+			default: return "";
+		}
+	}
+
+	//! Running processing time statistics of a single job, such as an effect.
+	//! Written only by the thread running the job (once per period) and readable from any thread.
+	class Timing
+	{
+	public:
+		void record(int elapsedMicroseconds)
+		{
+			const auto mean = m_meanTime.load(std::memory_order_relaxed);
+			m_meanTime.store(elapsedMicroseconds * 0.05f + mean * 0.95f, std::memory_order_relaxed);
+
+			if (elapsedMicroseconds > m_maxTime.load(std::memory_order_relaxed))
+			{
+				m_maxTime.store(elapsedMicroseconds, std::memory_order_relaxed);
+			}
+		}
+
+		//! Exponentially averaged time per period in microseconds
+		float meanTime() const { return m_meanTime.load(std::memory_order_relaxed); }
+
+		//! Longest time taken by a single period in microseconds since the last call to resetMaxTime()
+		int maxTime() const { return m_maxTime.load(std::memory_order_relaxed); }
+
+		void resetMaxTime() { m_maxTime.store(0, std::memory_order_relaxed); }
+
+	private:
+		std::atomic<float> m_meanTime = 0.f;
+		std::atomic<int> m_maxTime = 0;
 	};
 
 private:
 	void startDetail(const DetailType type) { m_detailTimer[static_cast<std::size_t>(type)].reset(); }
 	void finishDetail(const DetailType type)
 	{
-		m_detailTime[static_cast<std::size_t>(type)] = m_detailTimer[static_cast<std::size_t>(type)].elapsed();
+		const auto elapsed = m_detailTimer[static_cast<std::size_t>(type)].elapsed();
+		m_detailTime[static_cast<std::size_t>(type)] = elapsed;
+		m_detailTotalTime[static_cast<std::size_t>(type)] += elapsed;
 	}
 
 	MicroTimer m_periodTimer;
@@ -104,6 +162,7 @@ private:
 	std::array<MicroTimer, DetailCount> m_detailTimer;
 	std::array<int, DetailCount> m_detailTime{0};
 	std::array<std::atomic<float>, DetailCount> m_detailLoad{0};
+	std::array<std::uint64_t, DetailCount> m_detailTotalTime{};
 };
 
 } // namespace lmms
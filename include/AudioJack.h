@@ -34,18 +34,15 @@
 #include <weak_libjack.h>
 #endif
 
+#include <array>
 #include <atomic>
+#include <mutex>
 #include <vector>
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-#include <QMap>
-#endif
 
 #include "AudioDevice.h"
 #include "AudioDeviceSetupWidget.h"
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-#include "AudioBusHandle.h"
-#endif
 
+class QCheckBox;
 class QLineEdit;
 class QMenu;
 class QToolButton;
@@ -56,6 +53,9 @@ namespace lmms
 class MidiJack;
 
 
+//! Outputs the master mix to a pair of JACK ports. In multi-output mode, every track additionally gets a pair of
+//! ports of its own, e.g. for routing stems into an external mixer. The engine then renders in the process callback,
+//! whose output is copied straight from the buffers of the engine and its bus handles into the JACK ports.
 class AudioJack : public QObject, public AudioDevice
 {
 	Q_OBJECT
@@ -89,6 +89,7 @@ public:
 
 	private:
 		QLineEdit* m_clientName;
+		QCheckBox* m_multiOutput;
 		// Because we do not have access to a JackAudio driver instance we have to be our own client to display inputs and outputs...
 		jack_client_t* m_client;
 
@@ -100,6 +101,33 @@ private slots:
 	void restartAfterZombified();
 
 private:
+	//! The ports of a bus handle in multi-output mode
+	struct BusPorts
+	{
+		AudioBusHandle* bus;
+		std::array<jack_port_t*, DEFAULT_CHANNELS> ports;
+	};
+
+	//! A change to the JACK ports of a bus handle. JACK may wait for the process callback while doing it, so it is
+	//! deferred until the engine is not locked anymore.
+	struct PortChange
+	{
+		enum class Type
+		{
+			Register,
+			Unregister,
+			Rename
+		};
+
+		Type type;
+		//! The bus handle to register or rename the ports of
+		AudioBusHandle* bus;
+		//! The name to register or rename the ports with
+		QString name;
+		//! The ports to unregister
+		std::array<jack_port_t*, DEFAULT_CHANNELS> ports;
+	};
+
 	bool initJackClient();
 	void resizeInputBuffer(jack_nframes_t nframes);
 
@@ -113,8 +141,29 @@ private:
 	void registerPort(AudioBusHandle* port) override;
 	void unregisterPort(AudioBusHandle* port) override;
 	void renamePort(AudioBusHandle* port) override;
+	void applyPortChanges() override;
+	void applyPortChange(const PortChange& change);
+	//! Stop outputting @p bus and drop its pending changes. Both the engine and m_portsMutex must be locked.
+	void forgetBus(AudioBusHandle* bus);
+
+	//! The bus handles are only read in sync with the master output if the engine renders in the process callback
+	bool allowsFifo() const override
+	{
+		return !m_multiOutput;
+	}
+
+	fpp_t callbackFrames() const override;
+	f_cnt_t captureLatency() const override;
+	f_cnt_t playbackLatency() const override;
+	//! The largest latency of @p ports in direction @p mode
+	static f_cnt_t portLatency(const std::vector<jack_port_t*>& ports, jack_latency_callback_mode_t mode);
+
+	//! @p name, or @p name with a number appended, so that no ports of the client but @p own have the resulting names
+	QString uniqueBusPortName(const QString& name, const BusPorts* own = nullptr) const;
 
 	int processCallback(jack_nframes_t nframes);
+	//! Make the next period of the engine the current buffer. Returns false if there is none.
+	bool nextPeriod();
 
 	static int staticProcessCallback(jack_nframes_t nframes, void* udata);
 	static void shutdownCallback(void* _udata);
@@ -127,22 +176,26 @@ private:
 	std::atomic<MidiJack*> m_midiClient;
 	std::vector<jack_port_t*> m_outputPorts;
 	std::vector<jack_port_t*> m_inputPorts;
-	jack_default_audio_sample_t** m_tempOutBufs;
 	std::vector<SampleFrame> m_inputFrameBuffer;
 	SampleFrame* m_outBuf;
 
+	//! The period being output, which is either m_outBuf or owned by the engine
+	const SampleFrame* m_curBuf;
 	f_cnt_t m_framesDoneInCurBuf;
 	f_cnt_t m_framesToDoInCurBuf;
 
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-	struct StereoPort
-	{
-		jack_port_t* ports[2];
-	};
-
-	using JackPortMap = QMap<AudioBusHandle*, StereoPort>;
-	JackPortMap m_portMap;
-#endif
+	const bool m_multiOutput;
+	//! Only changed while both the engine and m_portsMutex are locked. The process callback tries to lock the engine
+	//! in multi-output mode, and only locks m_portsMutex for outputting silence if it fails.
+	std::vector<BusPorts> m_busPorts;
+	//! The bus handles which should have ports, including those whose registration is pending
+	std::vector<AudioBusHandle*> m_buses;
+	std::vector<PortChange> m_portChanges;
+	//! Protects m_buses and m_portChanges, and m_busPorts together with the engine. Only ever held briefly.
+	std::mutex m_portsMutex;
+	//! Serializes applying the port changes, so that ports are not unregistered while another thread renames them
+	std::recursive_mutex m_applyMutex;
+	bool m_applyingPortChanges = false;
 
 signals:
 	void zombified();
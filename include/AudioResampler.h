@@ -25,6 +25,7 @@
 #ifndef LMMS_AUDIO_RESAMPLER_H
 #define LMMS_AUDIO_RESAMPLER_H
 
+#include <array>
 #include <memory>
 #include "AudioBufferView.h"
 #include "lmms_export.h"
@@ -35,7 +36,10 @@ namespace lmms {
  * @class AudioResampler
  * @brief A utility class for resampling interleaved audio buffers using various resampling algorithms.
  *
- * This class provides support for zero-order hold, linear, and several levels of sinc-based resampling.
+ * This class provides support for zero-order hold, linear, cubic, and several levels of sinc-based resampling.
+ *
+ * Stereo audio is resampled by built-in SIMD kernels in the modes up to `SincFastest`, which uses precomputed
+ * polyphase filter banks. The higher quality sinc modes and other channel counts use libsamplerate.
  */
 class LMMS_EXPORT AudioResampler
 {
@@ -48,6 +52,7 @@ public:
 	{
 		ZOH,		 //!< Zero Order Hold (nearest-neighbor) interpolation.
 		Linear,		 //!< Linear interpolation.
+		Cubic,		 //!< Cubic Hermite interpolation.
 		SincFastest, //!< Fastest sinc-based resampling.
 		SincMedium,	 //!< Medium quality sinc-based resampling.
 		SincBest	 //!< Highest quality sinc-based resampling.
@@ -115,12 +120,22 @@ public:
 	auto mode() const -> Mode { return m_mode; }
 
 private:
+	//! Frames of history kept by the built-in kernels, enough for the widest filter
+	static constexpr auto MaxHistoryFrames = f_cnt_t{32};
+
+	auto processKernel(InterleavedBufferView<const float> input, InterleavedBufferView<float> output) -> Result;
+
 	struct LMMS_EXPORT StateDeleter { void operator()(void* state); };
+	//! The libsamplerate state, or nullptr if the built-in kernels are used
 	std::unique_ptr<void, StateDeleter> m_state;
 	Mode m_mode;
 	ch_cnt_t m_channels = 0;
 	double m_ratio = 1.0;
 	int m_error = 0;
+
+	//! State of the built-in kernels: the last input frames and the position of the next output frame within them
+	std::array<float, MaxHistoryFrames * 2> m_history = {};
+	double m_position = 0.0;
 };
 
 } // namespace lmms
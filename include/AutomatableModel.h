@@ -25,7 +25,9 @@
 #ifndef LMMS_AUTOMATABLE_MODEL_H
 #define LMMS_AUTOMATABLE_MODEL_H
 
+#include <atomic>
 #include <cmath>
+#include <vector>
 #include <QMap>
 #include <QMutex>
 
@@ -274,6 +276,9 @@ public:
 		return "automatablemodel";
 	}
 
+	//! Journals the value only, as that is all the user changes after a check point
+	std::unique_ptr<JournalEntry> createJournalEntry() override;
+
 	virtual QString displayValue( const float val ) const = 0;
 
 	bool isLinked() const
@@ -311,6 +316,10 @@ public:
 		s_periodCounter = 0;
 	}
 
+	//! Compute the value buffers of all models connected to a controller for the current period. Called by the
+	//! audio engine after evaluating the controllers, so that instruments and effects only read the results.
+	static void updateControlledValueBuffers();
+
 	bool useControllerValue() const
 	{
 		return m_useControllerValue;
@@ -340,6 +349,8 @@ protected:
 
 
 private:
+	class ValueJournalEntry;
+
 	// dynamicCast implementation
 	template<class Target>
 	struct DCastVisitor : public ModelVisitor
@@ -412,9 +423,13 @@ private:
 
 
 	ValueBuffer m_valueBuffer;
-	long m_lastUpdatedPeriod;
+	//! Released once m_valueBuffer and m_hasSampleExactData are valid for the period
+	std::atomic<long> m_lastUpdatedPeriod;
 	static long s_periodCounter;
 
+	//! Models with a controller connection, changed with the audio engine locked
+	static std::vector<AutomatableModel*> s_controlledModels;
+
 	bool m_hasSampleExactData;
 
 	// prevent several threads from attempting to write the same vb at the same time
@@ -37,6 +37,7 @@
 namespace lmms::gui
 {
 
+class JobLoadView;
 
 class CPULoadWidget : public QWidget
 {
@@ -49,6 +50,7 @@ public:
 
 protected:
 	void paintEvent( QPaintEvent * _ev ) override;
+	void mousePressEvent(QMouseEvent* event) override;
 
 
 protected slots:
@@ -70,6 +72,8 @@ private:
 
 	int m_stepSize = 1;
 
+	JobLoadView* m_jobLoadView = nullptr;
+
 } ;
 
 
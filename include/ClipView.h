@@ -81,6 +81,9 @@ public:
 		return m_trackView;
 	}
 
+	//! Whether the user is moving or resizing the clip
+	bool isBeingEdited() const { return m_action != Action::None; }
+
 	// qproperty access func
 	QColor mutedColor() const;
 	QColor mutedBackgroundColor() const;
@@ -130,6 +130,10 @@ public:
 	static void triggerFrameCounter();
 	static void resetFrameCounter();
 
+	//! Evaluate all controllers that are connected to a model for the current period. Called by the audio engine
+	//! before instruments and effects run, so that they only read the buffers.
+	static void updateValueBuffers();
+
 	//Accepts a ControllerConnection * as it may be used in the future.
 	void addConnection( ControllerConnection * );
 	void removeConnection( ControllerConnection * );
@@ -27,6 +27,7 @@
 #define LMMS_DATA_FILE_H
 
 #include <map>
+#include <memory>
 #include <QDomDocument>
 #include <vector>
 
@@ -37,6 +38,7 @@ class QTextStream;
 namespace lmms
 {
 
+class ProjectContainer;
 class ProjectVersion;
 
 
@@ -44,6 +46,25 @@ class LMMS_EXPORT DataFile : public QDomDocument
 {
 
 	using UpgradeMethod = void(DataFile::*)();
+	using ElementUpgradeMethod = void(*)(QDomElement&);
+
+	//! An upgrade routine. Most of them walk the document on their own. Those that only change the tag name and
+	//! attributes of single elements instead list the tags they apply to and are given one element at a time, so that
+	//! consecutive ones share a single walk over the document.
+	struct Upgrade
+	{
+		Upgrade(UpgradeMethod method) : method(method) {}
+		Upgrade(std::vector<QString> tags, ElementUpgradeMethod elementMethod) :
+			tags(std::move(tags)),
+			elementMethod(elementMethod)
+		{}
+
+		UpgradeMethod method = nullptr;
+		std::vector<QString> tags;
+		ElementUpgradeMethod elementMethod = nullptr;
+	};
+
+	using UpgradeIterator = std::vector<Upgrade>::const_iterator;
 
 public:
 	enum class Type
@@ -77,6 +98,8 @@ public:
 	bool writeFile(const QString& fn, bool withResources = false);
 	bool copyResources(const QString& resourcesDir); //!< Copies resources to the resourcesDir and changes the DataFile to use local paths to them
 	bool hasLocalPlugins(QDomElement parent = QDomElement(), bool firstCall = true) const;
+	//! Paths of the sample files the document refers to, as they are written in it
+	std::vector<QString> sampleFiles() const;
 
 	QDomElement& content()
 	{
@@ -101,43 +124,44 @@ private:
 
 	void cleanMetaNodes( QDomElement de );
 
-	void mapSrcAttributeInElementsWithResources(const QMap<QString, QString>& map);
+	static void mapSrcAttribute(QDomElement& el, const QMap<QString, QString>& map);
+	static std::vector<QString> resourceElementNames();
 
 	// helper upgrade routines
 	void upgrade_0_2_1_20070501();
 	void upgrade_0_2_1_20070508();
-	void upgrade_0_3_0_rc2();
-	void upgrade_0_3_0();
-	void upgrade_0_4_0_20080104();
+	static void upgrade_0_3_0_rc2(QDomElement& el);
+	static void upgrade_0_3_0(QDomElement& el);
+	static void upgrade_0_4_0_20080104(QDomElement& el);
 	void upgrade_0_4_0_20080118();
 	void upgrade_0_4_0_20080129();
-	void upgrade_0_4_0_20080409();
-	void upgrade_0_4_0_20080607();
-	void upgrade_0_4_0_20080622();
+	static void upgrade_0_4_0_20080409(QDomElement& el);
+	static void upgrade_0_4_0_20080607(QDomElement& el);
+	static void upgrade_0_4_0_20080622(QDomElement& el);
 	void upgrade_0_4_0_beta1();
-	void upgrade_0_4_0_rc2();
+	static void upgrade_0_4_0_rc2(QDomElement& el);
 	void upgrade_1_0_99();
 	void upgrade_1_1_0();
-	void upgrade_1_1_91();
+	static void upgrade_1_1_91(QDomElement& el);
 	void upgrade_1_2_0_rc3();
 	void upgrade_1_3_0();
 	void upgrade_noHiddenClipNames();
 	void upgrade_automationNodes();
 	void upgrade_extendedNoteRange();
-	void upgrade_defaultTripleOscillatorHQ();
-	void upgrade_mixerRename();
-	void upgrade_bbTcoRename();
-	void upgrade_sampleAndHold();
-	void upgrade_midiCCIndexing();
-	void upgrade_loopsRename();
-	void upgrade_noteTypes();
+	static void upgrade_defaultTripleOscillatorHQ(QDomElement& el);
+	static void upgrade_mixerRename(QDomElement& el);
+	static void upgrade_bbTcoRename(QDomElement& el);
+	static void upgrade_sampleAndHold(QDomElement& el);
+	static void upgrade_midiCCIndexing(QDomElement& el);
+	static void upgrade_loopsRename(QDomElement& el);
+	static void upgrade_noteTypes(QDomElement& el);
 	void upgrade_fixCMTDelays();
-	void upgrade_fixBassLoopsTypo();
+	static void upgrade_fixBassLoopsTypo(QDomElement& el);
 	void findProblematicLadspaPlugins();
 	void upgrade_noHiddenAutomationTracks();
 
 	// List of all upgrade methods
-	static const std::vector<UpgradeMethod> UPGRADE_METHODS;
+	static const std::vector<Upgrade> UPGRADE_METHODS;
 	// List of ProjectVersions for the legacyFileVersion method
 	static const std::vector<ProjectVersion> UPGRADE_VERSIONS;
 
@@ -146,10 +170,17 @@ private:
 	static const ResourcesMap ELEMENTS_WITH_RESOURCES;
 
 	void upgrade();
+	//! Run the element upgrades in [@p first, @p last) in a single walk over the document
+	void upgradeElements(UpgradeIterator first, UpgradeIterator last);
 
 	void loadData( const QByteArray & _data, const QString & _sourceFile );
+	void loadContainer(const QString& sourceFile);
+	//! Set up the file after its document was loaded, upgrading it if needed
+	void loadDocument(const QString& sourceFile);
 
 	QString m_fileName; //!< The origin file name or "" if this DataFile didn't originate from a file
+	//! The binary project this file was loaded from, if any, which holds the embedded data the document refers to
+	std::shared_ptr<ProjectContainer> m_container;
 	QDomElement m_content;
 	QDomElement m_head;
 	Type m_type;
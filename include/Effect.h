@@ -26,8 +26,6 @@
 #ifndef LMMS_EFFECT_H
 #define LMMS_EFFECT_H
 
-#include <span>
-
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
 #include "Engine.h"
@@ -141,6 +139,12 @@ public:
 		return m_parent;
 	}
 
+	//! Time spent processing this effect, including its output post-processing
+	const AudioEngineProfiler::Timing& timing() const
+	{
+		return m_timing;
+	}
+
 	virtual EffectControls * controls() = 0;
 
 	static Effect * instantiate( const QString & _plugin_name,
@@ -184,7 +188,7 @@ private:
 	 * after "decay" ms of the output buffer remaining below the silence threshold, the effect is
 	 * turned off and won't be processed again until it receives new audio input.
 	 */
-	void handleAutoQuit(std::span<const SampleFrame> output);
+	void handleAutoQuit(sample_t outputPeak);
 
 
 	EffectChain * m_parent;
@@ -202,6 +206,9 @@ private:
 
 	bool m_autoQuitEnabled = false;
 
+	AudioEngineProfiler::Timing m_timing;
+	JobProfiler::Source m_profilerSource;
+
 	friend class gui::EffectView;
 	friend class EffectChain;
 
@@ -29,6 +29,7 @@
 #include "Model.h"
 #include "SerializingObject.h"
 #include "AutomatableModel.h"
+#include "JobProfiler.h"
 
 namespace lmms
 {
@@ -68,6 +69,10 @@ public:
 
 	void clear();
 
+	//! The profiler source of the track or mixer channel owning this chain, under which its effects are listed
+	JobProfiler::SourceId profilerOwner() const { return m_profilerOwner; }
+	void setProfilerOwner(JobProfiler::SourceId owner) { m_profilerOwner = owner; }
+
 
 private:
 	using EffectList = std::vector<Effect*>;
@@ -75,6 +80,8 @@ private:
 
 	BoolModel m_enabledModel;
 
+	JobProfiler::SourceId m_profilerOwner = JobProfiler::NoSource;
+
 
 	friend class gui::EffectRackView;
 
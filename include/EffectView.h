@@ -83,6 +83,7 @@ signals:
 
 protected:
 	void contextMenuEvent( QContextMenuEvent * _me ) override;
+	bool event(QEvent* event) override;
 	void paintEvent( QPaintEvent * _pe ) override;
 	void modelChanged() override;
 
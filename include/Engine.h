@@ -116,6 +116,8 @@ public:
 
 signals:
 	void initProgress(const QString &msg);
+	//! Emitted by destroy() before anything is torn down, so while the project is still loaded
+	void aboutToDestroy();
 
 
 private:
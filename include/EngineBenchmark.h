@@ -0,0 +1,68 @@
+/*
+ * EngineBenchmark.h - Headless benchmark of the audio engine
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_ENGINE_BENCHMARK_H
+#define LMMS_ENGINE_BENCHMARK_H
+
+#include <QString>
+#include <QStringList>
+
+namespace lmms
+{
+
+//! Renders a set of projects as fast as possible and reports realtime factor, time per render stage, peak memory
+//! usage and load time of each as JSON, so that performance regressions of the audio engine show up in numbers.
+//!
+//! Besides the given projects, a set of synthetic stress projects is generated: many TripleOscillator voices, a deep
+//! tree of mixer sends, dense automation, long sample clips and heavy effect chains. Each project is measured in a
+//! separate process running `lmms benchmark --measure`, so that peak memory usage and state are not shared.
+//! The report also lists how many sample voices a single core can resample in realtime with each AudioResampler mode.
+class EngineBenchmark
+{
+public:
+	struct Options
+	{
+		QStringList projects;
+		QString outputFile;	   //!< Standard out is used if empty
+		QString baselineFile;  //!< Report of an earlier run to compare against, if any
+		float tolerance = 0.1f; //!< Realtime factor decrease relative to the baseline that counts as regression
+		int maxSeconds = 60;   //!< Projects are rendered for at most this long, or completely if 0
+		bool synthetic = true;
+		QStringList globalArguments; //!< Passed on to the measuring processes, e.g. "--config <file>"
+	};
+
+	//! Measure all projects and write the report. Returns the exit code, which is non-zero if a project failed
+	//! or regressed compared to the baseline.
+	static int run(const Options& options);
+
+	//! Write the synthetic projects into @p dir. Returns the exit code.
+	static int generateSyntheticProjects(const QString& dir);
+
+	//! Render @p project and write the measurements as JSON to @p outputFile. Returns the exit code.
+	static int measure(const QString& project, int maxSeconds, const QString& outputFile);
+};
+
+} // namespace lmms
+
+#endif // LMMS_ENGINE_BENCHMARK_H
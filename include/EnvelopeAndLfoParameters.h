@@ -25,7 +25,9 @@
 #ifndef LMMS_ENVELOPE_AND_LFO_PARAMETERS_H
 #define LMMS_ENVELOPE_AND_LFO_PARAMETERS_H
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "JournallingObject.h"
 #include "AutomatableModel.h"
@@ -56,19 +58,23 @@ public:
 
 		inline bool isEmpty() const
 		{
-			return m_lfos.isEmpty();
+			return m_lfos.empty();
 		}
 
+		//! Called by the audio engine before each period, before any voices are rendered
+		void startPeriod();
+		//! Advance all LFOs by a period and compute their shapes for the next one. Called by the audio engine after
+		//! each period, while no voices are rendered.
 		void trigger();
+		//! Restart all LFOs. Called on the rendering thread before any voices are rendered.
 		void reset();
 
+		//! Only called while the audio engine is locked. It renders while holding its lock, so the list needs none.
 		void add( EnvelopeAndLfoParameters * lfo );
 		void remove( EnvelopeAndLfoParameters * lfo );
 
 	private:
-		QMutex m_lfoListMutex;
-		using LfoList = QList<EnvelopeAndLfoParameters*>;
-		LfoList m_lfos;
+		std::vector<EnvelopeAndLfoParameters*> m_lfos;
 
 	};
 
@@ -97,13 +103,14 @@ public:
 		return s_lfoInstances;
 	}
 
+	//! Realtime safe and lock-free, may be called for any number of voices at once
 	void fillLevel( float * _buf, f_cnt_t _frame,
 				const f_cnt_t _release_begin,
 				const fpp_t _frames );
 
 	inline bool isUsed() const
 	{
-		return m_used;
+		return params().used;
 	}
 
 
@@ -116,12 +123,12 @@ public:
 
 	inline f_cnt_t PAHD_Frames() const
 	{
-		return m_pahdFrames;
+		return params().pahdFrames;
 	}
 
 	inline f_cnt_t releaseFrames() const
 	{
-		return m_rFrames;
+		return params().rFrames;
 	}
 
 	// Envelope
@@ -136,9 +143,9 @@ public:
 
 
 	// LFO
-	inline f_cnt_t getLfoPredelayFrames() const { return m_lfoPredelayFrames; }
-	inline f_cnt_t getLfoAttackFrames() const { return m_lfoAttackFrames; }
-	inline f_cnt_t getLfoOscillationFrames() const { return m_lfoOscillationFrames; }
+	inline f_cnt_t getLfoPredelayFrames() const { return params().lfoPredelayFrames; }
+	inline f_cnt_t getLfoAttackFrames() const { return params().lfoAttackFrames; }
+	inline f_cnt_t getLfoOscillationFrames() const { return params().lfoOscillationFrames; }
 
 	const FloatModel& getLfoAmountModel() const { return m_lfoAmountModel; }
 	FloatModel& getLfoAmountModel() { return m_lfoAmountModel; }
@@ -146,20 +153,54 @@ public:
 	const BoolModel& getX100Model() const { return m_x100Model; }
 	const IntModel& getLfoWaveModel() const { return m_lfoWaveModel; }
 	std::shared_ptr<const SampleBuffer> getLfoUserWave() const { return m_userWave; }
+	void setLfoUserWave(std::shared_ptr<const SampleBuffer> wave);
 
 public slots:
 	void updateSampleVars();
 
 
-protected:
-	void fillLfoLevel( float * _buf, f_cnt_t _frame, const fpp_t _frames );
+private:
+	//! Everything voices need, derived from the models. It is replaced as a whole whenever a model changes, so that
+	//! voices never see half an update and never have to wait for one.
+	struct Params
+	{
+		bool used = false;
+
+		f_cnt_t pahdFrames = 0;
+		f_cnt_t rFrames = 0;
+		std::vector<sample_t> pahdEnv;
+		std::vector<sample_t> rEnv;
+		float sustainLevel = 0.f;
+		bool controlEnvAmount = false;
+
+		f_cnt_t lfoPredelayFrames = 0;
+		f_cnt_t lfoAttackFrames = 0;
+		f_cnt_t lfoOscillationFrames = 1;
+		float lfoAmount = 0.f;
+		bool lfoAmountIsZero = true;
+		LfoShape lfoShape = LfoShape::SineWave;
+		std::shared_ptr<const SampleBuffer> userWave;
+	};
 
+	//! Sequentially consistent, so that publish() can tell whether a voice loaded the parameters it replaced
+	const Params& params() const { return *m_params.load(); }
+
+	//! Make @p params the parameters used by voices from now on
+	void publish(std::unique_ptr<const Params> params);
+
+	void fillLfoLevel(const Params& params, float* buf, f_cnt_t frame, const fpp_t frames) const;
 
-private:
 	static LfoInstances * s_lfoInstances;
-	bool m_used;
+	//! Incremented at the start and at the end of each period, so it is odd while voices may be rendered
+	static std::atomic<unsigned> s_periods;
 
+	std::atomic<const Params*> m_params = nullptr;
+	//! Serializes updates, which may come from any thread, but is never locked by voices
 	QMutex m_paramMutex;
+	std::unique_ptr<const Params> m_currentParams;
+	//! Parameters replaced while a period was rendered, along with that period. Voices may still be using them until
+	//! the period is over.
+	std::vector<std::pair<std::unique_ptr<const Params>, unsigned>> m_retiredParams;
 
 	FloatModel m_predelayModel;
 	FloatModel m_attackModel;
@@ -169,16 +210,7 @@ private:
 	FloatModel m_releaseModel;
 	FloatModel m_amountModel;
 
-	float  m_sustainLevel;
-	float  m_amount;
 	float  m_valueForZeroAmount;
-	float  m_amountAdd;
-	f_cnt_t m_pahdFrames;
-	f_cnt_t m_rFrames;
-	sample_t * m_pahdEnv;
-	sample_t * m_rEnv;
-	f_cnt_t m_pahdBufSize;
-	f_cnt_t m_rBufSize;
 
 
 	FloatModel m_lfoPredelayModel;
@@ -191,20 +223,16 @@ private:
 	BoolModel m_controlEnvAmountModel;
 
 
-	f_cnt_t m_lfoPredelayFrames;
-	f_cnt_t m_lfoAttackFrames;
-	f_cnt_t m_lfoOscillationFrames;
+	//! Only changed by LfoInstances while no voices are rendered
 	f_cnt_t m_lfoFrame;
-	float m_lfoAmount;
-	bool m_lfoAmountIsZero;
-	sample_t * m_lfoShapeData;
+	//! The LFO levels of the current period, shared by all voices
+	std::vector<sample_t> m_lfoShapeData;
 	sample_t m_random;
-	bool m_bad_lfoShapeData;
 	std::shared_ptr<const SampleBuffer> m_userWave = SampleBuffer::emptyBuffer();
 
 	constexpr static auto NumLfoShapes = static_cast<std::size_t>(LfoShape::Count);
 
-	sample_t lfoShapeSample( fpp_t _frame_offset );
+	sample_t lfoShapeSample(const Params& params, fpp_t frameOffset);
 	void updateLfoShapeData();
 
 
@@ -27,7 +27,9 @@
 
 #include <QDir>
 #include <QMutex>
+#include <memory>
 
+#include "FileIndex.h"
 #include "FileSearchJob.h"
 #include "embed.h"
 
@@ -107,6 +109,7 @@ private:
 	Type m_type;
 
 	QProgressBar* m_searchIndicator = nullptr;
+	std::unique_ptr<FileIndex> m_searchIndex; //!< Only set for browsers of user and factory content
 	FileSearchJob m_searchJob;
 
 	QString m_directories; //!< Directories to search, split with '*'
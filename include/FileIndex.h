@@ -0,0 +1,166 @@
+/*
+ * FileIndex.h - Persistent index of the files below the file browser roots
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_GUI_FILE_INDEX_H
+#define LMMS_GUI_FILE_INDEX_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SampleDecoder.h"
+
+namespace lmms::gui {
+//! The `FileIndex` class keeps an in-memory index of every file and directory below a set of root directories.
+//! File names are indexed by trigram so that `FileSearchJob` can answer queries without walking the filesystem.
+//! The index is persisted between sessions, kept current with a filesystem watcher, and records the header
+//! information of audio files so that it can be inspected without decoding them.
+//!
+//! As every directory below the roots is listed and watched, only roots of a bounded size should be indexed, such as
+//! the user and factory content directories.
+class FileIndex : public QObject
+{
+	Q_OBJECT
+public:
+	//! A single indexed file or directory.
+	struct Entry
+	{
+		QString path;		   //! The full path to the file.
+		QString foldedName;	   //! The case folded file name, used for matching.
+		qint64 lastModified{}; //! Modification time in milliseconds since epoch.
+		bool isDir = false;
+		bool isHidden = false;
+		bool removed = false;			//! Entries are tombstoned on removal and compacted later.
+		bool audioProbed = false;		//! Whether @ref audio has been read from the file yet.
+		SampleDecoder::AudioInfo audio; //! Zeroed if the file is not a (readable) audio file.
+	};
+
+	//! Represents a query against the index.
+	struct Query
+	{
+		QStringList tokens;		//! Tokens that must all be contained in the file name.
+		QString root;			//! Only entries below this indexed root are considered.
+		QStringList extensions; //! The list of allowed extensions for files, in the form "*.ext".
+		bool includeHidden = false;
+	};
+
+	//! Create an index with the given @p parent (if any).
+	FileIndex(QObject* parent = nullptr);
+
+	//! Stop any pending indexing work and destroy the object.
+	~FileIndex() override;
+
+	FileIndex(const FileIndex&) = delete;
+	FileIndex(FileIndex&&) = delete;
+	FileIndex& operator=(const FileIndex&) = delete;
+	FileIndex& operator=(FileIndex&&) = delete;
+
+	//! Index the given @p roots, replacing any previously indexed roots.
+	//! A persisted index is loaded if available and then brought up to date incrementally.
+	void setRoots(QStringList roots);
+
+	//! Return true if @p root is fully indexed and can be queried.
+	auto isReady(const QString& root) const -> bool;
+
+	//! Run @p query, invoking @p onMatch for each matching entry until @p stop becomes set.
+	//! Can be called from any thread.
+	void query(const Query& query, const std::function<void(const Entry&)>& onMatch,
+		const std::atomic_flag& stop) const;
+
+	//! Return the audio information recorded for @p path, if any.
+	auto audioInfo(const QString& path) const -> std::optional<SampleDecoder::AudioInfo>;
+
+private:
+	using EntryId = std::uint32_t;
+	using Trigram = std::uint64_t;
+
+	static constexpr auto InvalidEntryId = static_cast<EntryId>(-1);
+
+	void enqueue(std::function<void()> fn);
+	void runJobs();
+	void stopJobs();
+
+	// Indexing jobs. These run one at a time on an idle priority thread and are the only writers of the index,
+	// so they can read it without locking, but must hold m_dataMutex exclusively while modifying it.
+	auto scanRoot(const QString& root) -> QStringList;
+	auto scanDirectory(const QString& dir, bool recursive) -> QStringList;
+	auto verifyRoot(const QString& root) -> QStringList;
+	void probeAudio();
+	void compact();
+
+	//! Must be called with m_dataMutex held exclusively.
+	void addEntry(Entry entry);
+	//! Must be called with m_dataMutex held exclusively.
+	void removeEntry(EntryId id);
+
+	void watchDirectories(const QStringList& dirs);
+	void onDirectoryChanged(const QString& dir);
+	void rescanPendingDirectories();
+	void scheduleSave();
+
+	auto cacheFile() const -> QString;
+	auto load() -> bool;
+	void save() const;
+
+	static auto trigrams(const QString& foldedText) -> std::vector<Trigram>;
+	static auto isAudioFile(const QString& path) -> bool;
+
+	std::vector<Entry> m_entries;
+	QHash<QString, EntryId> m_idByPath;
+	QHash<QString, std::vector<EntryId>> m_childrenByDir;
+	std::unordered_map<Trigram, std::vector<EntryId>> m_postings;
+	std::size_t m_numRemoved = 0;
+	mutable std::shared_mutex m_dataMutex;
+
+	QStringList m_roots;
+	QSet<QString> m_readyRoots; //! Guarded by m_dataMutex
+
+	QFileSystemWatcher m_watcher;
+	QSet<QString> m_pendingDirs;
+	QTimer m_rescanTimer;
+	QTimer m_saveTimer;
+
+	std::mutex m_jobMutex;
+	std::deque<std::function<void()>> m_jobQueue;
+	std::unique_ptr<QThread> m_worker;
+	bool m_workerActive = false;
+	std::atomic_flag m_stop = ATOMIC_FLAG_INIT;
+};
+} // namespace lmms::gui
+
+#endif // LMMS_GUI_FILE_INDEX_H
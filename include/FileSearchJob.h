@@ -31,6 +31,8 @@
 #include <future>
 
 namespace lmms::gui {
+class FileIndex;
+
 //! The `FileSearchJob` class allows for searching for files on the filesystem.
 //! Searching occurs on a background thread, and results are emitted as a Qt slot back to the user.
 class FileSearchJob : public QObject
@@ -44,6 +46,7 @@ public:
 		QStringList paths;				 //! The list of paths to search recursively through.
 		QStringList extensions;			 //! The list of allowed extensions.
 		QFlags<QDir::Filter> dirFilters; //! The directory filter flag.
+		const FileIndex* index = nullptr; //! Index used instead of walking the paths that it is ready for, if any.
 	};
 
 	//! Create a search job with the given @p parent (if any).
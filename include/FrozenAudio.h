@@ -0,0 +1,90 @@
+/*
+ * FrozenAudio.h - Cached output of a frozen track
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_FROZEN_AUDIO_H
+#define LMMS_FROZEN_AUDIO_H
+
+#include <QTemporaryFile>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class SampleFrame;
+
+//! The output of a track over the whole song, as rendered by TrackFreezer. It is kept in a temporary file which is
+//! mapped into memory for playback, so that the operating system pages it in and out as the song is played.
+//!
+//! The audio is indexed by song position rather than time, so that it can be played from anywhere in the song.
+class LMMS_EXPORT FrozenAudio
+{
+public:
+	FrozenAudio();
+	~FrozenAudio();
+
+	FrozenAudio(const FrozenAudio&) = delete;
+	FrozenAudio& operator=(const FrozenAudio&) = delete;
+
+	//! Append a period that starts at @p position, in ticks. Called on the audio threads while freezing, with
+	//! positions in increasing order.
+	void write(const SampleFrame* buffer, fpp_t frames, double position);
+
+	//! Map everything written so far for playback. Returns false if the audio could not be written or mapped.
+	bool finish();
+
+	//! Write the period starting at @p position to @p dst, or silence where there is no audio. Realtime safe.
+	void read(SampleFrame* dst, fpp_t frames, double position) const;
+
+	f_cnt_t frames() const { return m_frameCount; }
+	sample_rate_t sampleRate() const { return m_sampleRate; }
+
+	//! Whether frozen tracks play their frozen audio at the moment, i.e. whether the song is played or exported
+	static bool isSongPlaying();
+
+	//! The song position of the current period, in ticks
+	static double songPosition();
+
+private:
+	struct Period
+	{
+		double position;
+		f_cnt_t frame;
+	};
+
+	const sample_rate_t m_sampleRate;
+
+	QTemporaryFile m_file;
+	bool m_failed = false;
+
+	std::vector<Period> m_periods;
+	f_cnt_t m_frameCount = 0;
+	const SampleFrame* m_frames = nullptr;
+};
+
+} // namespace lmms
+
+#endif // LMMS_FROZEN_AUDIO_H
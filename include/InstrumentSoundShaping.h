@@ -25,8 +25,10 @@
 #ifndef LMMS_INSTRUMENT_SOUND_SHAPING_H
 #define LMMS_INSTRUMENT_SOUND_SHAPING_H
 
+#include "BasicFilters.h"
 #include "ComboBoxModel.h"
 #include "EnvelopeAndLfoParameters.h"
+#include "VoicePool.h"
 
 namespace lmms
 {
@@ -95,6 +97,8 @@ private:
 	ComboBoxModel m_filterModel;
 	FloatModel m_filterCutModel;
 	FloatModel m_filterResModel;
+
+	VoicePool<BasicFilters<>> m_filterPool;
 };
 
 
@@ -46,6 +46,7 @@ namespace lmms
 
 class Instrument;
 class DataFile;
+class FrozenAudio;
 
 namespace gui
 {
@@ -74,6 +75,7 @@ public:
 
 	void processInEvent( const MidiEvent& event, const TimePos& time = TimePos(), f_cnt_t offset = 0 ) override;
 	void processOutEvent( const MidiEvent& event, const TimePos& time = TimePos(), f_cnt_t offset = 0 ) override;
+	bool queuesLiveInput() const override { return true; }
 	// silence all running notes played by this track
 	void silenceAllNotes( bool removeIPH = false );
 
@@ -239,12 +241,31 @@ public:
 
 	void autoAssignMidiDevice( bool );
 
+	//! Play @p audio, as rendered by TrackFreezer, instead of the instrument and effects while the song is played.
+	//! The track is unfrozen as soon as anything the audio depends on changes.
+	void freeze(std::unique_ptr<FrozenAudio> audio);
+
+	bool isFrozen() const
+	{
+		return m_frozenAudio != nullptr;
+	}
+
+	//! Whether the frozen audio is played instead of the instrument at the moment
+	bool playsFrozen() const;
+
+	//! Whether changing @p object changes the output of this track, which would make its frozen audio outdated
+	bool frozenAudioDependsOn(JournallingObject* object);
+
+public slots:
+	void unfreeze();
+
 signals:
 	void instrumentChanged();
 	void midiNoteOn( const lmms::Note& );
 	void midiNoteOff( const lmms::Note& );
 	void newNote();
 	void endNote();
+	void frozenChanged();
 
 protected:
 	QString nodeName() const override
@@ -263,6 +284,10 @@ protected slots:
 	void updateMixerChannel();
 
 
+private slots:
+	void checkFrozenAudio(lmms::JournallingObject* object);
+	void checkFrozenSampleRate();
+
 private:
 	void processCCEvent(int controller);
 
@@ -292,6 +317,9 @@ private:
 	FloatModel m_volumeModel;
 	FloatModel m_panningModel;
 
+	//! Declared before the bus handle, which plays it, so that it is destroyed after it
+	std::unique_ptr<FrozenAudio> m_frozenAudio;
+
 	AudioBusHandle m_audioBusHandle;
 
 	FloatModel m_pitchModel;
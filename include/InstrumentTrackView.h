@@ -71,6 +71,10 @@ public:
 	// Create a menu for assigning/creating channels for this track
 	QMenu * createMixerMenu( QString title, QString newMixerLabel ) override;
 
+public slots:
+	//! Render the track into frozen audio, showing the progress, or unfreeze it if it is frozen
+	void toggleFreeze();
+
 
 protected:
 	void modelChanged() override;
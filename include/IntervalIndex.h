@@ -0,0 +1,134 @@
+/*
+ * IntervalIndex.h - Finding things that overlap a range of time
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef LMMS_INTERVAL_INDEX_H
+#define LMMS_INTERVAL_INDEX_H
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "LmmsTypes.h"
+
+namespace lmms
+{
+
+//! Finds the values overlapping a range of ticks without looking at all of them, e.g. the notes of a clip or the
+//! clips of a track that are visible in an editor.
+//!
+//! Values are ordered by their start, and a tree over that order keeps the latest end below each node, so that a query
+//! only descends into subtrees that contain matches. Queries take O(k log n) for k matches.
+//! The index is a snapshot: it must be rebuilt after values were added, removed or moved.
+template<typename T>
+class IntervalIndex
+{
+public:
+	//! Index @p values, which need not be sorted. @p extent returns the first and last tick of a value as a pair.
+	template<typename Extent>
+	void rebuild(const std::vector<T>& values, Extent extent)
+	{
+		m_entries.clear();
+		for (const auto& value : values)
+		{
+			const auto [start, end] = extent(value);
+			m_entries.push_back(Entry{start, end, value});
+		}
+		std::stable_sort(m_entries.begin(), m_entries.end(),
+			[](const Entry& lhs, const Entry& rhs) { return lhs.start < rhs.start; });
+
+		m_leaves = 1;
+		while (m_leaves < m_entries.size()) { m_leaves *= 2; }
+
+		m_latestEnds.assign(2 * m_leaves, std::numeric_limits<tick_t>::min());
+		for (std::size_t i = 0; i < m_entries.size(); ++i)
+		{
+			m_latestEnds[m_leaves + i] = m_entries[i].end;
+		}
+		for (auto node = m_leaves - 1; node > 0; --node)
+		{
+			m_latestEnds[node] = std::max(m_latestEnds[2 * node], m_latestEnds[2 * node + 1]);
+		}
+	}
+
+	void clear()
+	{
+		m_entries.clear();
+		m_latestEnds.clear();
+		m_leaves = 0;
+	}
+
+	std::size_t size() const { return m_entries.size(); }
+	bool empty() const { return m_entries.empty(); }
+
+	//! Call @p visitor with every value that is at least partly within the ticks [first, last], ordered by start
+	template<typename Visitor>
+	void forEachInRange(tick_t first, tick_t last, Visitor&& visitor) const
+	{
+		if (m_entries.empty()) { return; }
+
+		// Only values starting up to the end of the range can overlap it
+		const auto count = static_cast<std::size_t>(std::partition_point(m_entries.begin(), m_entries.end(),
+			[last](const Entry& entry) { return entry.start <= last; }) - m_entries.begin());
+		visit(1, 0, m_leaves, count, first, visitor);
+	}
+
+private:
+	struct Entry
+	{
+		tick_t start;
+		tick_t end;
+		T value;
+	};
+
+	//! Call @p visitor with every value below @p node, which covers [begin, end), whose index is less than @p count
+	//! and whose end is not before @p first
+	template<typename Visitor>
+	void visit(std::size_t node, std::size_t begin, std::size_t end, std::size_t count, tick_t first,
+		Visitor& visitor) const
+	{
+		if (begin >= count || m_latestEnds[node] < first) { return; }
+
+		if (node >= m_leaves)
+		{
+			visitor(m_entries[begin].value);
+			return;
+		}
+
+		const auto middle = begin + (end - begin) / 2;
+		visit(2 * node, begin, middle, count, first, visitor);
+		visit(2 * node + 1, middle, end, count, first, visitor);
+	}
+
+	//! Ordered by start
+	std::vector<Entry> m_entries;
+	//! Latest end below each node of a complete binary tree over m_entries, with the root at index 1
+	std::vector<tick_t> m_latestEnds;
+	std::size_t m_leaves = 0;
+};
+
+} // namespace lmms
+
+#endif // LMMS_INTERVAL_INDEX_H
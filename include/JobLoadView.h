@@ -0,0 +1,58 @@
+/*
+ * JobLoadView.h - Window listing the processing time of the audio engine jobs
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_GUI_JOB_LOAD_VIEW_H
+#define LMMS_GUI_JOB_LOAD_VIEW_H
+
+#include <QTimer>
+#include <QWidget>
+
+class QTableWidget;
+
+namespace lmms::gui
+{
+
+//! Lists the tracks, effects and mixer channels by the time they take to process per period.
+//! Job profiling is enabled while the view is visible.
+class JobLoadView : public QWidget
+{
+	Q_OBJECT
+public:
+	JobLoadView(QWidget* parent);
+	~JobLoadView() override = default;
+
+protected:
+	void showEvent(QShowEvent* event) override;
+	void hideEvent(QHideEvent* event) override;
+
+private:
+	void updateStats();
+
+	QTableWidget* m_table;
+	QTimer m_updateTimer;
+};
+
+} // namespace lmms::gui
+
+#endif // LMMS_GUI_JOB_LOAD_VIEW_H
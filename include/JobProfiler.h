@@ -0,0 +1,185 @@
+/*
+ * JobProfiler.h - Per-job processing time statistics of the audio engine
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_JOB_PROFILER_H
+#define LMMS_JOB_PROFILER_H
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "MicroTimer.h"
+#include "ThreadRings.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+//! Collects the processing time of individual jobs of the audio engine (play handles, audio bus handles, effects,
+//! mixer channels), so that the job responsible for an overload can be found.
+//!
+//! Jobs record their time into ThreadRings. Draining them sums the times up per period and keeps a rolling window of
+//! the per-period times of each source, from which mean, 99th percentile and maximum are derived.
+//! Recording is disabled by default and costs a single atomic load per job while disabled.
+class LMMS_EXPORT JobProfiler
+{
+public:
+	using SourceId = std::uint32_t;
+	static constexpr auto NoSource = SourceId{0};
+
+	enum class SourceType
+	{
+		PlayHandles,  //!< All play handles rendering into an audio bus handle, i.e. the instrument of a track
+		AudioBus,	  //!< An audio bus handle, including its effect chain
+		Effect,
+		MixerChannel, //!< A mixer channel, including its effect chain
+	};
+
+	struct Stats
+	{
+		QString name;
+		SourceType type;
+		float meanTime; //!< In microseconds per period
+		int p99Time;	//!< In microseconds per period
+		int maxTime;	//!< In microseconds per period
+		std::size_t periods; //!< Number of periods the statistics are based on
+	};
+
+	//! Registers a source for the lifetime of this object
+	class LMMS_EXPORT Source
+	{
+	public:
+		//! @p name and @p parent are only called from the main thread, while collecting statistics.
+		//! The name of the parent source, if any, is prepended to the name of this source.
+		Source(SourceType type, std::function<QString()> name, std::function<SourceId()> parent = {});
+		~Source();
+
+		Source(const Source&) = delete;
+		Source& operator=(const Source&) = delete;
+
+		SourceId id() const { return m_id; }
+
+	private:
+		const SourceId m_id;
+	};
+
+	//! Measures the time until it goes out of scope, if profiling is enabled
+	class Probe
+	{
+	public:
+		Probe(SourceId source)
+			: m_source(instance().isEnabled() ? source : NoSource)
+		{
+		}
+
+		~Probe()
+		{
+			if (m_source != NoSource) { instance().record(m_source, m_timer.elapsed()); }
+		}
+
+		Probe(const Probe&) = delete;
+		Probe& operator=(const Probe&) = delete;
+
+	private:
+		const SourceId m_source;
+		MicroTimer m_timer;
+	};
+
+	~JobProfiler();
+
+	static auto instance() -> JobProfiler&;
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+	//! Called by the audio engine at the start of each period
+	void startPeriod() { m_period.fetch_add(1, std::memory_order_relaxed); }
+
+	//! Record @p microseconds spent processing @p source in the current period. Realtime safe like
+	//! ThreadRings::local().
+	void record(SourceId source, int microseconds);
+
+	//! Return the statistics of all sources that ran since profiling was enabled.
+	//! Must be called from the main thread.
+	auto stats() -> std::vector<Stats>;
+
+	//! Write stats() to @p fileName, as JSON if it ends with ".json" and as CSV otherwise.
+	//! Must be called from the main thread.
+	bool writeStats(const QString& fileName);
+
+	//! Return the name of @p source, or an empty string if it no longer exists.
+	//! Must be called from the main thread.
+	auto sourceName(SourceId source) -> QString;
+
+	static auto typeName(SourceType type) -> QString;
+
+private:
+	struct Sample
+	{
+		SourceId source;
+		std::uint32_t period;
+		int microseconds;
+	};
+
+	struct SourceData
+	{
+		static constexpr auto WindowSize = std::size_t{1024};
+
+		SourceType type;
+		std::function<QString()> name;
+		std::function<SourceId()> parent;
+
+		std::uint32_t openPeriod = 0;
+		int openTime = -1; //!< Time summed up for openPeriod so far, or -1 if none
+		std::vector<int> window = std::vector<int>(WindowSize); //!< Ring buffer of per-period times
+		std::size_t windowPos = 0;
+		std::size_t windowFill = 0;
+	};
+
+	JobProfiler();
+
+	auto addSource(SourceType type, std::function<QString()> name, std::function<SourceId()> parent) -> SourceId;
+	void removeSource(SourceId id);
+
+	void aggregate();
+	auto fullName(SourceId id) const -> QString;
+
+	std::atomic<bool> m_enabled = false;
+	std::atomic<std::uint32_t> m_period = 0;
+
+	ThreadRings<Sample> m_samples{16384};
+
+	std::mutex m_sourcesMutex; //!< Guards m_sources, m_nextSourceId and m_pending
+	std::unordered_map<SourceId, SourceData> m_sources;
+	SourceId m_nextSourceId = NoSource + 1;
+	std::vector<Sample> m_pending;
+};
+
+} // namespace lmms
+
+#endif // LMMS_JOB_PROFILER_H
@@ -25,6 +25,8 @@
 #ifndef LMMS_JOURNALLING_OBJECT_H
 #define LMMS_JOURNALLING_OBJECT_H
 
+#include <cstddef>
+#include <memory>
 #include <QStack>
 
 #include "LmmsTypes.h"
@@ -33,6 +35,29 @@
 namespace lmms
 {
 
+class JournallingObject;
+
+
+//! What the undo journal keeps about an object from a check point on, so that the change following the check point
+//! can be undone and redone
+class JournalEntry
+{
+public:
+	virtual ~JournalEntry() = default;
+
+	//! Called once the change is complete, i.e. when the next check point is added or before the change is undone.
+	//! Entries may use this to reduce what they keep to the difference to the current state of the object.
+	virtual void seal(JournallingObject&) {}
+
+	//! Restore the recorded state of @p object, and record the state it replaces instead, so that restoring
+	//! again reverts this
+	virtual void restore(JournallingObject& object) = 0;
+
+	//! Approximate memory used by the entry in bytes
+	virtual std::size_t memoryUsage() const = 0;
+};
+
+
 class LMMS_EXPORT JournallingObject : public SerializingObject
 {
 public:
@@ -60,6 +85,13 @@ public:
 
 	void addJournalCheckPoint();
 
+	//! Record the current state for the undo journal more compactly than saveState() would, e.g. only the values
+	//! that can change. The default of nullptr makes the journal save the whole state.
+	virtual std::unique_ptr<JournalEntry> createJournalEntry()
+	{
+		return nullptr;
+	}
+
 	QDomElement saveState( QDomDocument & _doc,
 									QDomElement & _parent ) override;
 
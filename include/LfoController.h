@@ -80,15 +80,12 @@ protected:
 	float m_phaseOffset;
 	float m_currentPhase;
 
-	sample_t (*m_sampleFunction)( const float );
-
 private:
 	float m_heldSample;
 	std::shared_ptr<const SampleBuffer> m_userDefSampleBuffer = SampleBuffer::emptyBuffer();
 
 protected slots:
 	void updatePhase();
-	void updateSampleFunction();
 	void updateDuration();
 
 	friend class gui::LfoControllerDialog;
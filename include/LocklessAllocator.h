@@ -28,18 +28,23 @@
 #include <atomic>
 #include <cstddef>
 
+#include "lmms_export.h"
 
 namespace lmms
 {
 
 
-class LocklessAllocator
+class LMMS_EXPORT LocklessAllocator
 {
 public:
-	LocklessAllocator( size_t nmemb, size_t size );
+	LocklessAllocator( size_t nmemb, size_t size, size_t alignment = sizeof( void * ) );
 	virtual ~LocklessAllocator();
 	void * alloc();
+	//! Like alloc(), but returns nullptr without complaining if no space is left
+	void * tryAlloc();
 	void free( void * ptr );
+	//! Whether @p ptr points into the pool of this allocator
+	bool owns( const void * ptr ) const;
 
 
 private:
@@ -63,8 +68,9 @@ class LocklessAllocatorT : private LocklessAllocator
 {
 public:
 	LocklessAllocatorT( size_t nmemb ) :
-		LocklessAllocator( nmemb, sizeof( T ) )
+		LocklessAllocator( nmemb, sizeof( T ), alignof( T ) )
 	{
+		static_assert( alignof( T ) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Pool storage is not aligned enough for T" );
 	}
 
 	~LocklessAllocatorT() override = default;
@@ -74,11 +80,18 @@ public:
 		return (T *)LocklessAllocator::alloc();
 	}
 
+	T * tryAlloc()
+	{
+		return (T *)LocklessAllocator::tryAlloc();
+	}
+
 	void free( T * ptr )
 	{
 		LocklessAllocator::free( ptr );
 	}
 
+	using LocklessAllocator::owns;
+
 } ;
 
 
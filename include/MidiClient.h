@@ -26,6 +26,8 @@
 #define LMMS_MIDI_CLIENT_H
 
 #include <QStringList>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 
 
@@ -63,6 +65,11 @@ public:
 	// re-implemented methods HAVE to call removePort() of base-class!!
 	virtual void removePort( MidiPort * _port );
 
+	//! Deliver the input events that ports queued since the last period. Called by the audio engine at the start of
+	//! each period. Events are played one period late, at the offset at which they arrived during the previous
+	//! period, so that their timing does not depend on when the MIDI thread got to run.
+	void processQueuedInEvents(sample_rate_t sampleRate, fpp_t frames);
+
 
 	// returns whether client works with raw-MIDI, only needs to be
 	// re-implemented by MidiClientRaw for returning true
@@ -113,6 +120,11 @@ public:
 protected:
 	std::vector<MidiPort *> m_midiPorts;
 
+private:
+	//! Guards m_midiPorts against changes while the audio thread delivers queued events
+	std::mutex m_portsMutex;
+	std::int64_t m_lastPeriodStart = 0;
+
 } ;
 
 
@@ -28,6 +28,7 @@
 
 #include "Clip.h"
 #include "Note.h"
+#include "NoteIndex.h"
 
 
 namespace lmms
@@ -75,6 +76,9 @@ public:
 		return m_notes;
 	}
 
+	//! Lookup of the notes by time and key, which is brought up to date after the notes changed
+	const NoteIndex& noteIndex() const;
+
 	Note * addStepNote( int step );
 	void setStep( int step, bool enabled );
 
@@ -107,6 +111,9 @@ public:
 		return "midiclip";
 	}
 
+	//! Journals the notes a change adds and removes instead of all of them
+	std::unique_ptr<JournalEntry> createJournalEntry() override;
+
 	inline InstrumentTrack * instrumentTrack() const
 	{
 		return m_instrumentTrack;
@@ -140,6 +147,8 @@ protected slots:
 
 
 private:
+	class DeltaJournalEntry;
+
 	TimePos beatClipLength() const;
 
 	void setType( Type _new_clip_type );
@@ -155,6 +164,10 @@ private:
 	NoteVector m_notes;
 	int m_steps;
 
+	//! Rebuilt on demand after dataChanged()
+	mutable NoteIndex m_noteIndex;
+	mutable bool m_noteIndexValid = false;
+
 	MidiClip * adjacentMidiClipByOffset(int offset) const;
 
 	friend class gui::MidiClipView;
@@ -150,6 +150,11 @@ public:
 		return m_sourcePort;
 	}
 
+	void setSourcePort(const void* sourcePort)
+	{
+		m_sourcePort = sourcePort;
+	}
+
 	uint8_t controllerNumber() const
 	{
 		return param( 0 ) & 0x7F;
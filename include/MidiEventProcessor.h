@@ -43,6 +43,11 @@ public:
 	virtual void processInEvent( const MidiEvent& event, const TimePos& time = TimePos(), f_cnt_t offset = 0 ) = 0;
 	virtual void processOutEvent( const MidiEvent& event, const TimePos& time = TimePos(), f_cnt_t offset = 0 ) = 0;
 
+	//! Whether events from MIDI devices should be delivered on the audio thread at the start of the next period,
+	//! with the offset within the period at which they arrived, instead of immediately on the thread of the device.
+	//! This gives note timing without jitter at the cost of one period of latency.
+	virtual bool queuesLiveInput() const { return false; }
+
 } ;
 
 } // namespace lmms
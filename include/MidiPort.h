@@ -29,16 +29,19 @@
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <cstdint>
+#include <mutex>
 
 #include "Midi.h"
+#include "MidiEvent.h"
 #include "TimePos.h"
 #include "AutomatableModel.h"
+#include "LocklessRingBuffer.h"
 
 namespace lmms
 {
 
 class MidiClient;
-class MidiEvent;
 class MidiEventProcessor;
 
 namespace gui
@@ -114,6 +117,13 @@ public:
 	void processInEvent( const MidiEvent& event, const TimePos& time = TimePos() );
 	void processOutEvent( const MidiEvent& event, const TimePos& time = TimePos() );
 
+	//! Deliver the input events queued since the last call. Events are placed at the offset at which they arrived
+	//! after @p periodStart, a time as returned by now(). Must be called from the audio thread.
+	void processQueuedInEvents(std::int64_t periodStart, sample_rate_t sampleRate, fpp_t frames);
+
+	//! Time in nanoseconds used for stamping input events
+	static std::int64_t now();
+
 
 	void saveSettings( QDomDocument& doc, QDomElement& thisElement ) override;
 	void loadSettings( const QDomElement& thisElement ) override;
@@ -153,9 +163,25 @@ private slots:
 
 
 private:
+	struct QueuedInEvent
+	{
+		MidiEvent event;
+		TimePos time;
+		std::int64_t timestamp = 0;
+	};
+
+	static constexpr auto InQueueSize = std::size_t{1024};
+
 	MidiClient* m_midiClient;
 	MidiEventProcessor* m_midiEventProcessor;
 
+	//! Input events waiting for the audio thread if the event processor queues live input. Some clients deliver
+	//! events of different devices from different threads, so writers are serialized by m_inQueueWriteMutex; the
+	//! audio thread reads without locking.
+	LocklessRingBuffer<QueuedInEvent> m_inQueue;
+	LocklessRingBufferReader<QueuedInEvent> m_inQueueReader;
+	std::mutex m_inQueueWriteMutex;
+
 	Mode m_mode;
 
 	IntModel m_inputChannelModel;
@@ -44,6 +44,9 @@ void setNaNHandler( bool use );
 
 bool sanitize( SampleFrame* src, int frames );
 
+/*! \brief Sanitize src like sanitize() does and return its peak absolute sample value, in a single pass */
+sample_t sanitizeAndGetPeak(SampleFrame* src, int frames);
+
 /*! \brief Add samples from src to dst */
 void add( SampleFrame* dst, const SampleFrame* src, int frames );
 
@@ -80,6 +83,12 @@ void multiplyAndAddMultiplied( SampleFrame* dst, const SampleFrame* src, float c
 /*! \brief Multiply dst by coeffDst and add samples from srcLeft/srcRight multiplied by coeffSrc */
 void multiplyAndAddMultipliedJoined( SampleFrame* dst, const sample_t* srcLeft, const sample_t* srcRight, float coeffDst, float coeffSrc, int frames );
 
+/*! \brief Copy the left and right channel of src to the separate buffers dstLeft and dstRight */
+void deinterleave(const SampleFrame* src, sample_t* dstLeft, sample_t* dstRight, int frames);
+
+/*! \brief Copy the separate buffers srcLeft and srcRight to the left and right channel of dst */
+void interleave(const sample_t* srcLeft, const sample_t* srcRight, SampleFrame* dst, int frames);
+
 } // namespace MixHelpers
 
 
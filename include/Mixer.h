@@ -78,6 +78,7 @@ class MixerChannel : public ThreadableJob
 		bool isMaster() { return m_channelIndex == 0; }
 
 		bool requiresProcessing() const override { return true; }
+		JobProfiler::SourceId profilerSource() const override { return m_profilerSource.id(); }
 		void unmuteForSolo();
 		void unmuteSenderForSolo();
 		void unmuteReceiverForSolo();
@@ -93,6 +94,7 @@ class MixerChannel : public ThreadableJob
 		void doProcessing() override;
 		int m_channelIndex;
 		std::optional<QColor> m_color;
+		JobProfiler::Source m_profilerSource;
 };
 
 class MixerRoute : public QObject
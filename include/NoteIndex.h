@@ -0,0 +1,59 @@
+/*
+ * NoteIndex.h - Lookup of the notes of a clip by time and key
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef LMMS_NOTE_INDEX_H
+#define LMMS_NOTE_INDEX_H
+
+#include "IntervalIndex.h"
+#include "Note.h"
+
+namespace lmms
+{
+
+//! Finds the notes of a clip that overlap a range of time, or a point in time and a key, without looking at all of
+//! them, so that editors stay responsive with clips of many thousand notes.
+//! The index is a snapshot: it must be rebuilt after notes were added, removed or moved.
+class LMMS_EXPORT NoteIndex
+{
+public:
+	//! Index @p notes, which need not be sorted
+	void rebuild(const NoteVector& notes);
+	void clear();
+
+	//! Notes that are at least partly within the ticks [first, last], ordered by their start. Notes with a
+	//! negative length count as 4 ticks long, as in the piano roll, and detuning curves past the end of a note as
+	//! part of it.
+	NoteVector notesInRange(tick_t first, tick_t last) const;
+
+	//! Notes with a positive length and key @p key that contain @p tick, including their end, ordered by their start
+	NoteVector notesAt(tick_t tick, int key) const;
+
+private:
+	IntervalIndex<Note*> m_index;
+};
+
+} // namespace lmms
+
+#endif // LMMS_NOTE_INDEX_H
@@ -32,6 +32,7 @@
 #include "Note.h"
 #include "PlayHandle.h"
 #include "Track.h"
+#include "VoicePool.h"
 
 class QReadWriteLock;
 
@@ -48,7 +49,7 @@ class LMMS_EXPORT NotePlayHandle : public PlayHandle, public Note
 {
 public:
 	void * m_pluginData;
-	std::unique_ptr<BasicFilters<>> m_filter;
+	VoicePool<BasicFilters<>>::Ptr m_filter;
 
 	// length of the declicking fade in
 	fpp_t m_fadeInLength;
@@ -31,6 +31,7 @@
 #include <memory>
 #include <cstdlib>
 #include <cmath>
+#include <utility>
 
 #include "Engine.h"
 #include "lmms_math.h"
@@ -89,6 +90,12 @@ public:
 		delete m_subOsc;
 	}
 
+	//! Give up ownership of the sub-oscillator, for when its storage is managed elsewhere
+	Oscillator* releaseSubOsc()
+	{
+		return std::exchange(m_subOsc, nullptr);
+	}
+
 	static void waveTableInit();
 	static void destroyFFTPlans();
 	static std::unique_ptr<OscillatorConstants::waveform_t> generateAntiAliasUserWaveTable(const SampleBuffer* sampleBuffer);
@@ -175,53 +182,6 @@ public:
 		return std::lerp(buffer->data()[f1][0], buffer->data()[(f1 + 1) % frames][0], fraction(frame));
 	}
 
-	struct wtSampleControl {
-		float frame;
-		f_cnt_t f1;
-		f_cnt_t f2;
-		int band;
-	};
-
-	inline wtSampleControl getWtSampleControl(const float sample) const
-	{
-		wtSampleControl control;
-		control.frame = absFraction(sample) * OscillatorConstants::WAVETABLE_LENGTH;
-		control.f1 = static_cast<f_cnt_t>(control.frame);
-		control.f2 = control.f1 < OscillatorConstants::WAVETABLE_LENGTH - 1 ?
-					control.f1 + 1 :
-					0;
-		control.band = waveTableBandFromFreq(
-			m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate());
-		return control;
-	}
-
-	inline sample_t wtSample(
-		const sample_t table[OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH],
-		const float sample) const
-	{
-		assert(table != nullptr);
-		wtSampleControl control = getWtSampleControl(sample);
-		return std::lerp(table[control.band][control.f1], table[control.band][control.f2], fraction(control.frame));
-	}
-
-	sample_t wtSample(const OscillatorConstants::waveform_t* table, const float sample) const
-	{
-		assert(table != nullptr);
-		wtSampleControl control = getWtSampleControl(sample);
-		return std::lerp(
-			(*table)[control.band][control.f1],
-			(*table)[control.band][control.f2],
-			fraction(control.frame)
-		);
-	}
-
-	inline sample_t wtSample(sample_t **table, const float sample) const
-	{
-		assert(table != nullptr);
-		wtSampleControl control = getWtSampleControl(sample);
-		return std::lerp(table[control.band][control.f1], table[control.band][control.f2], fraction(control.frame));
-	}
-
 	static inline int waveTableBandFromFreq(float freq)
 	{
 		// Frequency bands are indexed relative to default MIDI key frequencies.
@@ -257,6 +217,13 @@ private:
 	// adding more explicit parameters to all of them. Can be converted to a parameter if needed.
 	bool m_isModulator;
 
+	// The frequency is constant during an update, so these are only computed once per update in recalcPhase()
+	int m_waveTableBand = 1;
+	bool m_sineAboveMaxFreq = false;
+
+	//! Frames rendered at once by renderTable()
+	static constexpr auto RenderBlockSize = fpp_t{64};
+
 	/* Multiband WaveTable */
 	static sample_t s_waveTables[NumWaveShapeTables][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH];
 	static fftwf_plan s_fftPlan;
@@ -313,6 +280,20 @@ private:
 	template<WaveShape W>
 	inline sample_t getSample( const float _sample );
 
+	//! Band-limited wavetable for the current frequency, or nullptr if the samples are to be computed directly
+	template<WaveShape W>
+	inline const sample_t* bandLimitedTable() const;
+
+	static inline sample_t tableSample(const sample_t* table, const float sample);
+
+	//! Interpolate @p frames samples from @p table into @p out, advancing the phase by @p increment per frame
+	void renderTable(const sample_t* table, const float increment, sample_t* out, const fpp_t frames);
+
+	//! Render without modulation of the phase, combining each sample with the buffer using @p combine
+	template<WaveShape W, typename Combine>
+	inline void renderUnmodulated(SampleFrame* ab, const fpp_t frames, const ch_cnt_t chnl, const float increment,
+		Combine combine);
+
 	inline void recalcPhase();
 
 } ;
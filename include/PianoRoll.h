@@ -387,6 +387,8 @@ private:
 	TimePos m_currentPosition;
 	bool m_recording;
 	bool m_doAutoQuantization{false};
+	//! Cached, as paintEvent() is called far too often to read the setting each time
+	bool m_drawNoteNames{false};
 	QList<Note> m_recordingNotes;
 
 	Note * m_currentNote;
@@ -94,6 +94,9 @@ public:
 		return !isFinished();
 	}
 
+	//! Play handles are accounted to the audio bus handle they render into
+	JobProfiler::SourceId profilerSource() const override;
+
 	void lock()
 	{
 		m_processingLock.lock();
@@ -0,0 +1,105 @@
+/*
+ * ProjectContainer.h - Chunked binary storage for projects
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PROJECT_CONTAINER_H
+#define LMMS_PROJECT_CONTAINER_H
+
+#include <QFile>
+#include <QString>
+#include <vector>
+
+#include "lmms_export.h"
+
+class QDomDocument;
+class QIODevice;
+
+namespace lmms
+{
+
+//! A binary alternative to storing projects as (compressed) XML, used for files ending in .mmpb.
+//!
+//! The XML document is split into sections: every track and every clip is stored as a compressed XML fragment of
+//! its own, which are parsed in parallel when loading. Embedded samples are stored as raw data instead of base64.
+//! The file is mapped into memory, and embedded data is only read once the sample is created from it.
+//!
+//! Converting between the XML and the binary format is lossless.
+class LMMS_EXPORT ProjectContainer
+{
+public:
+	//! Open the container in @p fileName, mapping it into memory
+	explicit ProjectContainer(const QString& fileName);
+	~ProjectContainer();
+
+	ProjectContainer(const ProjectContainer&) = delete;
+	ProjectContainer& operator=(const ProjectContainer&) = delete;
+
+	bool isValid() const { return m_data != nullptr; }
+
+	//! Rebuild the XML document stored in the container into @p document. Embedded data is left in the container,
+	//! and the attributes that held it refer to it by blob references, which are valid as long as the container is.
+	bool read(QDomDocument& document, QString* errorMsg) const;
+
+	//! Store @p document in @p device
+	static bool write(const QDomDocument& document, QIODevice& device);
+
+	//! Whether @p device contains a container. Does not change the position in the device.
+	static bool isContainer(QIODevice& device);
+
+	//! Whether an attribute value refers to data embedded in a container rather than holding the data in base64
+	static bool isBlobReference(const QString& value);
+
+	//! The data @p reference refers to, without copying it out of the mapped file, or an empty array if its
+	//! container is gone. The array must not be used after the container is destroyed.
+	static QByteArray blob(const QString& reference);
+
+	//! Replace all blob references in @p document by the data they refer to in base64, as in XML projects
+	static void expandBlobs(QDomDocument& document);
+
+	enum class SectionType : quint32
+	{
+		Document,	//!< The document, with the other sections cut out
+		Element,	//!< A track or clip element, cut out of its parent
+		Blob		//!< Embedded data
+	};
+
+private:
+	struct Section
+	{
+		SectionType type;
+		quint32 flags;
+		quint64 offset;
+		quint64 size;
+	};
+
+	bool parseSection(std::size_t index, QDomDocument& document, QString* errorMsg) const;
+
+	QFile m_file;
+	const quint64 m_serial;
+	uchar* m_data = nullptr;
+	std::vector<Section> m_sections;
+};
+
+} // namespace lmms
+
+#endif // LMMS_PROJECT_CONTAINER_H
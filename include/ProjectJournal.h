@@ -25,28 +25,41 @@
 #ifndef LMMS_PROJECT_JOURNAL_H
 #define LMMS_PROJECT_JOURNAL_H
 
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <QHash>
-#include <QStack>
+#include <QObject>
 
 #include "LmmsTypes.h"
-#include "DataFile.h"
 
 
 namespace lmms
 {
 
 
+class JournalEntry;
 class JournallingObject;
 
 
 //! @warning many parts of this class may be rewritten soon
-class ProjectJournal
+class ProjectJournal : public QObject
 {
+	Q_OBJECT
 public:
 	static const int MAX_UNDO_STATES;
 
+	//! What keeping the journal costs
+	struct Statistics
+	{
+		std::size_t checkPoints = 0; //!< Added since the journal was last cleared
+		std::size_t snapshots = 0; //!< Of those, how many saved the whole state of their object
+		std::chrono::nanoseconds time{0}; //!< Spent adding and sealing them
+		std::size_t memoryUsage = 0; //!< Approximate size of the current undo and redo history in bytes
+	};
+
 	ProjectJournal();
-	virtual ~ProjectJournal() = default;
+	~ProjectJournal() override;
 
 	void undo();
 	void redo();
@@ -89,6 +102,9 @@ public:
 
 	void clearJournal();
 	void stopAllJournalling();
+
+	Statistics statistics() const;
+
 	JournallingObject * journallingObject( const jo_id_t _id )
 	{
 		if( m_joIDs.contains( _id ) )
@@ -99,20 +115,25 @@ public:
 	}
 
 
+signals:
+	//! Emitted with every object that is about to be changed by the user, whether journalling is enabled or not,
+	//! and with every object that was changed by undo or redo
+	void objectChanged(lmms::JournallingObject* object);
+
 private:
 	using JoIdMap = QHash<jo_id_t, JournallingObject*>;
 
 	struct CheckPoint
 	{
-		CheckPoint( jo_id_t initID = 0, const DataFile& initData = DataFile( DataFile::Type::JournalData ) ) :
-			joID( initID ),
-			data( initData )
-		{
-		}
 		jo_id_t joID;
-		DataFile data;
-	} ;
-	using CheckPointStack = QStack<CheckPoint>;
+		std::unique_ptr<JournalEntry> entry;
+		bool sealed = false;
+	};
+	using CheckPointStack = std::deque<CheckPoint>;
+
+	//! Move the most recent check point from @p from to @p to, restoring the state it recorded
+	void restore(CheckPointStack& from, CheckPointStack& to);
+	void seal(CheckPoint& checkPoint, JournallingObject* jo);
 
 	JoIdMap m_joIDs;
 
@@ -121,6 +142,8 @@ private:
 
 	bool m_journalling;
 
+	Statistics m_statistics;
+
 } ;
 
 
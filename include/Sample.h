@@ -52,10 +52,11 @@ public:
 		{
 		}
 
-		auto frameIndex() const -> int { return m_frameIndex; }
+		//! In frames of the sample, even if its copy at the engine sample rate is played
+		auto frameIndex() const -> int { return static_cast<int>(m_frameIndex / m_frameScale); }
 		auto backwards() const -> bool { return m_backwards; }
 
-		void setFrameIndex(int index) { m_frameIndex = index; }
+		void setFrameIndex(int index) { m_frameIndex = static_cast<int>(index * m_frameScale); }
 		void setBackwards(bool backwards) { m_backwards = backwards; }
 
 	private:
@@ -64,6 +65,11 @@ public:
 		std::span<SampleFrame> m_bufferView;
 		int m_frameIndex = 0;
 		bool m_backwards = false;
+		bool m_started = false;
+		//! The copy of the sample at the engine sample rate being played, if any. m_frameIndex counts its frames.
+		const SampleBuffer* m_resampled = nullptr;
+		//! Frames of the buffer being played per frame of the sample
+		double m_frameScale = 1.0;
 		friend class Sample;
 	};
 
@@ -107,7 +113,10 @@ public:
 	void setReversed(bool reversed) { m_reversed.store(reversed, std::memory_order_relaxed); }
 
 private:
-	f_cnt_t render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loop loop) const;
+	//! The buffer @p state plays, which is the copy of the sample at the engine sample rate if there is one and it
+	//! is played at about its original pitch
+	auto selectSource(PlaybackState* state, double pitchRatio) const -> const SampleBuffer&;
+	f_cnt_t render(const SampleBuffer& source, SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loop loop) const;
 	std::shared_ptr<const SampleBuffer> m_buffer = SampleBuffer::emptyBuffer();
 	std::atomic<int> m_startFrame = 0;
 	std::atomic<int> m_endFrame = 0;
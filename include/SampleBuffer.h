@@ -84,13 +84,37 @@ public:
 	static auto emptyBuffer() -> std::shared_ptr<const SampleBuffer>;
 
 	static std::shared_ptr<const SampleBuffer> fromFile(const QString& path);
+
+	//! Start decoding the files at @p paths on the thread pool, so that fromFile() can return them without decoding
+	//! them itself. Used when loading projects, whose samples would otherwise be decoded one after another while
+	//! the tracks are created.
+	static void preload(const std::vector<QString>& paths);
+	//! Forget the preloaded samples, which stay alive as long as they are used
+	static void clearPreloaded();
 	static std::shared_ptr<const SampleBuffer> fromBase64(
 		const QString& str, int sampleRate = Engine::audioEngine()->outputSampleRate());
 
+	//! The copy of the sample at @p sampleRate, or nullptr if there is none (yet). Realtime safe.
+	//!
+	//! If enabled with "audioengine/resamplesamples", the samples loaded from files and projects at another sample
+	//! rate than the one of the audio engine are resampled in the background, so that playing them at their
+	//! original pitch only takes copying the frames.
+	auto resampled(sample_rate_t sampleRate) const -> const SampleBuffer*;
+	//! Make the copies of all samples again for the current sample rate of the audio engine. Called on the main
+	//! thread while the audio engine is stopped.
+	static void updateResampled();
+
 private:
+	struct Resampled;
+
+	//! Have a copy of @p buffer made at the sample rate of the audio engine, if enabled
+	static auto withResampled(std::shared_ptr<SampleBuffer> buffer) -> std::shared_ptr<const SampleBuffer>;
+	static void startResampling(std::shared_ptr<const SampleBuffer> buffer, sample_rate_t sampleRate);
+
 	std::vector<SampleFrame> m_data;
 	QString m_audioFile;
 	sample_rate_t m_sampleRate = Engine::audioEngine()->outputSampleRate();
+	std::shared_ptr<Resampled> m_resampled;
 };
 
 } // namespace lmms
@@ -42,6 +42,14 @@ public:
 		int sampleRate;
 	};
 
+	//! Header information of an audio file, obtained without decoding it.
+	struct AudioInfo
+	{
+		long long frames = 0;
+		int sampleRate = 0;
+		int channels = 0;
+	};
+
 	struct AudioType
 	{
 		std::string name;
@@ -49,6 +57,7 @@ public:
 	};
 
 	static auto decode(const QString& audioFile) -> std::optional<Result>;
+	static auto probe(const QString& audioFile) -> std::optional<AudioInfo>;
 	static auto supportedAudioTypes() -> const std::vector<AudioType>&;
 };
 } // namespace lmms
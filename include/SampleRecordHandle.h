@@ -25,19 +25,14 @@
 #ifndef LMMS_SAMPLE_RECORD_HANDLE_H
 #define LMMS_SAMPLE_RECORD_HANDLE_H
 
-#include <QList>
-#include <QPair>
-#include <memory>
-
 #include "PlayHandle.h"
-#include "TimePos.h"
+#include "SampleRecorder.h"
 
 namespace lmms
 {
 
 
 class PatternTrack;
-class SampleBuffer;
 class SampleClip;
 class Track;
 
@@ -54,17 +49,13 @@ public:
 	bool isFromTrack( const Track * _track ) const override;
 
 	f_cnt_t framesRecorded() const;
-	std::shared_ptr<const SampleBuffer> createSampleBuffer();
 
 
 private:
-	virtual void writeBuffer( const SampleFrame* _ab,
-						const f_cnt_t _frames );
-
-	using bufferList = QList<QPair<SampleFrame*, f_cnt_t>>;
-	bufferList m_buffers;
+	bool m_started;
+	//! nullptr if the recorder was busy with too many other takes
+	SampleRecorder::Take* m_take;
 	f_cnt_t m_framesRecorded;
-	TimePos m_minLength;
 
 	Track * m_track;
 	PatternTrack* m_patternTrack;
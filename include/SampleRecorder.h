@@ -0,0 +1,103 @@
+/*
+ * SampleRecorder.h - Streams recorded audio to disk for sample clips
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SAMPLE_RECORDER_H
+#define LMMS_SAMPLE_RECORDER_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "SampleFrame.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+//! Writes the audio recorded into sample clips to temporary files on a background thread, so that the audio
+//! threads neither allocate nor wait while recording, and memory use does not grow with the length of a take.
+//!
+//! An audio thread starts a take and queues the recorded frames into a lock-free ring buffer, which the background
+//! thread empties into the file. Once the take is finished, the background thread reads the file back and hands
+//! the result to the clip on the main thread.
+class LMMS_EXPORT SampleRecorder
+{
+public:
+	//! Takes that can be recorded at the same time
+	static constexpr auto MaxTakes = std::size_t{8};
+	//! Frames queued for each take until the background thread writes them
+	static constexpr auto QueueFrames = std::size_t{32768};
+	//! Frames summarized by each peak of the overview shown while recording
+	static constexpr auto PeakFrames = f_cnt_t{256};
+
+	//! Lowest and highest sample of both channels
+	struct Peak
+	{
+		float min = 0.f;
+		float max = 0.f;
+	};
+
+	class Take;
+
+	SampleRecorder();
+	~SampleRecorder();
+
+	//! Start recording into the clip with the ID @p clipId, dropping the first @p skipFrames frames. Returns nullptr
+	//! if too many takes are being recorded already. Realtime safe.
+	Take* start(jo_id_t clipId, f_cnt_t skipFrames);
+	//! Append @p count recorded frames to @p take. Frames that don't fit into the queue are dropped. Realtime safe.
+	void write(Take* take, const SampleFrame* frames, f_cnt_t count);
+	//! Stop recording @p take. The recording is given to its clip once it is saved. Realtime safe.
+	void finish(Take* take);
+
+	//! Whether a take is being recorded or saved for the clip with the ID @p clipId
+	bool isRecording(jo_id_t clipId) const;
+	//! The overview of what was recorded into the clip with the ID @p clipId so far, with one peak per
+	//! @p framesPerPeak frames, rounded to a multiple of PeakFrames
+	std::vector<Peak> peaks(jo_id_t clipId, f_cnt_t framesPerPeak) const;
+
+private:
+	void run();
+	void open(Take& take);
+	void drain(Take& take);
+	void save(Take& take);
+
+	std::vector<std::unique_ptr<Take>> m_takes;
+
+	//! Buffers of the background thread
+	std::vector<float> m_writeBuffer;
+	std::vector<Peak> m_newPeaks;
+
+	std::thread m_thread;
+	std::mutex m_quitMutex;
+	std::condition_variable m_quitCond;
+	bool m_quit = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_SAMPLE_RECORDER_H
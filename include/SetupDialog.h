@@ -104,6 +104,8 @@ private slots:
 	void updateBufferSizeWarning(int value);
 	void setBufferSize(int value);
 	void resetBufferSize();
+	void toggleMatchDevicePeriod(bool enabled);
+	void toggleResampleSamples(bool enabled);
 
 	// MIDI settings widget.
 	void midiInterfaceChanged(const QString & driver);
@@ -184,6 +186,8 @@ private:
 	QSlider * m_bufferSizeSlider;
 	QLabel * m_bufferSizeLbl;
 	QLabel * m_bufferSizeWarnLbl;
+	bool m_matchDevicePeriod;
+	bool m_resampleSamples;
 	int m_sampleRate;
 	QSlider* m_sampleRateSlider;
 
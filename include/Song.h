@@ -172,6 +172,11 @@ public:
 		m_exportLoop = exportLoop;
 	}
 
+	inline bool exportLoop() const
+	{
+		return m_exportLoop;
+	}
+
 	inline bool isRecording() const
 	{
 		return m_recording;
@@ -199,11 +204,22 @@ public:
 		m_renderBetweenMarkers = renderBetweenMarkers;
 	}
 
+	inline bool renderBetweenMarkers() const
+	{
+		return m_renderBetweenMarkers;
+	}
+
 	inline PlayMode playMode() const
 	{
 		return m_playMode;
 	}
 
+	//! The position of the first frame of the current period in ticks, including the fraction of a tick
+	double periodStartPosition() const
+	{
+		return m_periodStartPosition;
+	}
+
 	const TimePos& getPlayPos(PlayMode pm) const
 	{
 		return getTimeline(pm).pos();
@@ -443,6 +459,7 @@ private:
 	bool m_loopMidiClip;
 
 	VstSyncController m_vstSyncController;
+	double m_periodStartPosition = 0.;
     
 	int m_loopRenderCount;
 	int m_loopRenderRemaining;
@@ -0,0 +1,155 @@
+/*
+ * ThreadRings.h - Per-thread lock-free ring buffers drained by a background thread
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_THREAD_RINGS_H
+#define LMMS_THREAD_RINGS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LocklessRingBuffer.h"
+
+namespace lmms
+{
+
+//! Lock-free ring buffers of @p T, one for each thread writing into them, which a background thread drains at a fixed
+//! interval. This lets the profilers of the audio engine record from realtime threads without locking.
+//!
+//! Every buffer carries a @p Data object for whoever drains it. As the buffer of each thread is found through a
+//! thread-local pointer, there must only be one instance for each set of template arguments.
+template<typename T, typename Data = std::nullptr_t>
+class ThreadRings
+{
+public:
+	struct Buffer
+	{
+		Buffer(std::size_t capacity, int id)
+			: ring(capacity)
+			, reader(ring)
+			, id(id)
+		{
+		}
+
+		LocklessRingBuffer<T> ring;
+		LocklessRingBufferReader<T> reader;
+		const int id; //!< Numbers the threads from 1 on, in the order they first wrote
+		Data data{};  //!< Guarded by the lock of forEach(), unless it synchronizes itself
+	};
+
+	explicit ThreadRings(std::size_t capacity)
+		: m_capacity(capacity)
+	{
+	}
+
+	~ThreadRings()
+	{
+		stopDraining();
+	}
+
+	ThreadRings(const ThreadRings&) = delete;
+	ThreadRings& operator=(const ThreadRings&) = delete;
+
+	std::size_t capacity() const { return m_capacity; }
+
+	//! The buffer of the calling thread. Realtime safe, except for the first call on each thread, which allocates it.
+	auto local() -> Buffer*
+	{
+		auto& buffer = current();
+		if (buffer) { return buffer; }
+
+		const auto lock = std::lock_guard{m_mutex};
+		m_buffers.push_back(std::make_unique<Buffer>(m_capacity, static_cast<int>(m_buffers.size()) + 1));
+		buffer = m_buffers.back().get();
+		return buffer;
+	}
+
+	//! The buffer of the calling thread, or nullptr if it never called local()
+	static auto existing() -> Buffer*
+	{
+		return current();
+	}
+
+	//! Call @p func with each buffer, while no new ones can be added
+	template<typename Func>
+	void forEach(Func&& func)
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		for (auto& buffer : m_buffers)
+		{
+			func(*buffer);
+		}
+	}
+
+	//! Call @p drain every @p interval on a background thread, until stopDraining() is called
+	void startDraining(std::chrono::milliseconds interval, std::function<void()> drain)
+	{
+		m_quit = false;
+		m_drainer = std::thread{[this, interval, drain = std::move(drain)] {
+			auto lock = std::unique_lock{m_drainerMutex};
+			while (!m_drainerCond.wait_for(lock, interval, [this] { return m_quit; }))
+			{
+				drain();
+			}
+		}};
+	}
+
+	void stopDraining()
+	{
+		if (!m_drainer.joinable()) { return; }
+
+		{
+			const auto lock = std::lock_guard{m_drainerMutex};
+			m_quit = true;
+		}
+		m_drainerCond.notify_one();
+		m_drainer.join();
+	}
+
+private:
+	static auto current() -> Buffer*&
+	{
+		thread_local auto t_buffer = static_cast<Buffer*>(nullptr);
+		return t_buffer;
+	}
+
+	const std::size_t m_capacity;
+
+	std::mutex m_mutex; //!< Guards m_buffers
+	std::vector<std::unique_ptr<Buffer>> m_buffers;
+
+	std::thread m_drainer;
+	std::mutex m_drainerMutex;
+	std::condition_variable m_drainerCond;
+	bool m_quit = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_THREAD_RINGS_H
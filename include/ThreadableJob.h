@@ -25,7 +25,9 @@
 #ifndef LMMS_THREADABLE_JOB_H
 #define LMMS_THREADABLE_JOB_H
 
+#include "JobProfiler.h"
 #include "LmmsTypes.h"
+#include "TraceRecorder.h"
 
 #include <atomic>
 
@@ -74,6 +76,9 @@ public:
 		auto expected = ProcessingState::Queued;
 		if (m_state.compare_exchange_strong(expected, ProcessingState::InProgress))
 		{
+			const auto source = profilerSource();
+			const auto probe = JobProfiler::Probe{source};
+			const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Job, "Job", source};
 			doProcessing();
 			m_state = ProcessingState::Done;
 		}
@@ -81,6 +86,12 @@ public:
 
 	virtual bool requiresProcessing() const = 0;
 
+	//! The source that the processing time of this job is accounted to
+	virtual JobProfiler::SourceId profilerSource() const
+	{
+		return JobProfiler::NoSource;
+	}
+
 
 protected:
 	virtual void doProcessing() = 0;
@@ -0,0 +1,162 @@
+/*
+ * TraceRecorder.h - Timeline recording of the audio engine in Chrome trace format
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_TRACE_RECORDER_H
+#define LMMS_TRACE_RECORDER_H
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "JobProfiler.h"
+#include "ThreadRings.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+//! Records a timeline of what each thread of the audio engine did and when, so that scheduling gaps and imbalance
+//! between the worker threads can be inspected. The timeline is written in the Chrome trace event format, which can
+//! be opened with Perfetto (https://ui.perfetto.dev) or chrome://tracing. The phases of loading a project are
+//! recorded as well, so that load times can be compared between versions, and so are undo check points.
+//!
+//! Events go through ThreadRings into memory. Recording is disabled by default, in which case events are not even
+//! timed.
+class LMMS_EXPORT TraceRecorder
+{
+public:
+	enum class Category
+	{
+		Engine,		  //!< Periods and render stages of the audio engine
+		Job,		  //!< Jobs processed by the worker threads, i.e. play handles, audio bus handles, mixer channels
+		Effect,
+		RemotePlugin, //!< Waiting for a remote plugin process to finish processing
+		XRun,
+		Load,		  //!< Phases of loading a project
+		Journal,	  //!< Adding and restoring undo check points
+	};
+
+	//! Records the time until it goes out of scope as a single event, if recording is enabled
+	class Scope
+	{
+	public:
+		//! @p name must be a string literal, or otherwise outlive the recording.
+		//! If @p source is given, its name as known to JobProfiler is used instead of @p name when writing the trace.
+		Scope(Category category, const char* name, JobProfiler::SourceId source = JobProfiler::NoSource)
+			: m_name(instance().isEnabled() ? name : nullptr)
+			, m_category(category)
+			, m_source(source)
+		{
+			if (m_name) { m_start = now(); }
+		}
+
+		~Scope()
+		{
+			if (m_name) { instance().record(m_category, m_name, m_source, m_start, now() - m_start); }
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* const m_name;
+		const Category m_category;
+		const JobProfiler::SourceId m_source;
+		std::int64_t m_start = 0;
+	};
+
+	~TraceRecorder();
+
+	static auto instance() -> TraceRecorder&;
+
+	//! Enabling discards the events of any previous recording
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+	//! Record an event without duration, such as an xrun
+	void instant(Category category, const char* name)
+	{
+		if (isEnabled()) { record(category, name, JobProfiler::NoSource, now(), -1); }
+	}
+
+	//! Name the calling thread in the trace. @p name must be a string literal.
+	static void setThreadName(const char* name);
+
+	//! Write the recorded events to @p fileName. Must be called from the main thread after recording was disabled.
+	bool writeTrace(const QString& fileName);
+
+	//! Current time in nanoseconds, as used for events
+	static auto now() -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+private:
+	struct Event
+	{
+		const char* name;
+		JobProfiler::SourceId source;
+		Category category;
+		std::int64_t start;	   //!< In nanoseconds
+		std::int64_t duration; //!< In nanoseconds, or -1 for instant events
+	};
+
+	struct ThreadData
+	{
+		std::atomic<const char*> name = nullptr;
+		std::vector<Event> events;
+	};
+
+	using Rings = ThreadRings<Event, ThreadData>;
+
+	TraceRecorder() = default;
+
+	//! Realtime safe like ThreadRings::local()
+	void record(Category category, const char* name, JobProfiler::SourceId source, std::int64_t start,
+		std::int64_t duration);
+
+	auto threadBuffer() -> Rings::Buffer*;
+	void collect();
+
+	static auto categoryName(Category category) -> const char*;
+
+	//! Collected events beyond this are dropped, to bound the memory used by long recordings
+	static constexpr auto MaxEvents = std::size_t{1} << 22;
+
+	std::atomic<bool> m_enabled = false;
+	std::atomic<std::size_t> m_overflowCount = 0; //!< Events dropped because a thread buffer was full
+	std::int64_t m_startTime = 0;
+
+	Rings m_events{65536};
+	//! Only changed by collect() and while not recording
+	std::size_t m_eventCount = 0;
+	std::size_t m_droppedCount = 0; //!< Events dropped because MaxEvents was reached
+};
+
+} // namespace lmms
+
+#endif // LMMS_TRACE_RECORDER_H
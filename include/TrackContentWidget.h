@@ -27,6 +27,7 @@
 
 #include <QWidget>
 
+#include "IntervalIndex.h"
 #include "JournallingObject.h"
 #include "TimePos.h"
 
@@ -36,6 +37,7 @@ class QMimeData;  // IWYU pragma: keep
 namespace lmms
 {
 
+class Clip;
 class Track;
 
 namespace gui
@@ -67,6 +69,12 @@ public:
 	TrackContentWidget( TrackView * parent );
 	~TrackContentWidget() override = default;
 
+	//! Show @p clip in this track. The song editor only creates views for the clips that are visible, selected or
+	//! being edited, so that the number of clips off screen does not slow it down.
+	void addClip(Clip* clip);
+	//! Create views for the clips that are at least partly within [first, last], e.g. to select them
+	void createClipViews(const TimePos& first, const TimePos& last);
+
 	void addClipView( ClipView * clipv );
 	void removeClipView( ClipView * clipv );
 	void removeClipView( int clipNum )
@@ -156,11 +164,23 @@ private:
 	Track * getTrack();
 	TimePos getPosition( int mouseX );
 
+	bool virtualizesClips() const;
+	void createClipView(Clip* clip);
+	bool hasClipView(const Clip* clip) const;
+	void positionClipView(ClipView* clipView, int begin, int end, float ppb);
+	void clipChanged(const Clip* clip);
+	const IntervalIndex<Clip*>& clipIndex();
+
 	TrackView * m_trackView;
 
 	using clipViewVector = QVector<ClipView*>;
 	clipViewVector m_clipViews;
 
+	//! All clips of the track by time, including those without a view
+	IntervalIndex<Clip*> m_clipIndex;
+	bool m_clipIndexValid = false;
+	bool m_changingPosition = false;
+
 	QPixmap m_background;
 
 	// qproperty fields
@@ -0,0 +1,94 @@
+/*
+ * TrackFreezer.h - Offline rendering of tracks for freezing
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_TRACK_FREEZER_H
+#define LMMS_TRACK_FREEZER_H
+
+#include <QPointer>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class AudioDevice;
+class FrozenAudio;
+class InstrumentTrack;
+class JournallingObject;
+class Track;
+
+//! Renders the whole song with everything but one instrument track muted, as fast as possible and without any
+//! audio output, while capturing the output of the track's effect chain into FrozenAudio. Once done, the track is
+//! frozen with it.
+//!
+//! Like ProjectRenderer, this replaces the audio device and runs the audio engine on its own thread, so the song
+//! can not be played while freezing.
+class LMMS_EXPORT TrackFreezer : public QThread
+{
+	Q_OBJECT
+public:
+	explicit TrackFreezer(InstrumentTrack* track);
+	~TrackFreezer() override;
+
+public slots:
+	void startProcessing();
+	void abortProcessing();
+
+signals:
+	void progressChanged(int progress);
+
+private slots:
+	void finishProcessing();
+	void checkChange(lmms::JournallingObject* object);
+
+private:
+	void run() override;
+
+	QPointer<InstrumentTrack> m_track;
+	std::unique_ptr<FrozenAudio> m_audio;
+	AudioDevice* m_device = nullptr;
+
+	//! Tracks muted for rendering, and whether the frozen track itself was muted
+	std::vector<QPointer<Track>> m_mutedTracks;
+	bool m_trackWasMuted = false;
+
+	//! Export settings of the song, overridden for rendering
+	bool m_renderBetweenMarkers = false;
+	bool m_exportLoop = false;
+	int m_loopRenderCount = 1;
+
+	bool m_processing = false;
+	int m_progress = 0;
+	std::atomic<bool> m_abort = false;
+	//! Set if anything the frozen audio depends on changed while rendering
+	std::atomic<bool> m_outdated = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_TRACK_FREEZER_H
@@ -0,0 +1,103 @@
+/*
+ * VoicePool.h - Preallocated per-note state of instruments
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_VOICE_POOL_H
+#define LMMS_VOICE_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "LocklessAllocator.h"
+
+namespace lmms
+{
+
+//! Storage for the per-note state of an instrument, e.g. what it keeps in NotePlayHandle::m_pluginData, which is
+//! allocated up front so that starting a note on the audio threads does not hit the heap. Acquiring and releasing
+//! voices is lock-free and may happen from any thread.
+//!
+//! Voices beyond the capacity are allocated on the heap instead of cutting off notes.
+template<typename T>
+class VoicePool
+{
+public:
+	static constexpr auto DefaultCapacity = std::size_t{64};
+
+	//! Releases voices back into the pool, for use with std::unique_ptr
+	class Deleter
+	{
+	public:
+		Deleter(VoicePool* pool = nullptr) : m_pool(pool) {}
+
+		void operator()(T* voice) const { m_pool->release(voice); }
+
+	private:
+		VoicePool* m_pool;
+	};
+
+	using Ptr = std::unique_ptr<T, Deleter>;
+
+	explicit VoicePool(std::size_t capacity = DefaultCapacity)
+		: m_allocator(capacity)
+	{
+	}
+
+	VoicePool(const VoicePool&) = delete;
+	VoicePool& operator=(const VoicePool&) = delete;
+
+	template<typename... Args>
+	T* acquire(Args&&... args)
+	{
+		if (const auto storage = m_allocator.tryAlloc()) { return new (storage) T(std::forward<Args>(args)...); }
+		return new T(std::forward<Args>(args)...);
+	}
+
+	template<typename... Args>
+	Ptr make(Args&&... args)
+	{
+		return Ptr{acquire(std::forward<Args>(args)...), Deleter{this}};
+	}
+
+	//! @p voice must have been acquired from this pool, or be nullptr
+	void release(T* voice)
+	{
+		if (!voice) { return; }
+
+		if (m_allocator.owns(voice))
+		{
+			voice->~T();
+			m_allocator.free(voice);
+		}
+		else { delete voice; }
+	}
+
+private:
+	LocklessAllocatorT<T> m_allocator;
+};
+
+} // namespace lmms
+
+#endif // LMMS_VOICE_POOL_H
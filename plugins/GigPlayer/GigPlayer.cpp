@@ -30,6 +30,7 @@
 
 #include "GigPlayer.h"
 
+#include <algorithm>
 #include <cstring>
 #include <QDebug>
 #include <QLayout>
@@ -38,7 +39,6 @@
 
 #include "AudioEngine.h"
 #include "ConfigManager.h"
-#include "endian_handling.h"
 #include "Engine.h"
 #include "FileDialog.h"
 #include "InstrumentTrack.h"
@@ -186,6 +186,9 @@ void GigInstrument::freeInstance()
 
 	if( m_instance != nullptr )
 	{
+		m_streamer.stopAll();
+		m_heads.clear();
+
 		delete m_instance;
 		m_instance = nullptr;
 
@@ -379,6 +382,7 @@ void GigInstrument::play( SampleFrame* _working_buffer )
 				( it->isRelease == true &&
 				  sample->pos >= sample->sample->SamplesTotal - 1 ) )
 			{
+				m_streamer.stop( sample->voice );
 				sample = it->samples.erase( sample );
 
 				if( sample == it->samples.end() )
@@ -391,6 +395,7 @@ void GigInstrument::play( SampleFrame* _working_buffer )
 		// Delete ended notes (either in the completed state or all the samples ended)
 		if( it->state == GigState::Completed || it->samples.empty() )
 		{
+			stopSamples( *it );
 			it = m_notes.erase( it );
 
 			if( it == m_notes.end() )
@@ -440,11 +445,12 @@ void GigInstrument::play( SampleFrame* _working_buffer )
 			{
 				if (sample.m_sourceBufferView.empty())
 				{
-					loadSample(sample, sample.m_sourceBuffer.data(), sample.m_sourceBuffer.size());
+					sample.voice.read(sample.m_sourceBuffer.data(), sample.m_sourceBuffer.size());
 
+					const float amplitude = sample.attenuation * copy.value();
 					for (auto& frame : sample.m_sourceBuffer)
 					{
-						frame *= copy.value();
+						frame *= amplitude;
 					}
 
 					sample.pos += sample.m_sourceBuffer.size();
@@ -491,169 +497,12 @@ void GigInstrument::play( SampleFrame* _working_buffer )
 
 
 
-void GigInstrument::loadSample( GigSample& sample, SampleFrame* sampleData, f_cnt_t samples )
-{
-	if( sampleData == nullptr || samples < 1 )
-	{
-		return;
-	}
-
-	// Determine if we need to loop part of this sample
-	bool loop = false;
-	gig::loop_type_t loopType = gig::loop_type_normal;
-	f_cnt_t loopStart = 0;
-	f_cnt_t loopLength = 0;
-
-	if( sample.region->pSampleLoops != nullptr )
-	{
-		for( uint32_t i = 0; i < sample.region->SampleLoops; ++i )
-		{
-			loop = true;
-			loopType = static_cast<gig::loop_type_t>( sample.region->pSampleLoops[i].LoopType );
-			loopStart = sample.region->pSampleLoops[i].LoopStart;
-			loopLength = sample.region->pSampleLoops[i].LoopLength;
-
-			// Currently only support at max one loop
-			break;
-		}
-	}
-
-	unsigned long allocationsize = samples * sample.sample->FrameSize;
-	int8_t buffer[allocationsize];
-
-	// Load the sample in different ways depending on if we're looping or not
-	if( loop == true && ( sample.pos >= loopStart || sample.pos + samples > loopStart ) )
-	{
-		// Calculate the new position based on the type of loop
-		if( loopType == gig::loop_type_bidirectional )
-		{
-			sample.pos = getPingPongIndex( sample.pos, loopStart, loopStart + loopLength );
-		}
-		else
-		{
-			sample.pos = getLoopedIndex( sample.pos, loopStart, loopStart + loopLength );
-			// TODO: also implement loop_type_backward support
-		}
-
-		sample.sample->SetPos( sample.pos );
-
-		// Load the samples (based on gig::Sample::ReadAndLoop) even around the end
-		// of a loop boundary wrapping to the beginning of the loop region
-		long samplestoread = samples;
-		long samplestoloopend = 0;
-		long readsamples = 0;
-		long totalreadsamples = 0;
-		long loopEnd = loopStart + loopLength;
-
-		do
-		{
-			samplestoloopend = loopEnd - sample.sample->GetPos();
-			readsamples = sample.sample->Read( &buffer[totalreadsamples * sample.sample->FrameSize],
-					std::min( samplestoread, samplestoloopend ) );
-			samplestoread -= readsamples;
-			totalreadsamples += readsamples;
-
-			if( readsamples >= samplestoloopend )
-			{
-				sample.sample->SetPos( loopStart );
-			}
-		}
-		while( samplestoread > 0 && readsamples > 0 );
-	}
-	else
-	{
-		sample.sample->SetPos( sample.pos );
-
-		unsigned long size = sample.sample->Read( &buffer, samples ) * sample.sample->FrameSize;
-		std::memset( (int8_t*) &buffer + size, 0, allocationsize - size );
-	}
-
-	// Convert from 16 or 24 bit into 32-bit float
-	if( sample.sample->BitDepth == 24 ) // 24 bit
-	{
-		auto pInt = reinterpret_cast<uint8_t*>(&buffer);
-
-		for( f_cnt_t i = 0; i < samples; ++i )
-		{
-			// libgig gives 24-bit data as little endian, so we must
-			// convert if on a big endian system
-			int32_t valueLeft = swap32IfBE(
-						( pInt[ 3 * sample.sample->Channels * i ] << 8 ) |
-						( pInt[ 3 * sample.sample->Channels * i + 1 ] << 16 ) |
-						( pInt[ 3 * sample.sample->Channels * i + 2 ] << 24 ) );
-
-			// Store the notes to this buffer before saving to output
-			// so we can fade them out as needed
-			sampleData[i][0] = 1.0 / 0x100000000 * sample.attenuation * valueLeft;
-
-			if( sample.sample->Channels == 1 )
-			{
-				sampleData[i][1] = sampleData[i][0];
-			}
-			else
-			{
-				int32_t valueRight = swap32IfBE(
-							( pInt[ 3 * sample.sample->Channels * i + 3 ] << 8 ) |
-							( pInt[ 3 * sample.sample->Channels * i + 4 ] << 16 ) |
-							( pInt[ 3 * sample.sample->Channels * i + 5 ] << 24 ) );
-
-				sampleData[i][1] = 1.0 / 0x100000000 * sample.attenuation * valueRight;
-			}
-		}
-	}
-	else // 16 bit
-	{
-		auto pInt = reinterpret_cast<int16_t*>(&buffer);
-
-		for( f_cnt_t i = 0; i < samples; ++i )
-		{
-			sampleData[i][0] = 1.0 / 0x10000 *
-				pInt[ sample.sample->Channels * i ] * sample.attenuation;
-
-			if( sample.sample->Channels == 1 )
-			{
-				sampleData[i][1] = sampleData[i][0];
-			}
-			else
-			{
-				sampleData[i][1] = 1.0 / 0x10000 *
-					pInt[ sample.sample->Channels * i + 1 ] * sample.attenuation;
-			}
-		}
-	}
-}
-
-
-
-
-// These two loop index functions taken from SampleBuffer.cpp
-f_cnt_t GigInstrument::getLoopedIndex( f_cnt_t index, f_cnt_t startf, f_cnt_t endf ) const
+void GigInstrument::stopSamples( GigNote & gignote )
 {
-	if( index < endf )
+	for (auto& sample : gignote.samples)
 	{
-		return index;
+		m_streamer.stop(sample.voice);
 	}
-
-	return startf + ( index - startf )
-				% ( endf - startf );
-}
-
-
-
-
-f_cnt_t GigInstrument::getPingPongIndex( f_cnt_t index, f_cnt_t startf, f_cnt_t endf ) const
-{
-	if( index < endf )
-	{
-		return index;
-	}
-
-	const f_cnt_t looplen = endf - startf;
-	const f_cnt_t looppos = ( index - endf ) % ( looplen * 2 );
-
-	return ( looppos < looplen )
-		? endf - looppos
-		: startf + ( looppos - looplen );
 }
 
 
@@ -752,7 +601,13 @@ void GigInstrument::addSamples( GigNote & gignote, bool wantReleaseSample )
 					attenuation *= pDimRegion->SampleAttenuation;
 				}
 
-				gignote.samples.emplace_back(pSample, pDimRegion, attenuation, AudioResampler::Mode::Linear, gignote.frequency);
+				const auto head = m_heads.find(pSample);
+				gignote.samples.emplace_back(pSample, pDimRegion, head != m_heads.end() ? head->second.get() : nullptr,
+					attenuation, AudioResampler::Mode::Linear, gignote.frequency);
+
+				// Start reading past the head right away, so the stream is ready
+				// by the time the head has been played
+				m_streamer.start(gignote.samples.back().voice);
 			}
 		}
 
@@ -871,6 +726,58 @@ void GigInstrument::getInstrument()
 
 		m_instrument = pInstrument;
 	}
+
+	locker.unlock();
+	loadHeads();
+}
+
+
+
+
+// Read the start of all samples of the instrument into memory, so notes can
+// start without waiting for the disk
+void GigInstrument::loadHeads()
+{
+	std::vector<gig::Sample*> samples;
+
+	{
+		QMutexLocker locker( &m_synthMutex );
+
+		if( m_instrument == nullptr )
+		{
+			return;
+		}
+
+		for( gig::Region* pRegion = m_instrument->GetFirstRegion(); pRegion != nullptr;
+				pRegion = m_instrument->GetNextRegion() )
+		{
+			for( uint32_t i = 0; i < pRegion->DimensionRegions; ++i )
+			{
+				gig::Sample * pSample = pRegion->pDimensionRegions[i]->pSample;
+
+				if( pSample != nullptr && pSample->SamplesTotal != 0 &&
+						m_heads.find( pSample ) == m_heads.end() &&
+						std::find( samples.begin(), samples.end(), pSample ) == samples.end() )
+				{
+					samples.push_back( pSample );
+				}
+			}
+		}
+	}
+
+	// Only the main thread changes the file and m_heads, so the reading can
+	// happen without blocking play()
+	std::vector<std::pair<gig::Sample*, std::unique_ptr<GigSampleHead>>> heads;
+	for( gig::Sample* pSample : samples )
+	{
+		heads.emplace_back( pSample, m_streamer.loadHead( pSample ) );
+	}
+
+	QMutexLocker locker( &m_synthMutex );
+	for( auto& head : heads )
+	{
+		m_heads.emplace( head.first, std::move( head.second ) );
+	}
 }
 
 
@@ -882,6 +789,12 @@ void GigInstrument::getInstrument()
 void GigInstrument::updateSampleRate()
 {
 	QMutexLocker locker( &m_notesMutex );
+
+	for( GigNote & note : m_notes )
+	{
+		stopSamples( note );
+	}
+
 	m_notes.clear();
 }
 
@@ -1074,12 +987,13 @@ void GigInstrumentView::showPatchDialog()
 
 
 // Store information related to playing a sample from the GIG file
-GigSample::GigSample(gig::Sample* pSample, gig::DimensionRegion* pDimRegion, float attenuation,
-	AudioResampler::Mode interpolation, float desiredFreq)
+GigSample::GigSample(gig::Sample* pSample, gig::DimensionRegion* pDimRegion, const GigSampleHead* head,
+	float attenuation, AudioResampler::Mode interpolation, float desiredFreq)
 	: sample(pSample)
 	, region(pDimRegion)
 	, attenuation(attenuation)
 	, pos(0)
+	, voice(pSample, pDimRegion, head)
 	, m_resampler(interpolation)
 	, sampleFreq(0)
 	, freqFactor(1)
@@ -1108,6 +1022,7 @@ GigSample::GigSample(const GigSample& g)
 	, attenuation(g.attenuation)
 	, adsr(g.adsr)
 	, pos(g.pos)
+	, voice(g.voice)
 	, m_resampler(AudioResampler::Mode::Linear, DEFAULT_CHANNELS)
 	, sampleFreq(g.sampleFreq)
 	, freqFactor(g.freqFactor)
@@ -1124,6 +1039,7 @@ GigSample& GigSample::operator=( const GigSample& g )
 	attenuation = g.attenuation;
 	adsr = g.adsr;
 	pos = g.pos;
+	voice = g.voice;
 	sampleFreq = g.sampleFreq;
 	freqFactor = g.freqFactor;
 	return *this;
@@ -30,7 +30,9 @@
 #include <QList>
 #include <QMutex>
 #include <QMutexLocker>
+#include <memory>
 #include <samplerate.h>
+#include <unordered_map>
 
 #include "AudioEngine.h"
 #include "AudioResampler.h"
@@ -41,6 +43,7 @@
 #include "LcdSpinBox.h"
 #include "SampleFrame.h"
 #include "gig.h"
+#include "GigStreamer.h"
 
 
 class QLabel;
@@ -149,7 +152,7 @@ public:
 class GigSample
 {
 public:
-	GigSample(gig::Sample* pSample, gig::DimensionRegion* pDimRegion, float attenuation,
+	GigSample(gig::Sample* pSample, gig::DimensionRegion* pDimRegion, const GigSampleHead* head, float attenuation,
 		AudioResampler::Mode interpolation, float desiredFreq);
 	~GigSample() = default;
 
@@ -165,6 +168,9 @@ public:
 	// The position in sample
 	f_cnt_t pos;
 
+	// Where the sample data comes from, the preloaded head or the disk stream
+	GigStreamer::Voice voice;
+
 	// Whether to change the pitch of the samples, e.g. if there's only one
 	// sample per octave and you want that sample pitch shifted for the rest of
 	// the notes in the octave, this will be true
@@ -293,6 +299,13 @@ private:
 	// List of all the currently playing notes
 	QList<GigNote> m_notes;
 
+	// Reads the sample data, so that play() never touches the file
+	GigStreamer m_streamer;
+
+	// Preloaded heads of the samples of the instruments used so far, guarded by
+	// m_synthMutex
+	std::unordered_map<gig::Sample*, std::unique_ptr<GigSampleHead>> m_heads;
+
 	// Used when determining which samples to use
 	uint32_t m_RandomSeed;
 	float m_currentKeyDimension;
@@ -308,10 +321,11 @@ private:
 	// parameters such as velocity
 	Dimension getDimensions( gig::Region * pRegion, int velocity, bool release );
 
-	// Load sample data from the Gig file, looping the sample where needed
-	void loadSample( GigSample& sample, SampleFrame* sampleData, f_cnt_t samples );
-	f_cnt_t getLoopedIndex( f_cnt_t index, f_cnt_t startf, f_cnt_t endf ) const;
-	f_cnt_t getPingPongIndex( f_cnt_t index, f_cnt_t startf, f_cnt_t endf ) const;
+	// Preload the heads of all samples of the current instrument
+	void loadHeads();
+
+	// Stop streaming the samples of a note before removing it
+	void stopSamples( GigNote & gignote );
 
 	// Add the desired samples to the note, either normal samples or release
 	// samples
@@ -0,0 +1,422 @@
+/*
+ * GigStreamer.cpp - Disk streaming of samples from GIG files
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "GigStreamer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "LocklessRingBuffer.h"
+#include "endian_handling.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+//! How often the background thread tops up the streams
+constexpr auto PollInterval = std::chrono::milliseconds{4};
+
+//! Frames read from the file at once
+constexpr auto ChunkFrames = f_cnt_t{1024};
+
+//! Convert @p frames frames of 16 or 24 bit PCM as read by libgig to float, duplicating mono to both channels
+void convertToFloat(const std::int8_t* src, const gig::Sample* sample, SampleFrame* dst, f_cnt_t frames)
+{
+	const auto channels = sample->Channels;
+	auto i = f_cnt_t{0};
+
+	if (sample->BitDepth == 24)
+	{
+		const auto pInt = reinterpret_cast<const std::uint8_t*>(src);
+		const auto value = [pInt](f_cnt_t index) {
+			// libgig gives 24-bit data as little endian, so we must convert if on a big endian system
+			return swap32IfBE((pInt[3 * index] << 8) | (pInt[3 * index + 1] << 16) | (pInt[3 * index + 2] << 24));
+		};
+
+		for (; i < frames; ++i)
+		{
+			dst[i][0] = 1.0f / 0x100000000 * value(channels * i);
+			dst[i][1] = channels == 1 ? dst[i][0] : 1.0f / 0x100000000 * value(channels * i + 1);
+		}
+		return;
+	}
+
+	const auto pInt = reinterpret_cast<const std::int16_t*>(src);
+
+#ifdef __SSE2__
+	const auto scale = _mm_set1_ps(1.0f / 0x10000);
+	if (channels == 2)
+	{
+		for (; i + 4 <= frames; i += 4)
+		{
+			const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInt + 2 * i));
+			// Sign extend to 32 bit by moving each value into the upper half of a lane
+			const auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+			const auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+			_mm_storeu_ps(&dst[i][0], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(&dst[i + 2][0], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+	}
+	else if (channels == 1)
+	{
+		for (; i + 4 <= frames; i += 4)
+		{
+			const auto in = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pInt + i));
+			const auto values = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), scale);
+			_mm_storeu_ps(&dst[i][0], _mm_unpacklo_ps(values, values));
+			_mm_storeu_ps(&dst[i + 2][0], _mm_unpackhi_ps(values, values));
+		}
+	}
+#endif
+
+	for (; i < frames; ++i)
+	{
+		dst[i][0] = 1.0f / 0x10000 * pInt[channels * i];
+		dst[i][1] = channels == 1 ? dst[i][0] : 1.0f / 0x10000 * pInt[channels * i + 1];
+	}
+}
+
+//! Continue playing at the other end of the loop, after @p position reached its end in the direction of @p backward.
+//! Normal loops jump back to their start, bidirectional ones turn around and backward ones jump back to their end.
+void continueLoop(gig::loop_type_t type, f_cnt_t loopStart, f_cnt_t loopEnd, f_cnt_t& position, bool& backward)
+{
+	switch (type)
+	{
+		case gig::loop_type_bidirectional:
+			backward = !backward;
+			break;
+		case gig::loop_type_backward:
+			backward = true;
+			position = loopEnd;
+			break;
+		default:
+			position = loopStart;
+			break;
+	}
+}
+
+} // namespace
+
+
+
+
+class GigStreamer::Stream
+{
+public:
+	enum class State
+	{
+		Idle,
+		Reserved,	//!< Being set up by an audio thread
+		Active,		//!< Filled by the background thread and read by the voice
+		Stopping	//!< Given up by the voice, to be emptied by the background thread
+	};
+
+	Stream()
+		: ring(StreamFrames)
+		, reader(ring)
+	{
+	}
+
+	std::atomic<State> state = State::Idle;
+
+	// Written by the audio thread before the stream becomes active, then owned by the background thread
+	gig::Sample* sample = nullptr;
+	bool loop = false;
+	gig::loop_type_t loopType = gig::loop_type_normal;
+	f_cnt_t loopStart = 0;
+	f_cnt_t loopEnd = 0;
+	f_cnt_t position = 0; //!< Next frame to read from the file, or the one past it if reading backward
+	bool backward = false;
+
+	LocklessRingBuffer<SampleFrame> ring;
+	LocklessRingBufferReader<SampleFrame> reader;
+};
+
+
+
+
+GigStreamer::Voice::Voice(gig::Sample* sample, gig::DimensionRegion* region, const GigSampleHead* head)
+	: m_sample(sample)
+	, m_head(head)
+	, m_total(sample ? sample->SamplesTotal : 0)
+{
+	// Currently only support at max one loop
+	if (region && region->pSampleLoops && region->SampleLoops > 0)
+	{
+		const auto& loop = region->pSampleLoops[0];
+		m_loopStart = loop.LoopStart;
+		m_loopEnd = loop.LoopStart + loop.LoopLength;
+		m_loopType = static_cast<gig::loop_type_t>(loop.LoopType);
+		m_loop = loop.LoopLength > 0 && m_loopEnd <= m_total;
+	}
+}
+
+
+
+
+bool GigStreamer::Voice::needsStream() const
+{
+	return (m_loop ? m_loopEnd : m_total) > headFrames();
+}
+
+
+
+
+void GigStreamer::Voice::read(SampleFrame* dst, f_cnt_t frames)
+{
+	auto done = f_cnt_t{0};
+
+	while (done < frames && !m_streaming)
+	{
+		const auto end = m_loop ? std::min(m_loopEnd, headFrames()) : headFrames();
+		if (m_backward)
+		{
+			// Only loops that fit into the head are played backward from it
+			const auto count = std::min(frames - done, m_position - m_loopStart);
+			const auto src = m_head->frames.data() + m_position;
+			std::reverse_copy(src - count, src, dst + done);
+			m_position -= count;
+			done += count;
+		}
+		else if (m_position < end)
+		{
+			const auto count = std::min(frames - done, end - m_position);
+			std::copy_n(m_head->frames.data() + m_position, count, dst + done);
+			m_position += count;
+			done += count;
+		}
+		else if (needsStream()) { m_streaming = true; }
+		else { break; }
+
+		if (m_loop && m_position == (m_backward ? m_loopStart : m_loopEnd))
+		{
+			continueLoop(m_loopType, m_loopStart, m_loopEnd, m_position, m_backward);
+		}
+	}
+
+	if (m_streaming && m_stream)
+	{
+		const auto data = m_stream->reader.read_max(frames - done);
+		for (std::size_t i = 0; i < data.size(); ++i)
+		{
+			dst[done + i] = data[i];
+		}
+		done += data.size();
+	}
+
+	std::fill(dst + done, dst + frames, SampleFrame{});
+}
+
+
+
+
+GigStreamer::GigStreamer()
+	: m_readBuffer(ChunkFrames * 2 * 3)
+	, m_convertBuffer(ChunkFrames)
+{
+	for (std::size_t i = 0; i < MaxStreams; ++i)
+	{
+		m_streams.push_back(std::make_unique<Stream>());
+	}
+
+	m_thread = std::thread{[this] { run(); }};
+}
+
+
+
+
+GigStreamer::~GigStreamer()
+{
+	{
+		const auto lock = std::lock_guard{m_quitMutex};
+		m_quit = true;
+	}
+	m_quitCond.notify_one();
+	m_thread.join();
+}
+
+
+
+
+std::unique_ptr<GigSampleHead> GigStreamer::loadHead(gig::Sample* sample)
+{
+	auto head = std::make_unique<GigSampleHead>();
+	const auto frames = std::min<f_cnt_t>(sample->SamplesTotal, HeadFrames);
+
+	auto buffer = std::vector<std::int8_t>(frames * sample->FrameSize);
+	auto read = f_cnt_t{0};
+	{
+		const auto lock = std::lock_guard{m_fileMutex};
+		try
+		{
+			sample->SetPos(0);
+			read = sample->Read(buffer.data(), frames);
+		}
+		catch (...)
+		{
+			return head;
+		}
+	}
+
+	head->frames.resize(read);
+	convertToFloat(buffer.data(), sample, head->frames.data(), read);
+	return head;
+}
+
+
+
+
+void GigStreamer::start(Voice& voice)
+{
+	if (voice.m_stream || !voice.needsStream()) { return; }
+
+	for (auto& stream : m_streams)
+	{
+		auto expected = Stream::State::Idle;
+		if (!stream->state.compare_exchange_strong(expected, Stream::State::Reserved, std::memory_order_acquire))
+		{
+			continue;
+		}
+
+		stream->sample = voice.m_sample;
+		stream->loop = voice.m_loop;
+		stream->loopType = voice.m_loopType;
+		stream->loopStart = voice.m_loopStart;
+		stream->loopEnd = voice.m_loopEnd;
+		stream->position = voice.headFrames();
+		stream->backward = false;
+		stream->state.store(Stream::State::Active, std::memory_order_release);
+
+		voice.m_stream = stream.get();
+		return;
+	}
+}
+
+
+
+
+void GigStreamer::stop(Voice& voice)
+{
+	if (!voice.m_stream) { return; }
+
+	voice.m_stream->state.store(Stream::State::Stopping, std::memory_order_release);
+	voice.m_stream = nullptr;
+}
+
+
+
+
+void GigStreamer::stopAll()
+{
+	const auto lock = std::lock_guard{m_fileMutex};
+	for (auto& stream : m_streams)
+	{
+		stream->reader.read_max(StreamFrames);
+		stream->state.store(Stream::State::Idle, std::memory_order_release);
+	}
+}
+
+
+
+
+void GigStreamer::run()
+{
+	auto quitLock = std::unique_lock{m_quitMutex};
+	while (!m_quitCond.wait_for(quitLock, PollInterval, [this] { return m_quit; }))
+	{
+		const auto lock = std::lock_guard{m_fileMutex};
+		for (auto& stream : m_streams)
+		{
+			switch (stream->state.load(std::memory_order_acquire))
+			{
+				case Stream::State::Active:
+					fill(*stream);
+					break;
+				case Stream::State::Stopping:
+					// The voice is gone, so nobody else reads from the ring buffer
+					stream->reader.read_max(StreamFrames);
+					stream->state.store(Stream::State::Idle, std::memory_order_release);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
+
+
+
+void GigStreamer::fill(Stream& stream)
+{
+	const auto total = static_cast<f_cnt_t>(stream.sample->SamplesTotal);
+	const auto end = stream.loop ? stream.loopEnd : total;
+
+	while (stream.ring.free() > 0)
+	{
+		// Backward, the frames below the position are read forward and then reversed
+		const auto available = stream.backward ? stream.position - stream.loopStart : end - stream.position;
+		if (available == 0) { break; }
+
+		const auto count = std::min({stream.ring.free(), ChunkFrames, available});
+		const auto from = stream.backward ? stream.position - count : stream.position;
+
+		auto read = f_cnt_t{0};
+		try
+		{
+			stream.sample->SetPos(from);
+			read = stream.sample->Read(m_readBuffer.data(), count);
+		}
+		catch (...)
+		{
+		}
+		if (read == 0 || (stream.backward && read < count))
+		{
+			// Treat broken samples as if they ended here
+			stream.position = total;
+			stream.loop = false;
+			stream.backward = false;
+			return;
+		}
+
+		convertToFloat(m_readBuffer.data(), stream.sample, m_convertBuffer.data(), read);
+		if (stream.backward) { std::reverse(m_convertBuffer.begin(), m_convertBuffer.begin() + read); }
+		stream.ring.write(m_convertBuffer.data(), read);
+
+		stream.position = stream.backward ? stream.position - read : stream.position + read;
+		if (stream.loop && stream.position == (stream.backward ? stream.loopStart : stream.loopEnd))
+		{
+			continueLoop(stream.loopType, stream.loopStart, stream.loopEnd, stream.position, stream.backward);
+		}
+	}
+}
+
+} // namespace lmms
@@ -0,0 +1,134 @@
+/*
+ * GigStreamer.h - Disk streaming of samples from GIG files
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_GIG_STREAMER_H
+#define LMMS_GIG_STREAMER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "SampleFrame.h"
+#include "gig.h"
+
+namespace lmms
+{
+
+//! The first frames of a sample from a GIG file, converted to float when the instrument is loaded, so that notes
+//! can start playing without waiting for the disk
+struct GigSampleHead
+{
+	std::vector<SampleFrame> frames;
+};
+
+
+//! Reads the samples of a GIG file on a background thread, so that the audio threads never touch the file.
+//!
+//! A voice plays the preloaded head of its sample first. Anything past the head is read by the background thread
+//! into a lock-free ring buffer of the voice, starting as soon as the voice starts. Samples that fit into their
+//! head, including their loop, are played from memory alone.
+class GigStreamer
+{
+public:
+	//! Frames of each sample that are loaded ahead of playing
+	static constexpr auto HeadFrames = f_cnt_t{8192};
+	//! Frames buffered ahead for each streaming voice
+	static constexpr auto StreamFrames = std::size_t{8192};
+	//! Voices that can stream at the same time. Voices beyond this fall silent after their head.
+	static constexpr auto MaxStreams = std::size_t{64};
+
+	class Stream;
+
+	//! The position of a voice within its sample
+	class Voice
+	{
+	public:
+		Voice() = default;
+		Voice(gig::Sample* sample, gig::DimensionRegion* region, const GigSampleHead* head);
+
+		//! Write the next @p frames frames of the sample to @p dst, followed by silence past its end or if the
+		//! stream falls behind. Realtime safe.
+		void read(SampleFrame* dst, f_cnt_t frames);
+
+		//! Whether the sample continues past its head
+		bool needsStream() const;
+
+	private:
+		f_cnt_t headFrames() const { return m_head ? m_head->frames.size() : 0; }
+
+		gig::Sample* m_sample = nullptr;
+		const GigSampleHead* m_head = nullptr;
+		Stream* m_stream = nullptr;
+		bool m_loop = false;
+		gig::loop_type_t m_loopType = gig::loop_type_normal;
+		f_cnt_t m_loopStart = 0;
+		f_cnt_t m_loopEnd = 0;
+		f_cnt_t m_total = 0;
+		f_cnt_t m_position = 0; //!< Within the head, until m_streaming is set
+		//! Whether the loop is being played backward, in which case m_position is past the next frame
+		bool m_backward = false;
+		bool m_streaming = false;
+
+		friend class GigStreamer;
+	};
+
+	GigStreamer();
+	~GigStreamer();
+
+	//! Load the head of @p sample. Called on the main thread.
+	std::unique_ptr<GigSampleHead> loadHead(gig::Sample* sample);
+
+	//! Start reading the part of the sample of @p voice past its head. Realtime safe.
+	void start(Voice& voice);
+	//! Stop the stream of @p voice, if it has one. Realtime safe.
+	void stop(Voice& voice);
+	//! Stop all streams. The caller must make sure that no voice is played concurrently, e.g. before the file is
+	//! closed.
+	void stopAll();
+
+private:
+	void run();
+	void fill(Stream& stream);
+
+	//! Serializes all access to the file, which libgig does not allow concurrently
+	std::mutex m_fileMutex;
+	std::vector<std::unique_ptr<Stream>> m_streams;
+
+	//! Buffers of the background thread
+	std::vector<std::int8_t> m_readBuffer;
+	std::vector<SampleFrame> m_convertBuffer;
+
+	std::thread m_thread;
+	std::mutex m_quitMutex;
+	std::condition_variable m_quitCond;
+	bool m_quit = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_GIG_STREAMER_H
@@ -29,7 +29,9 @@
 #include "AutomatableModel.h"
 #include "Instrument.h"
 #include "InstrumentView.h"
+#include "KickerOsc.h"
 #include "TempoSyncKnobModel.h"
+#include "VoicePool.h"
 
 
 namespace lmms
@@ -73,6 +75,9 @@ public:
 
 
 private:
+	using DistFX = DspEffectLibrary::Distortion;
+	using SweepOsc = KickerOsc<DspEffectLibrary::MonoToStereoAdaptor<DistFX>>;
+
 	FloatModel m_startFreqModel;
 	FloatModel m_endFreqModel;
 	TempoSyncKnobModel m_decayModel;
@@ -89,6 +94,8 @@ private:
 
 	IntModel m_versionModel;
 
+	VoicePool<SweepOsc> m_voices;
+
 	friend class gui::KickerInstrumentView;
 
 } ;
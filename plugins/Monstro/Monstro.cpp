@@ -1066,7 +1066,7 @@ void MonstroInstrument::playNote( NotePlayHandle * _n,
 
 	if (!_n->m_pluginData)
 	{
-		_n->m_pluginData = new MonstroSynth( this, _n );
+		_n->m_pluginData = m_voices.acquire( this, _n );
 	}
 
 	auto ms = static_cast<MonstroSynth*>(_n->m_pluginData);
@@ -1078,7 +1078,7 @@ void MonstroInstrument::playNote( NotePlayHandle * _n,
 
 void MonstroInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<MonstroSynth *>( _n->m_pluginData );
+	m_voices.release( static_cast<MonstroSynth *>( _n->m_pluginData ) );
 }
 
 
@@ -37,6 +37,7 @@
 #include "Oscillator.h"
 #include "lmms_math.h"
 #include "BandLimitedWave.h"
+#include "VoicePool.h"
 
 //
 //	UI Macros
@@ -576,6 +577,8 @@ private:
 	FloatModel	m_sub3lfo1;
 	FloatModel	m_sub3lfo2;
 
+	VoicePool<MonstroSynth> m_voices;
+
 	friend class MonstroSynth;
 	friend class gui::MonstroView;
 
@@ -0,0 +1,92 @@
+/*
+ * Sf2Font.cpp - Soundfonts loaded in the background for Sf2Player
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Sf2Font.h"
+
+#include <fluidsynth.h>
+#include <utility>
+
+namespace lmms
+{
+
+
+Sf2Font::Sf2Font(const QString& path) :
+	m_path(path)
+{
+	m_thread = std::thread{[this] { load(); }};
+}
+
+
+
+
+Sf2Font::~Sf2Font()
+{
+	wait();
+
+	// Deleting the synth that loaded the soundfont frees it, unless it was taken
+	if (m_owner != nullptr) { delete_fluid_synth(m_owner); }
+	if (m_settings != nullptr) { delete_fluid_settings(m_settings); }
+}
+
+
+
+
+fluid_sfont_t* Sf2Font::take()
+{
+	if (!isLoaded() || m_sfont == nullptr) { return nullptr; }
+
+	// All samples are read while loading, so the soundfont does not need the loader of m_owner anymore
+	fluid_synth_remove_sfont(m_owner, m_sfont);
+	return std::exchange(m_sfont, nullptr);
+}
+
+
+
+
+void Sf2Font::wait()
+{
+	if (m_thread.joinable()) { m_thread.join(); }
+}
+
+
+
+
+void Sf2Font::load()
+{
+	const auto path = m_path.toLocal8Bit();
+
+	m_settings = new_fluid_settings();
+	m_owner = new_fluid_synth(m_settings);
+
+	if (m_owner != nullptr && fluid_synth_sfload(m_owner, path.constData(), false) != FLUID_FAILED)
+	{
+		m_sfont = fluid_synth_get_sfont(m_owner, 0);
+	}
+
+	m_state.store(m_sfont != nullptr ? State::Loaded : State::Failed, std::memory_order_release);
+	emit loaded();
+}
+
+
+} // namespace lmms
@@ -0,0 +1,91 @@
+/*
+ * Sf2Font.h - Soundfonts loaded in the background for Sf2Player
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SF2_FONT_H
+#define LMMS_SF2_FONT_H
+
+#include <atomic>
+#include <fluidsynth/types.h>
+#include <thread>
+#include <QObject>
+#include <QString>
+
+namespace lmms
+{
+
+
+//! A soundfont that is loaded on a background thread, so that large ones don't stall the UI, and then moved into the
+//! synth of one instrument.
+//!
+//! fluidsynth does not support adding a soundfont to several synths that play at the same time, so every instrument
+//! loads its own, even if the same file is used elsewhere.
+class Sf2Font : public QObject
+{
+	Q_OBJECT
+public:
+	explicit Sf2Font(const QString& path);
+	~Sf2Font() override;
+
+	const QString& path() const { return m_path; }
+
+	//! Whether loading finished, successfully or not
+	bool isLoaded() const { return m_state.load(std::memory_order_acquire) != State::Loading; }
+
+	//! Remove the loaded soundfont from the synth it was loaded with and return it, or nullptr while loading, if
+	//! loading failed or if it was taken already. The caller has to add it to a single synth of its own with
+	//! fluid_synth_add_sfont(), which then owns it.
+	fluid_sfont_t* take();
+
+	//! Block until loading finished
+	void wait();
+
+signals:
+	//! Emitted on the loading thread once loading finished
+	void loaded();
+
+private:
+	enum class State
+	{
+		Loading,
+		Loaded,
+		Failed
+	};
+
+	void load();
+
+	const QString m_path;
+
+	//! The synth the soundfont is loaded with, which owns it until it is taken. It never plays.
+	fluid_settings_t* m_settings = nullptr;
+	fluid_synth_t* m_owner = nullptr;
+	fluid_sfont_t* m_sfont = nullptr;
+
+	std::atomic<State> m_state = State::Loading;
+	std::thread m_thread;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_SF2_FONT_H
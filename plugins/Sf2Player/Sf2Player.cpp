@@ -35,6 +35,7 @@
 #include "ConfigManager.h"
 #include "FileDialog.h"
 #include "Engine.h"
+#include "GuiApplication.h"
 #include "InstrumentTrack.h"
 #include "InstrumentPlayHandle.h"
 #include "Knob.h"
@@ -127,6 +128,7 @@ Sf2Instrument::Sf2Instrument( InstrumentTrack * _instrument_track ) :
 	m_synth(nullptr),
 	m_font( nullptr ),
 	m_fontId( 0 ),
+	m_selectFirstPatch( false ),
 	m_filename( "" ),
 	m_lastMidiPitch( -1 ),
 	m_lastMidiPitchRange( -1 ),
@@ -290,10 +292,26 @@ void Sf2Instrument::loadSettings( const QDomElement & _this )
 
 void Sf2Instrument::loadFile( const QString & _file )
 {
+	// The soundfont is loaded in the background, so the first patch is
+	// selected once it is there
+	m_selectFirstPatch = true;
+
 	if( !_file.isEmpty() && QFileInfo( _file ).exists() )
 	{
 		openFile( _file, false );
 	}
+	else
+	{
+		selectFirstPatch();
+	}
+}
+
+
+
+
+void Sf2Instrument::selectFirstPatch()
+{
+	m_selectFirstPatch = false;
 
 	// setting the first bank and patch number that is found
 	auto sSoundCount = ::fluid_synth_sfcount( m_synth );
@@ -362,6 +380,12 @@ QString Sf2Instrument::nodeName() const
 
 void Sf2Instrument::freeFont()
 {
+	if (m_pendingFont != nullptr)
+	{
+		disconnect(m_pendingFont.get(), nullptr, this, nullptr);
+		m_pendingFont = nullptr;
+	}
+
 	m_synthMutex.lock();
 
 	if (m_font != nullptr)
@@ -379,54 +403,78 @@ void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
 {
 	emit fileLoading();
 
-	// Used for loading file
-	char * sf2Ascii = qstrdup( qPrintable( PathUtil::toAbsolute( _sf2File ) ) );
-	QString relativePath = PathUtil::toShortestRelative( _sf2File );
+	const QString absolutePath = PathUtil::toAbsolute( _sf2File );
 
 	// free the soundfont if one is selected
 	freeFont();
 
-	m_synthMutex.lock();
-
-	bool loaded = false;
-	if (fluid_is_soundfont(sf2Ascii))
+	if (fluid_is_soundfont(qPrintable(absolutePath)))
 	{
-		m_fontId = fluid_synth_sfload(m_synth, sf2Ascii, true);
-
-		if (fluid_synth_sfcount(m_synth) > 0)
+		// Soundfonts are loaded on a background thread, so large ones
+		// don't stall the UI
+		m_pendingFont = std::make_unique<Sf2Font>(absolutePath);
+		m_pendingFilename = PathUtil::toShortestRelative( _sf2File );
+		connect(m_pendingFont.get(), &Sf2Font::loaded, this, &Sf2Instrument::attachFont, Qt::QueuedConnection);
+
+		// Without a GUI, rendering starts right after loading the project
+		if (gui::getGUI() == nullptr)
 		{
-			// Grab this sf from the top of the stack and add to list
-			m_font = fluid_synth_get_sfont(m_synth, 0);
-			loaded = true;
+			m_pendingFont->wait();
 		}
-	}
 
-	if (!loaded)
+		// In case it was loaded already
+		attachFont();
+	}
+	else
 	{
+		m_selectFirstPatch = false;
 		collectErrorForUI(Sf2Instrument::tr("A soundfont %1 could not be loaded.").arg(QFileInfo(_sf2File).baseName()));
 	}
 
-	m_synthMutex.unlock();
+	if( updateTrackName || instrumentTrack()->displayName() == displayName() )
+	{
+		instrumentTrack()->setName( PathUtil::cleanName( _sf2File ) );
+	}
+}
 
-	if( m_fontId >= 0 )
+
+
+
+void Sf2Instrument::attachFont()
+{
+	if (m_pendingFont == nullptr || !m_pendingFont->isLoaded())
 	{
-		// Don't reset patch/bank, so that it isn't cleared when
-		// someone resolves a missing file
-		//m_patchNum.setValue( 0 );
-		//m_bankNum.setValue( 0 );
-		m_filename = relativePath;
+		return;
+	}
+
+	const auto font = std::move(m_pendingFont);
+	disconnect(font.get(), nullptr, this, nullptr);
 
-		emit fileChanged();
+	const auto sfont = font->take();
+	if (sfont == nullptr)
+	{
+		m_selectFirstPatch = false;
+		collectErrorForUI(Sf2Instrument::tr("A soundfont %1 could not be loaded.").arg(QFileInfo(font->path()).baseName()));
+		return;
 	}
 
-	delete[] sf2Ascii;
+	m_synthMutex.lock();
+	m_font = sfont;
+	m_fontId = fluid_synth_add_sfont(m_synth, m_font);
+	m_synthMutex.unlock();
+
+	// Don't reset patch/bank, so that it isn't cleared when
+	// someone resolves a missing file
+	m_filename = m_pendingFilename;
 
-	if( updateTrackName || instrumentTrack()->displayName() == displayName() )
+	if (m_selectFirstPatch)
 	{
-		instrumentTrack()->setName( PathUtil::cleanName( _sf2File ) );
+		selectFirstPatch();
 	}
 
 	updatePatch();
+
+	emit fileChanged();
 }
 
 
@@ -434,7 +482,7 @@ void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
 
 void Sf2Instrument::updatePatch()
 {
-	if( m_bankNum.value() >= 0 && m_patchNum.value() >= 0 )
+	if( m_font != nullptr && m_bankNum.value() >= 0 && m_patchNum.value() >= 0 )
 	{
 		fluid_synth_program_select( m_synth, m_channel, m_fontId,
 				m_bankNum.value(), m_patchNum.value() );
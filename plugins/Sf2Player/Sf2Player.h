@@ -29,6 +29,7 @@
 
 #include <array>
 #include <fluidsynth/types.h>
+#include <memory>
 #include <QMutex>
 #include <samplerate.h>
 
@@ -38,6 +39,7 @@
 #include "InstrumentView.h"
 #include "LcdSpinBox.h"
 #include "SampleFrame.h"
+#include "Sf2Font.h"
 
 class QLabel;
 
@@ -105,6 +107,10 @@ public slots:
 	void updateGain();
 	void updateTuning();
 
+private slots:
+	// Add the soundfont to the synth once it finished loading
+	void attachFont();
+
 private:
 	AudioResampler m_resampler;
 	std::array<SampleFrame, DEFAULT_BUFFER_SIZE> m_buffer;
@@ -114,8 +120,14 @@ private:
 	fluid_synth_t* m_synth;
 
 	fluid_sfont_t* m_font;
-
 	int m_fontId;
+
+	// The soundfont that is being loaded to replace m_font
+	std::unique_ptr<Sf2Font> m_pendingFont;
+	QString m_pendingFilename;
+	// Whether to select the first patch of the pending soundfont
+	bool m_selectFirstPatch;
+
 	QString m_filename;
 
 	// Protect the array of active notes
@@ -153,6 +165,7 @@ private:
 
 private:
 	void freeFont();
+	void selectFirstPatch();
 	void noteOn( Sf2PluginData * n );
 	void noteOff( Sf2PluginData * n );
 	void renderFrames( f_cnt_t frames, SampleFrame* buf );
@@ -51,6 +51,11 @@ inline fluid_sfont_t* fluid_preset_get_sfont(fluid_preset_t* preset)
 	return preset->sfont;
 }
 
+inline int fluid_sfont_get_id(fluid_sfont_t* sfont)
+{
+	return sfont->id;
+}
+
 inline char* fluid_sfont_get_name(fluid_sfont_t* sfont)
 {
 	return sfont->get_name(sfont);
@@ -442,7 +442,7 @@ void SfxrInstrument::playNote( NotePlayHandle * _n, SampleFrame* _working_buffer
 	const f_cnt_t offset = _n->noteOffset();
 	if (!_n->m_pluginData)
 	{
-		_n->m_pluginData = new SfxrSynth( this );
+		_n->m_pluginData = m_voices.acquire( this );
 	}
 	else if( static_cast<SfxrSynth*>(_n->m_pluginData)->isPlaying() == false )
 	{
@@ -479,7 +479,7 @@ void SfxrInstrument::playNote( NotePlayHandle * _n, SampleFrame* _working_buffer
 
 void SfxrInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<SfxrSynth *>( _n->m_pluginData );
+	m_voices.release( static_cast<SfxrSynth *>( _n->m_pluginData ) );
 }
 
 
@@ -33,6 +33,7 @@
 #include "AutomatableModel.h"
 #include "Instrument.h"
 #include "InstrumentView.h"
+#include "VoicePool.h"
 
 namespace lmms
 {
@@ -225,6 +226,8 @@ private:
 
 	IntModel m_waveFormModel;
 
+	VoicePool<SfxrSynth> m_voices;
+
 	friend class gui::SfxrInstrumentView;
 	friend class SfxrSynth;
 };
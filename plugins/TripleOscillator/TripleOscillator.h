@@ -26,13 +26,17 @@
 #ifndef _TRIPLE_OSCILLATOR_H
 #define _TRIPLE_OSCILLATOR_H
 
+#include <array>
 #include <memory>
+#include <optional>
 
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "AutomatableModel.h"
+#include "Oscillator.h"
 #include "OscillatorConstants.h"
 #include "SampleBuffer.h"
+#include "VoicePool.h"
 
 namespace lmms
 {
@@ -135,11 +139,21 @@ protected slots:
 private:
 	OscillatorObject * m_osc[NUM_OF_OSCILLATORS];
 
-	struct oscPtr
+	//! Oscillators of a note, chained so that each one is modulated by the next
+	struct Voice
 	{
-		Oscillator * oscLeft;
-		Oscillator * oscRight;
-	} ;
+		~Voice()
+		{
+			// The chain is stored here, so the oscillators must not delete their sub-oscillators
+			for (auto& osc : left) { if (osc) { osc->releaseSubOsc(); } }
+			for (auto& osc : right) { if (osc) { osc->releaseSubOsc(); } }
+		}
+
+		std::array<std::optional<Oscillator>, NUM_OF_OSCILLATORS> left;
+		std::array<std::optional<Oscillator>, NUM_OF_OSCILLATORS> right;
+	};
+
+	VoicePool<Voice> m_voices;
 
 
 	friend class gui::TripleOscillatorView;
@@ -31,9 +31,12 @@
 #include <random>
 #include <numbers>
 
+#include "Engine.h"
+#include "InstrumentTrack.h"
 #include "lmms_math.h"
 #include "NotePlayHandle.h"
 #include "SampleFrame.h"
+#include "Song.h"
 
 
 #include <exprtk.hpp>
@@ -84,6 +87,7 @@ struct IntegrateFunction : public exprtk::ifunction<T>
 	exprtk::ifunction<T>(1),
 	m_firstValue(0),
 	m_frame(frame),
+	m_initFrame(frame),
 	m_sampleRate(sample_rate),
 	m_maxCounters(max_counters),
 	m_nCounters(0),
@@ -94,6 +98,15 @@ struct IntegrateFunction : public exprtk::ifunction<T>
 		clearArray(m_counters,max_counters);
 	}
 
+	void reset()
+	{
+		m_frame = m_initFrame;
+		m_nCounters = 0;
+		m_nCountersCalls = 0;
+		m_cc = 0;
+		clearArray(m_counters, m_maxCounters);
+	}
+
 	inline T operator()(const T& x) override
 	{
 		if (m_frame)
@@ -129,6 +142,7 @@ struct IntegrateFunction : public exprtk::ifunction<T>
 	}
 	unsigned int m_firstValue;
 	const unsigned int* m_frame;
+	const unsigned int* const m_initFrame;
 	const unsigned int m_sampleRate;
 	// number of counters allocated
 	const unsigned int m_maxCounters;
@@ -159,6 +173,12 @@ struct LastSampleFunction : public exprtk::ifunction<T>
 		clearArray(m_samples, history_size);
 	}
 
+	void reset()
+	{
+		clearArray(m_samples, m_history_size);
+		m_pivot_last = m_history_size - 1;
+	}
+
 	inline T operator()(const T& x) override
 	{
 		if (!std::isnan(x) && x >= 1 && x <= m_history_size) {
@@ -354,7 +374,7 @@ struct RandomVectorFunction : public exprtk::ifunction<float>
 		return RandomVectorSeedFunction::randv(index,m_rseed);
 	}
 
-	const unsigned int m_rseed;
+	unsigned int m_rseed;
 };
 
 namespace SimpleRandom {
@@ -375,6 +395,7 @@ class ExprFrontData
 {
 public:
 	ExprFrontData(int last_func_samples):
+	m_seed(0),
 	m_rand_vec(SimpleRandom::generator()),
 	m_integ_func(nullptr),
 	m_last_func(last_func_samples)
@@ -398,6 +419,7 @@ public:
 	symbol_table_t m_symbol_table;
 	expression_t m_expression;
 	std::string m_expression_string;
+	float m_seed;
 	std::vector<WaveValueFunction<float>* > m_cyclics;
 	std::vector<WaveValueFunctionInterpolate<float>* > m_cyclics_interp;
 	RandomVectorFunction m_rand_vec;
@@ -536,7 +558,9 @@ ExprFront::ExprFront(const char * expr, int last_func_samples)
 
 		m_data->m_symbol_table.add_constant("e", std::numbers::e_v<float>);
 
-		m_data->m_symbol_table.add_constant("seed", SimpleRandom::generator() & max_float_integer_mask);
+		// a variable rather than a constant, so that reset() can draw a new one for the next note
+		m_data->m_seed = SimpleRandom::generator() & max_float_integer_mask;
+		m_data->m_symbol_table.add_variable("seed", m_data->m_seed);
 
 		m_data->m_symbol_table.add_function("sinew", sin_wave_func);
 		m_data->m_symbol_table.add_function("squarew", square_wave_func);
@@ -694,30 +718,54 @@ void ExprFront::setIntegrate(const unsigned int* const frameCounter, const unsig
 	}
 }
 
-ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSample *gW3,
-	ExprFront *exprO1, ExprFront *exprO2,
-	NotePlayHandle *nph, const sample_rate_t sample_rate,
-	const FloatModel* pan1, const FloatModel* pan2, float rel_trans):
-	m_exprO1(exprO1),
-	m_exprO2(exprO2),
+void ExprFront::reset()
+{
+	m_data->m_seed = SimpleRandom::generator() & max_float_integer_mask;
+	m_data->m_rand_vec.m_rseed = SimpleRandom::generator();
+	m_data->m_last_func.reset();
+	if (m_data->m_integ_func)
+	{
+		m_data->m_integ_func->reset();
+	}
+}
+
+ExprSynth::ExprSynth(const char* exprO1, const char* exprO2,
+	const WaveSample *gW1, const WaveSample *gW2, const WaveSample *gW3,
+	float& A1, float& A2, float& A3, const sample_rate_t sample_rate,
+	const FloatModel* pan1, const FloatModel* pan2, int generation):
+	m_exprO1(new ExprFront(exprO1, sample_rate)), // give the "last" function a whole second
+	m_exprO2(new ExprFront(exprO2, sample_rate)),
 	m_W1(gW1),
 	m_W2(gW2),
 	m_W3(gW3),
-	m_nph(nph),
+	m_note_sample(0),
+	m_note_rel_sample(0),
+	m_note_sample_sec(0),
+	m_note_rel_sec(0),
+	m_frequency(0),
+	m_released(0),
+	m_key(0),
+	m_base_note(0),
+	m_volume(0),
+	m_tempo(0),
+	m_nph(nullptr),
 	m_sample_rate(sample_rate),
 	m_pan1(pan1),
 	m_pan2(pan2),
-	m_rel_transition(rel_trans)
-{
-	m_note_sample = 0;
-	m_note_rel_sample = 0;
-	m_note_rel_sec = 0;
-	m_note_sample_sec = 0;
-	m_released = 0;
-	m_frequency = m_nph->frequency();
-	m_rel_inc = 1000.0 / (m_sample_rate * m_rel_transition);//rel_transition in ms. compute how much increment in each frame
-
-	auto init_expression_step2 = [this](ExprFront * e) {
+	m_rel_transition(0),
+	m_rel_inc(0),
+	m_generation(generation)
+{
+	auto init_expression = [&](ExprFront * e) {
+		//add the constants and the variables to the expression.
+		e->add_variable("key", m_key);//the key that was pressed.
+		e->add_variable("bnote", m_base_note); // the base note
+		e->add_constant("srate", m_sample_rate);// sample rate of the audio engine
+		e->add_variable("v", m_volume); //volume of the note.
+		e->add_variable("tempo", m_tempo);//tempo of the song.
+		e->add_variable("A1", A1);//A1,A2,A3: general purpose input controls.
+		e->add_variable("A2", A2);
+		e->add_variable("A3", A3);
 		e->add_cyclic_vector("W1", m_W1->m_samples,m_W1->m_length, m_W1->m_interpolate);
 		e->add_cyclic_vector("W2", m_W2->m_samples,m_W2->m_length, m_W2->m_interpolate);
 		e->add_cyclic_vector("W3", m_W3->m_samples,m_W3->m_length, m_W3->m_interpolate);
@@ -728,9 +776,28 @@ ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSam
 		e->setIntegrate(&m_note_sample,m_sample_rate);
 		e->compile();
 	};
-	init_expression_step2(m_exprO1);
-	init_expression_step2(m_exprO2);
+	init_expression(m_exprO1);
+	init_expression(m_exprO2);
+
+}
 
+void ExprSynth::start(NotePlayHandle* nph, float rel_trans)
+{
+	m_nph = nph;
+	m_note_sample = 0;
+	m_note_rel_sample = 0;
+	m_note_rel_sec = 0;
+	m_note_sample_sec = 0;
+	m_released = 0;
+	m_frequency = m_nph->frequency();
+	m_key = m_nph->key();
+	m_base_note = m_nph->instrumentTrack()->baseNote();
+	m_volume = m_nph->getVolume() / 255.0;
+	m_tempo = Engine::getSong()->getTempo();
+	m_rel_transition = rel_trans;
+	m_rel_inc = 1000.0 / (m_sample_rate * m_rel_transition);//rel_transition in ms. compute how much increment in each frame
+	m_exprO1->reset();
+	m_exprO2->reset();
 }
 
 ExprSynth::~ExprSynth()
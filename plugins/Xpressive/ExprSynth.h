@@ -53,6 +53,9 @@ public:
 	bool add_constant(const char* name, float  ref);
 	bool add_cyclic_vector(const char* name, const float* data, size_t length, bool interp = false);
 	void setIntegrate(const unsigned int* frameCounter, unsigned int sample_rate);
+	//! Clear the state of integrate() and last() and draw a new seed, so that the compiled expression can be
+	//! evaluated again from the start
+	void reset();
 	ExprFrontData* getData() { return m_data; }
 private:
 	ExprFrontData *m_data;
@@ -95,12 +98,19 @@ public:
 class ExprSynth
 {
 public:
-	ExprSynth(const WaveSample* gW1, const WaveSample* gW2, const WaveSample* gW3, ExprFront* exprO1, ExprFront* exprO2, NotePlayHandle* nph,
-			const sample_rate_t sample_rate, const FloatModel* pan1, const FloatModel* pan2, float rel_trans);
+	//! Compiles both output expressions with the inputs of a note bound to members, so that the synth can play one
+	//! note after another without compiling them again. @p A1, @p A2 and @p A3 must outlive the synth.
+	ExprSynth(const char* exprO1, const char* exprO2, const WaveSample* gW1, const WaveSample* gW2,
+			const WaveSample* gW3, float& A1, float& A2, float& A3, const sample_rate_t sample_rate,
+			const FloatModel* pan1, const FloatModel* pan2, int generation);
 	virtual ~ExprSynth();
 
+	//! Prepare for playing @p nph from its start
+	void start(NotePlayHandle* nph, float rel_trans);
 	void renderOutput(fpp_t frames, SampleFrame* buf );
 
+	//! The generation of the expressions this synth was compiled from, see Xpressive::acquireSynth()
+	int generation() const { return m_generation; }
 
 private:
 	ExprFront *m_exprO1, *m_exprO2;
@@ -111,11 +121,16 @@ private:
 	float m_note_rel_sec;
 	float m_frequency;
 	float m_released;
+	float m_key;
+	float m_base_note;
+	float m_volume;
+	float m_tempo;
 	NotePlayHandle* m_nph;
 	const sample_rate_t m_sample_rate;
 	const FloatModel *m_pan1,*m_pan2;
 	float m_rel_transition;
 	float m_rel_inc;
+	const int m_generation;
 
 } ;
 
@@ -26,6 +26,7 @@
 
 #include <QDomElement>
 #include <QPlainTextEdit>
+#include <algorithm>
 
 #include "AudioEngine.h"
 #include "Engine.h"
@@ -107,6 +108,31 @@ Xpressive::Xpressive(InstrumentTrack* instrument_track) :
 {
 	m_outputExpression[0]="sinew(integrate(f*(1+0.05sinew(12t))))*(2^(-(1.1+A2)*t)*(0.4+0.1(1+A3)+0.4sinew((2.5+2A1)t))^2)";
 	m_outputExpression[1]="expw(integrate(f*atan(500t)*2/pi))*0.5+0.12";
+
+	connect(&m_interpolateW1, SIGNAL(dataChanged()), this, SLOT(invalidateSynths()));
+	connect(&m_interpolateW2, SIGNAL(dataChanged()), this, SLOT(invalidateSynths()));
+	connect(&m_interpolateW3, SIGNAL(dataChanged()), this, SLOT(invalidateSynths()));
+	connect(Engine::audioEngine(), SIGNAL(sampleRateChanged()), this, SLOT(invalidateSynths()));
+
+	precompileSynths();
+}
+
+Xpressive::~Xpressive()
+{
+	for (auto& synth : m_synthPool)
+	{
+		delete synth.exchange(nullptr);
+	}
+}
+
+void Xpressive::setOutputExpression(int i, const QByteArray& expression)
+{
+	if (m_outputExpression[i] == expression) { return; }
+	{
+		const auto lock = std::lock_guard{m_expressionMutex};
+		m_outputExpression[i] = expression;
+	}
+	invalidateSynths();
 }
 
 void Xpressive::saveSettings(QDomDocument & _doc, QDomElement & _this) {
@@ -147,8 +173,12 @@ void Xpressive::saveSettings(QDomDocument & _doc, QDomElement & _this) {
 
 void Xpressive::loadSettings(const QDomElement & _this) {
 
-	m_outputExpression[0]=_this.attribute( "O1").toLatin1();
-	m_outputExpression[1]=_this.attribute( "O2").toLatin1();
+	{
+		const auto lock = std::lock_guard{m_expressionMutex};
+		m_outputExpression[0]=_this.attribute( "O1").toLatin1();
+		m_outputExpression[1]=_this.attribute( "O2").toLatin1();
+	}
+	invalidateSynths();
 	m_wavesExpression[0]=_this.attribute( "W1").toLatin1();
 	m_wavesExpression[1]=_this.attribute( "W2").toLatin1();
 	m_wavesExpression[2]=_this.attribute( "W3").toLatin1();
@@ -200,30 +230,9 @@ void Xpressive::playNote(NotePlayHandle* nph, SampleFrame* working_buffer) {
 	m_A3=m_parameterA3.value();
 
 	if (!nph->m_pluginData) {
-
-		auto exprO1 = new ExprFront(m_outputExpression[0].constData(),
-			Engine::audioEngine()->outputSampleRate()); // give the "last" function a whole second
-		auto exprO2 = new ExprFront(m_outputExpression[1].constData(), Engine::audioEngine()->outputSampleRate());
-
-		auto init_expression_step1 = [this, nph](ExprFront* e) { //lambda function to init exprO1 and exprO2
-			//add the constants and the variables to the expression.
-			e->add_constant("key", nph->key());//the key that was pressed.
-			e->add_constant("bnote", nph->instrumentTrack()->baseNote()); // the base note
-			e->add_constant("srate", Engine::audioEngine()->outputSampleRate());// sample rate of the audio engine
-			e->add_constant("v", nph->getVolume() / 255.0); //volume of the note.
-			e->add_constant("tempo", Engine::getSong()->getTempo());//tempo of the song.
-			e->add_variable("A1", m_A1);//A1,A2,A3: general purpose input controls.
-			e->add_variable("A2", m_A2);
-			e->add_variable("A3", m_A3);
-		};
-		init_expression_step1(exprO1);
-		init_expression_step1(exprO2);
-
-		m_W1.setInterpolate(m_interpolateW1.value());//set interpolation according to the user selection.
-		m_W2.setInterpolate(m_interpolateW2.value());
-		m_W3.setInterpolate(m_interpolateW3.value());
-		nph->m_pluginData = new ExprSynth(&m_W1, &m_W2, &m_W3, exprO1, exprO2, nph,
-				Engine::audioEngine()->outputSampleRate(), &m_panning1, &m_panning2, m_relTransition.value());
+		auto synth = acquireSynth();
+		synth->start(nph, m_relTransition.value());
+		nph->m_pluginData = synth;
 	}
 
 	auto ps = static_cast<ExprSynth*>(nph->m_pluginData);
@@ -234,7 +243,68 @@ void Xpressive::playNote(NotePlayHandle* nph, SampleFrame* working_buffer) {
 }
 
 void Xpressive::deleteNotePluginData(NotePlayHandle* nph) {
-	delete static_cast<ExprSynth *>(nph->m_pluginData);
+	if (!nph->m_pluginData) { return; }
+	releaseSynth(static_cast<ExprSynth *>(nph->m_pluginData));
+}
+
+ExprSynth* Xpressive::acquireSynth()
+{
+	const int generation = m_synthGeneration.load(std::memory_order_acquire);
+	for (auto& slot : m_synthPool)
+	{
+		const auto synth = slot.exchange(nullptr, std::memory_order_acquire);
+		if (!synth) { continue; }
+		if (synth->generation() == generation) { return synth; }
+		delete synth;
+	}
+
+	// Rather compile on the audio thread than leaving the note silent
+	return createSynth();
+}
+
+void Xpressive::releaseSynth(ExprSynth* synth)
+{
+	if (synth->generation() == m_synthGeneration.load(std::memory_order_acquire))
+	{
+		for (auto& slot : m_synthPool)
+		{
+			auto empty = static_cast<ExprSynth*>(nullptr);
+			if (slot.compare_exchange_strong(empty, synth, std::memory_order_release)) { return; }
+		}
+	}
+	delete synth;
+}
+
+ExprSynth* Xpressive::createSynth()
+{
+	const auto lock = std::lock_guard{m_expressionMutex};
+	return new ExprSynth(m_outputExpression[0].constData(), m_outputExpression[1].constData(),
+			&m_W1, &m_W2, &m_W3, m_A1, m_A2, m_A3, Engine::audioEngine()->outputSampleRate(),
+			&m_panning1, &m_panning2, m_synthGeneration.load(std::memory_order_acquire));
+}
+
+void Xpressive::precompileSynths()
+{
+	m_W1.setInterpolate(m_interpolateW1.value());//set interpolation according to the user selection.
+	m_W2.setInterpolate(m_interpolateW2.value());
+	m_W3.setInterpolate(m_interpolateW3.value());
+
+	const auto pooled = std::count_if(m_synthPool.begin(), m_synthPool.end(),
+		[](const auto& slot) { return slot.load(std::memory_order_relaxed) != nullptr; });
+	for (auto i = static_cast<std::size_t>(pooled); i < Polyphony; ++i)
+	{
+		releaseSynth(createSynth());
+	}
+}
+
+void Xpressive::invalidateSynths()
+{
+	m_synthGeneration.fetch_add(1, std::memory_order_acq_rel);
+	for (auto& slot : m_synthPool)
+	{
+		delete slot.exchange(nullptr, std::memory_order_acquire);
+	}
+	precompileSynths();
 }
 
 gui::PluginView* Xpressive::instantiateView(QWidget* parent) {
@@ -537,10 +607,10 @@ void XpressiveView::expressionChanged() {
 			e->wavesExpression(2) = text;
 			break;
 		case O1_EXPR:
-			e->outputExpression(0) = text;
+			e->setOutputExpression(0, text);
 			break;
 		case O2_EXPR:
-			e->outputExpression(1) = text;
+			e->setOutputExpression(1, text);
 			break;
 	}
 	if (m_wave_expr)
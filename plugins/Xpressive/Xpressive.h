@@ -28,6 +28,9 @@
 
 
 #include <QTextEdit>
+#include <array>
+#include <atomic>
+#include <mutex>
 
 #include "AutomatableModel.h"
 #include "Graph.h"
@@ -64,6 +67,7 @@ class Xpressive : public Instrument
 	Q_OBJECT
 public:
 	Xpressive(InstrumentTrack* instrument_track );
+	~Xpressive() override;
 
 	void playNote(NotePlayHandle* nph,
 						SampleFrame* working_buffer ) override;
@@ -88,7 +92,8 @@ public:
 	graphModel& rawgraphW3() { return m_rawgraphW3; }
 	IntModel& selectedGraph() { return m_selectedGraph; }
 	QByteArray& wavesExpression(int i) { return m_wavesExpression[i]; }
-	QByteArray& outputExpression(int i) { return m_outputExpression[i]; }
+	const QByteArray& outputExpression(int i) const { return m_outputExpression[i]; }
+	void setOutputExpression(int i, const QByteArray& expression);
 
 	FloatModel& parameterA1() { return m_parameterA1; }
 	FloatModel& parameterA2() { return m_parameterA2; }
@@ -110,9 +115,24 @@ public:
 protected:
 	
 protected slots:
-
+	//! Discard the compiled synths after the expressions or their inputs changed
+	void invalidateSynths();
 
 private:
+	//! Takes a synth compiled from the current expressions out of the pool. Called on the audio threads, which only
+	//! compile a synth themselves if more than Polyphony notes play at once.
+	ExprSynth* acquireSynth();
+	//! Puts @p synth back into the pool for the next note, unless it is outdated or the pool is full
+	void releaseSynth(ExprSynth* synth);
+	ExprSynth* createSynth();
+	//! Fill the pool, so that the audio threads don't have to compile. Only called on the main thread, which is also
+	//! the one changing the interpolation flags it applies.
+	void precompileSynths();
+
+	//! Notes that can play at once without compiling a synth on the audio threads
+	static constexpr auto Polyphony = std::size_t{16};
+
+
 	graphModel  m_graphO1;
 	graphModel  m_graphO2;
 	graphModel  m_graphW1;
@@ -140,7 +160,12 @@ private:
 	WaveSample m_W1, m_W2, m_W3;
 
 	BoolModel m_exprValid;
-	
+
+	std::array<std::atomic<ExprSynth*>, Polyphony> m_synthPool = {};
+	//! Increased whenever the synths need to be compiled again
+	std::atomic<int> m_synthGeneration = 0;
+	//! Guards m_outputExpression against changes while a synth is compiled from it
+	std::mutex m_expressionMutex;
 } ;
 
 namespace gui
@@ -29,6 +29,7 @@
 #include "AudioDevice.h"
 #include "AudioEngine.h"
 #include "EffectChain.h"
+#include "FrozenAudio.h"
 #include "Mixer.h"
 #include "Engine.h"
 #include "MixHelpers.h"
@@ -48,10 +49,13 @@ AudioBusHandle::AudioBusHandle(const QString& name, bool hasEffectChain,
 	m_effects(hasEffectChain ? new EffectChain(nullptr) : nullptr),
 	m_volumeModel(volumeModel),
 	m_panningModel(panningModel),
-	m_mutedModel(mutedModel)
+	m_mutedModel(mutedModel),
+	m_profilerSource(JobProfiler::SourceType::AudioBus, [this] { return m_name; }),
+	m_playHandlesProfilerSource(JobProfiler::SourceType::PlayHandles, [this] { return m_name; })
 {
+	if (m_effects) { m_effects->setProfilerOwner(m_profilerSource.id()); }
+
 	Engine::audioEngine()->addAudioBusHandle(this);
-	setExtOutputEnabled(true);
 }
 
 
@@ -108,12 +112,27 @@ bool AudioBusHandle::processEffects()
 
 void AudioBusHandle::doProcessing()
 {
+	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+
 	if (m_mutedModel && m_mutedModel->value())
 	{
+		// The audio device may read the buffer of a muted handle as well
+		if (m_extOutputEnabled) { zeroSampleFrames(m_buffer, fpp); }
 		return;
 	}
 
-	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+	if (m_frozenAudio && FrozenAudio::isSongPlaying())
+	{
+		// Whatever the play handles rendered is already part of the frozen audio
+		for (PlayHandle* ph : m_playHandles)
+		{
+			if (ph->buffer()) { ph->releaseBuffer(); }
+		}
+
+		m_frozenAudio->read(m_buffer, fpp, FrozenAudio::songPosition());
+		Engine::mixer()->mixToChannel(m_buffer, m_nextMixerChannel);
+		return;
+	}
 
 	// clear the buffer
 	zeroSampleFrames(m_buffer, fpp);
@@ -225,6 +244,14 @@ void AudioBusHandle::doProcessing()
 
 	// handle effects
 	const bool anyOutputAfterEffects = processEffects();
+
+	// The buffer must hold the output of this period if anything besides the mixer reads it
+	if ((m_freezeCapture || m_extOutputEnabled) && !anyOutputAfterEffects && !m_bufferUsage)
+	{
+		zeroSampleFrames(m_buffer, fpp);
+	}
+	if (m_freezeCapture) { m_freezeCapture->write(m_buffer, fpp, FrozenAudio::songPosition()); }
+
 	if (anyOutputAfterEffects || m_bufferUsage)
 	{
 		Engine::mixer()->mixToChannel(m_buffer, m_nextMixerChannel);	// send output to mixer
@@ -23,6 +23,8 @@
  */
 
 #include "AudioEngine.h"
+
+#include <algorithm>
 #include <iostream>
 
 #include "MixHelpers.h"
@@ -37,6 +39,9 @@
 #include "EnvelopeAndLfoParameters.h"
 #include "NotePlayHandle.h"
 #include "ConfigManager.h"
+#include "LocklessRingBuffer.h"
+#include "SampleRecorder.h"
+#include "TraceRecorder.h"
 
 // platform-specific audio-interface-classes
 #include "AudioAlsa.h"
@@ -67,6 +72,11 @@ namespace lmms
 using LocklessListElement = LocklessList<PlayHandle*>::Element;
 
 static thread_local bool s_renderingThread = false;
+//! How often the calling thread has requested a change in model without being done with it
+static thread_local int s_changeDepth = 0;
+
+//! Recorded frames that can be queued between two periods
+constexpr auto InputQueueFrames = std::size_t{DEFAULT_BUFFER_SIZE * 100};
 
 
 
@@ -74,9 +84,15 @@ static thread_local bool s_renderingThread = false;
 AudioEngine::AudioEngine( bool renderOnly ) :
 	m_renderOnly( renderOnly ),
 	m_framesPerPeriod( DEFAULT_BUFFER_SIZE ),
+	m_matchDevicePeriod(!renderOnly && ConfigManager::inst()->value("audioengine", "matchdeviceperiod").toInt()),
+	m_matchesDevicePeriod(false),
+	m_resampleSamples(!renderOnly && ConfigManager::inst()->value("audioengine", "resamplesamples").toInt()),
 	m_baseSampleRate(std::max(ConfigManager::inst()->value("audioengine", "samplerate").toInt(), SUPPORTED_SAMPLERATES.front())),
-	m_inputBufferRead( 0 ),
-	m_inputBufferWrite( 1 ),
+	m_inputQueue(std::make_unique<LocklessRingBuffer<SampleFrame>>(InputQueueFrames)),
+	m_inputReader(std::make_unique<LocklessRingBufferReader<SampleFrame>>(*m_inputQueue)),
+	m_inputBuffer(InputQueueFrames),
+	m_inputBufferFrames(0),
+	m_sampleRecorder(std::make_unique<SampleRecorder>()),
 	m_outputBufferRead(nullptr),
 	m_outputBufferWrite(nullptr),
 	m_workers(),
@@ -89,14 +105,6 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_profiler(),
 	m_clearSignal(false)
 {
-	for( int i = 0; i < 2; ++i )
-	{
-		m_inputBufferFrames[i] = 0;
-		m_inputBufferSize[i] = DEFAULT_BUFFER_SIZE * 100;
-		m_inputBuffer[i] = new SampleFrame[ DEFAULT_BUFFER_SIZE * 100 ];
-		zeroSampleFrames(m_inputBuffer[i], m_inputBufferSize[i]);
-	}
-
 	// determine FIFO size and number of frames per period
 	int fifoSize = 1;
 
@@ -174,28 +182,20 @@ AudioEngine::~AudioEngine()
 
 	delete m_midiClient;
 	delete m_audioDev;
-
-
-	for (const auto& input : m_inputBuffer)
-	{
-		delete[] input;
-	}
 }
 
 
 
 
-void AudioEngine::initDevices()
+void AudioEngine::initAudioDevice()
 {
 	bool success_ful = false;
 	if( m_renderOnly ) {
 		m_audioDev = new AudioDummy( success_ful, this );
 		m_audioDevName = AudioDummy::name();
-		m_midiClient = new MidiDummy;
-		m_midiClientName = MidiDummy::name();
 	} else {
 		m_audioDev = tryAudioDevices();
-		m_midiClient = tryMidiClients();
+		if (m_matchDevicePeriod) { adoptDevicePeriod(); }
 	}
 	// Loading audio device may have changed the sample rate
 	emit sampleRateChanged();
@@ -204,9 +204,65 @@ void AudioEngine::initDevices()
 
 
 
+void AudioEngine::initMidiClient()
+{
+	if( m_renderOnly ) {
+		m_midiClient = new MidiDummy;
+		m_midiClientName = MidiDummy::name();
+	} else {
+		m_midiClient = tryMidiClients();
+	}
+}
+
+
+
+
+void AudioEngine::adoptDevicePeriod()
+{
+	const auto callbackFrames = m_audioDev->callbackFrames();
+	if (callbackFrames == 0) { return; }
+
+	// Plugins never see more than DEFAULT_BUFFER_SIZE frames at once, so larger callbacks are rendered in several
+	// periods, but all of them within the callback
+	m_framesPerPeriod = std::clamp(callbackFrames, MINIMUM_BUFFER_SIZE, DEFAULT_BUFFER_SIZE);
+	m_matchesDevicePeriod = true;
+
+	delete m_fifo;
+	m_fifo = new Fifo(1);
+
+	BufferManager::init(m_framesPerPeriod);
+	m_outputBufferRead = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
+	m_outputBufferWrite = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
+}
+
+
+
+
+AudioEngine::LatencyReport AudioEngine::latencyReport() const
+{
+	auto report = LatencyReport{};
+	report.sampleRate = outputSampleRate();
+	if (m_audioDev == nullptr) { return report; }
+
+	// Devices without a fixed callback size are fed a period at a time
+	const auto callbackFrames = m_audioDev->callbackFrames() > 0 ? m_audioDev->callbackFrames() : m_framesPerPeriod;
+
+	report.capture = m_audioDev->captureLatency();
+	report.input = callbackFrames;
+	report.period = m_framesPerPeriod > callbackFrames ? m_framesPerPeriod - callbackFrames : 0;
+	report.fifo = hasFifoWriter() ? static_cast<f_cnt_t>(m_fifo->size()) * m_framesPerPeriod : 0;
+	report.output = callbackFrames;
+	report.playback = m_audioDev->playbackLatency();
+	return report;
+}
+
+
+
+
 void AudioEngine::startProcessing(bool needsFifo)
 {
-	if (needsFifo)
+	// Rendering ahead would add the very period of latency that matching the device period is meant to avoid
+	if (needsFifo && m_audioDev->allowsFifo() && !m_matchesDevicePeriod)
 	{
 		m_fifoWriter = new fifoWriter( this, m_fifo );
 		m_fifoWriter->start( QThread::HighPriority );
@@ -249,31 +305,9 @@ bool AudioEngine::criticalXRuns() const
 
 
 
-void AudioEngine::pushInputFrames( SampleFrame* _ab, const f_cnt_t _frames )
+void AudioEngine::pushInputFrames(const SampleFrame* frames, f_cnt_t count)
 {
-	requestChangeInModel();
-
-	f_cnt_t frames = m_inputBufferFrames[ m_inputBufferWrite ];
-	auto size = m_inputBufferSize[m_inputBufferWrite];
-	SampleFrame* buf = m_inputBuffer[ m_inputBufferWrite ];
-
-	if( frames + _frames > size )
-	{
-		size = std::max(size * 2, frames + _frames);
-		auto ab = new SampleFrame[size];
-		memcpy( ab, buf, frames * sizeof( SampleFrame ) );
-		delete [] buf;
-
-		m_inputBufferSize[ m_inputBufferWrite ] = size;
-		m_inputBuffer[ m_inputBufferWrite ] = ab;
-
-		buf = ab;
-	}
-
-	memcpy( &buf[ frames ], _ab, _frames * sizeof( SampleFrame ) );
-	m_inputBufferFrames[ m_inputBufferWrite ] += _frames;
-
-	doneChangeInModel();
+	m_inputQueue->write(frames, count);
 }
 
 
@@ -319,6 +353,9 @@ void AudioEngine::renderStageNoteSetup()
 	// create play-handles for new notes, samples etc.
 	Engine::getSong()->processNextBuffer();
 
+	// play the notes received from MIDI devices during the last period
+	m_midiClient->processQueuedInEvents(outputSampleRate(), m_framesPerPeriod);
+
 	// add all play-handles that have to be added
 	for( LocklessListElement * e = m_newPlayHandles.popList(); e; )
 	{
@@ -327,6 +364,11 @@ void AudioEngine::renderStageNoteSetup()
 		m_newPlayHandles.free( e );
 		e = next;
 	}
+
+	// evaluate all controllers and the models they control once, so that the instruments and effects running in
+	// parallel only read their value buffers
+	Controller::updateValueBuffers();
+	AutomatableModel::updateControlledValueBuffers();
 }
 
 
@@ -387,7 +429,7 @@ void AudioEngine::renderStageMix()
 
 	MixHelpers::multiply(m_outputBufferWrite.get(), m_masterGain, m_framesPerPeriod);
 
-	emit nextAudioBuffer(m_outputBufferRead.get());
+	emit nextAudioBuffer(m_outputBufferWrite.get());
 
 	// and trigger LFOs
 	EnvelopeAndLfoParameters::instances()->trigger();
@@ -401,9 +443,19 @@ const SampleFrame* AudioEngine::renderNextBuffer()
 {
 	const auto lock = std::lock_guard{m_changeMutex};
 
+	// Whichever thread renders, be it the FIFO writer or the callback of the audio device
+	thread_local auto t_named = false;
+	if (!t_named)
+	{
+		TraceRecorder::setThreadName("Audio engine");
+		t_named = true;
+	}
+	const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Engine, "Period"};
+
 	m_profiler.startPeriod();
 	s_renderingThread = true;
 
+	EnvelopeAndLfoParameters::instances()->startPeriod();
 	renderStageNoteSetup();     // STAGE 0: clear old play handles and buffers, setup new play handles
 	renderStageInstruments();   // STAGE 1: run and render all play handles
 	renderStageEffects();       // STAGE 2: process effects of all instrument- and sampletracks
@@ -412,7 +464,8 @@ const SampleFrame* AudioEngine::renderNextBuffer()
 	s_renderingThread = false;
 	m_profiler.finishPeriod(outputSampleRate(), m_framesPerPeriod);
 
-	return m_outputBufferRead.get();
+	// The buffer stays untouched while the next period is rendered
+	return m_outputBufferWrite.get();
 }
 
 
@@ -420,9 +473,13 @@ const SampleFrame* AudioEngine::renderNextBuffer()
 
 void AudioEngine::swapBuffers()
 {
-	m_inputBufferWrite = (m_inputBufferWrite + 1) % 2;
-	m_inputBufferRead = (m_inputBufferRead + 1) % 2;
-	m_inputBufferFrames[m_inputBufferWrite] = 0;
+	// Everything recorded since the previous period
+	const auto input = m_inputReader->read_max(m_inputBuffer.size());
+	for (std::size_t i = 0; i < input.size(); ++i)
+	{
+		m_inputBuffer[i] = input[i];
+	}
+	m_inputBufferFrames = input.size();
 
 	std::swap(m_outputBufferRead, m_outputBufferWrite);
 	zeroSampleFrames(m_outputBufferWrite.get(), m_framesPerPeriod);
@@ -652,12 +709,16 @@ void AudioEngine::requestChangeInModel()
 {
 	if (s_renderingThread) { return; }
 	m_changeMutex.lock();
+	++s_changeDepth;
 }
 
 void AudioEngine::doneChangeInModel()
 {
 	if (s_renderingThread) { return; }
 	m_changeMutex.unlock();
+
+	// The device may have deferred work that must not happen while the engine is locked
+	if (--s_changeDepth == 0 && m_audioDev != nullptr) { m_audioDev->applyPortChanges(); }
 }
 
 bool AudioEngine::isAudioDevNameValid(QString name)
@@ -51,6 +51,11 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPe
 	const auto newCpuLoad = 100.f * periodElapsed / timeLimit;
 	m_cpuLoad = newCpuLoad * 0.1f + m_cpuLoad * 0.9f;
 
+	if (periodElapsed > timeLimit)
+	{
+		TraceRecorder::instance().instant(TraceRecorder::Category::XRun, "Period deadline missed");
+	}
+
 	// Compute detailed load analysis. Can use stronger averaging to get more stable readout.
 	for (std::size_t i = 0; i < DetailCount; i++)
 	{
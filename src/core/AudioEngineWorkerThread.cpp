@@ -31,6 +31,7 @@
 #include "denormals.h"
 #include "AudioEngine.h"
 #include "ThreadableJob.h"
+#include "TraceRecorder.h"
 
 #if __SSE__
 #include <xmmintrin.h>
@@ -167,6 +168,7 @@ void AudioEngineWorkerThread::startAndWaitForJobs()
 void AudioEngineWorkerThread::run()
 {
 	disable_denormals();
+	TraceRecorder::setThreadName("Audio worker");
 
 	QMutex m;
 	while( m_quit == false )
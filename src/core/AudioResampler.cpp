@@ -24,8 +24,18 @@
 
 #include "AudioResampler.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numbers>
 #include <samplerate.h>
 #include <stdexcept>
+#include <vector>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "lmms_constants.h"
 
 namespace lmms {
 
@@ -39,6 +49,7 @@ constexpr auto converterType(AudioResampler::Mode mode) -> int
 		return SRC_ZERO_ORDER_HOLD;
 	case AudioResampler::Mode::Linear:
 		return SRC_LINEAR;
+	case AudioResampler::Mode::Cubic: // libsamplerate has no cubic interpolation, so use the next better mode
 	case AudioResampler::Mode::SincFastest:
 		return SRC_SINC_FASTEST;
 	case AudioResampler::Mode::SincMedium:
@@ -49,14 +60,271 @@ constexpr auto converterType(AudioResampler::Mode mode) -> int
 		throw std::invalid_argument{"Invalid interpolation mode"};
 	}
 }
+
+//! Whether the built-in kernels are used rather than libsamplerate
+constexpr auto usesKernels(AudioResampler::Mode mode, ch_cnt_t channels) -> bool
+{
+	switch (mode)
+	{
+	case AudioResampler::Mode::ZOH:
+	case AudioResampler::Mode::Linear:
+	case AudioResampler::Mode::Cubic:
+	case AudioResampler::Mode::SincFastest:
+		return channels == DEFAULT_CHANNELS;
+	default:
+		return false;
+	}
+}
+
+//! Input frames copied into the scratch buffer at once
+constexpr auto ChunkFrames = f_cnt_t{256};
+
+constexpr auto SincTaps = 32;
+constexpr auto SincPhases = 64;
+//! Banks for downsampling by up to three octaves, a quarter octave apart
+constexpr auto SincBanksPerOctave = 4;
+constexpr auto SincBanks = 3 * SincBanksPerOctave + 1;
+//! Passband of the filters relative to the lower Nyquist frequency
+constexpr auto SincCutoff = 0.85;
+constexpr auto KaiserBeta = 7.0;
+
+//! Zeroth order modified Bessel function of the first kind
+auto besselI0(double x) -> double
+{
+	auto sum = 1.0;
+	auto term = 1.0;
+	for (auto k = 1; term > 1e-12 * sum; ++k)
+	{
+		const auto factor = x / (2 * k);
+		term *= factor * factor;
+		sum += term;
+	}
+	return sum;
+}
+
+//! The windowed-sinc filter bank for reading @p step input frames per output frame. Each bank holds SincPhases + 1
+//! phases of SincTaps coefficients, each of which is stored twice to line up with interleaved stereo frames.
+auto sincBank(double step) -> const float*
+{
+	static const auto s_banks = [] {
+		auto banks = std::array<std::vector<float>, SincBanks>{};
+		for (auto b = 0; b < SincBanks; ++b)
+		{
+			// Lower the cutoff when downsampling, so that nothing above the new Nyquist frequency aliases
+			const auto cutoff = SincCutoff / std::exp2(static_cast<double>(b) / SincBanksPerOctave);
+
+			auto& bank = banks[b];
+			bank.resize((SincPhases + 1) * SincTaps * 2);
+			for (auto phase = 0; phase <= SincPhases; ++phase)
+			{
+				auto coeffs = std::array<double, SincTaps>{};
+				auto sum = 0.0;
+				for (auto tap = 0; tap < SincTaps; ++tap)
+				{
+					const auto x = tap - (SincTaps / 2 - 1) - static_cast<double>(phase) / SincPhases;
+					const auto r = x / (SincTaps / 2);
+					const auto arg = std::numbers::pi * cutoff * x;
+					const auto sinc = arg == 0 ? 1.0 : std::sin(arg) / arg;
+					const auto window = besselI0(KaiserBeta * std::sqrt(std::max(1 - r * r, 0.0)))
+						/ besselI0(KaiserBeta);
+					coeffs[tap] = sinc * window;
+					sum += coeffs[tap];
+				}
+
+				// Normalize to unity gain at DC
+				for (auto tap = 0; tap < SincTaps; ++tap)
+				{
+					const auto index = (phase * SincTaps + tap) * 2;
+					bank[index] = bank[index + 1] = static_cast<float>(coeffs[tap] / sum);
+				}
+			}
+		}
+		return banks;
+	}();
+
+	const auto bank = step > 1 ? static_cast<int>(std::ceil(SincBanksPerOctave * std::log2(step) - 1e-6)) : 0;
+	return s_banks[std::min(bank, SincBanks - 1)].data();
+}
+
+// The kernels render the stereo output frame at position @p frac after @p frame, reading Before frames before and
+// After frames after it
+
+struct ZohKernel
+{
+	static constexpr auto Before = f_cnt_t{0};
+	static constexpr auto After = f_cnt_t{0};
+
+	void operator()(const float* frame, float, float* out) const
+	{
+		out[0] = frame[0];
+		out[1] = frame[1];
+	}
+};
+
+struct LinearKernel
+{
+	static constexpr auto Before = f_cnt_t{0};
+	static constexpr auto After = f_cnt_t{1};
+
+	void operator()(const float* frame, float frac, float* out) const
+	{
+#ifdef __SSE__
+		const auto frames = _mm_loadu_ps(frame);
+		const auto next = _mm_movehl_ps(frames, frames);
+		_mm_storel_pi(reinterpret_cast<__m64*>(out),
+			_mm_add_ps(frames, _mm_mul_ps(_mm_set1_ps(frac), _mm_sub_ps(next, frames))));
+#else
+		out[0] = frame[0] + frac * (frame[2] - frame[0]);
+		out[1] = frame[1] + frac * (frame[3] - frame[1]);
+#endif
+	}
+};
+
+struct CubicKernel
+{
+	static constexpr auto Before = f_cnt_t{1};
+	static constexpr auto After = f_cnt_t{2};
+
+	void operator()(const float* frame, float frac, float* out) const
+	{
+#ifdef __SSE__
+		const auto first = _mm_loadu_ps(frame - 2);
+		const auto second = _mm_loadu_ps(frame + 2);
+		const auto xm1 = first;
+		const auto x0 = _mm_movehl_ps(first, first);
+		const auto x1 = second;
+		const auto x2 = _mm_movehl_ps(second, second);
+
+		const auto half = _mm_set1_ps(0.5f);
+		const auto c1 = _mm_mul_ps(half, _mm_sub_ps(x1, xm1));
+		const auto c2 = _mm_sub_ps(_mm_add_ps(xm1, _mm_add_ps(x1, x1)),
+			_mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.5f), x0), _mm_mul_ps(half, x2)));
+		const auto c3 = _mm_add_ps(_mm_mul_ps(half, _mm_sub_ps(x2, xm1)),
+			_mm_mul_ps(_mm_set1_ps(1.5f), _mm_sub_ps(x0, x1)));
+
+		const auto t = _mm_set1_ps(frac);
+		const auto result = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3, t), c2), t), c1);
+		_mm_storel_pi(reinterpret_cast<__m64*>(out), _mm_add_ps(_mm_mul_ps(result, t), x0));
+#else
+		for (auto ch = 0; ch < 2; ++ch)
+		{
+			const auto xm1 = frame[ch - 2];
+			const auto x0 = frame[ch];
+			const auto x1 = frame[ch + 2];
+			const auto x2 = frame[ch + 4];
+			const auto c1 = 0.5f * (x1 - xm1);
+			const auto c2 = xm1 - 2.5f * x0 + 2 * x1 - 0.5f * x2;
+			const auto c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+			out[ch] = ((c3 * frac + c2) * frac + c1) * frac + x0;
+		}
+#endif
+	}
+};
+
+struct SincKernel
+{
+	static constexpr auto Before = f_cnt_t{SincTaps / 2 - 1};
+	static constexpr auto After = f_cnt_t{SincTaps / 2};
+
+	const float* bank;
+
+	void operator()(const float* frame, float frac, float* out) const
+	{
+		// Interpolate between the two nearest phases of the filter
+		const auto phase = frac * SincPhases;
+		const auto index = std::min(static_cast<int>(phase), SincPhases - 1);
+		const auto t = phase - index;
+		const auto a = bank + index * SincTaps * 2;
+		const auto b = a + SincTaps * 2;
+		const auto x = frame - Before * 2;
+
+#ifdef __SSE__
+		const auto weight = _mm_set1_ps(t);
+		auto sum = _mm_setzero_ps();
+		for (auto i = 0; i < SincTaps * 2; i += 4)
+		{
+			const auto coeffs = _mm_loadu_ps(a + i);
+			const auto interpolated = _mm_add_ps(coeffs, _mm_mul_ps(weight, _mm_sub_ps(_mm_loadu_ps(b + i), coeffs)));
+			sum = _mm_add_ps(sum, _mm_mul_ps(interpolated, _mm_loadu_ps(x + i)));
+		}
+		_mm_storel_pi(reinterpret_cast<__m64*>(out), _mm_add_ps(sum, _mm_movehl_ps(sum, sum)));
+#else
+		auto left = 0.f;
+		auto right = 0.f;
+		for (auto i = 0; i < SincTaps * 2; i += 2)
+		{
+			const auto coeff = a[i] + t * (b[i] - a[i]);
+			left += coeff * x[i];
+			right += coeff * x[i + 1];
+		}
+		out[0] = left;
+		out[1] = right;
+#endif
+	}
+};
+
+//! Call @p func with the kernel for @p mode, reading @p step input frames per output frame
+template<class Func>
+decltype(auto) withKernel(AudioResampler::Mode mode, double step, Func&& func)
+{
+	switch (mode)
+	{
+	case AudioResampler::Mode::ZOH:
+		return func(ZohKernel{});
+	case AudioResampler::Mode::Linear:
+		return func(LinearKernel{});
+	case AudioResampler::Mode::Cubic:
+		return func(CubicKernel{});
+	default:
+		return func(SincKernel{sincBank(step)});
+	}
+}
+
+//! Render up to @p count frames into @p out as long as @p kernel finds all the frames it needs among the
+//! @p available frames, starting at @p position and moving on by @p step. Returns the number of frames rendered.
+template<class Kernel>
+auto resample(const Kernel& kernel, const float* frames, f_cnt_t available, double& position, double step, float* out,
+	f_cnt_t count) -> f_cnt_t
+{
+	// Without a change of rate, the output frames are the input frames
+	if (step == 1.0 && position == std::floor(position))
+	{
+		const auto index = static_cast<f_cnt_t>(position);
+		if (index + Kernel::After >= available) { return 0; }
+
+		const auto copied = std::min(count, available - Kernel::After - index);
+		std::copy_n(frames + index * 2, copied * 2, out);
+		position += copied;
+		return copied;
+	}
+
+	auto generated = f_cnt_t{0};
+	for (; generated < count; ++generated)
+	{
+		const auto index = static_cast<f_cnt_t>(position);
+		if (index + Kernel::After >= available) { break; }
+
+		kernel(frames + index * 2, static_cast<float>(position - index), out + generated * 2);
+		position += step;
+	}
+	return generated;
+}
+
 } // namespace
 
 AudioResampler::AudioResampler(Mode mode, ch_cnt_t channels)
-	: m_state{src_new(converterType(mode), channels, &m_error)}
-	, m_mode{mode}
+	: m_mode{mode}
 	, m_channels{channels}
 {
 	if (channels <= 0) { throw std::logic_error{"Invalid channel count"}; }
+
+	if (usesKernels(mode, channels))
+	{
+		reset();
+		return;
+	}
+
+	m_state.reset(src_new(converterType(mode), channels, &m_error));
 	if (!m_state) { throw std::runtime_error{src_strerror(m_error)}; }
 }
 
@@ -67,6 +335,8 @@ auto AudioResampler::process(InterleavedBufferView<const float> input, Interleav
 		throw std::invalid_argument{"Invalid channel count"};
 	}
 
+	if (!m_state) { return processKernel(input, output); }
+
 	auto data = SRC_DATA{};
 
 	data.data_in = input.data();
@@ -86,8 +356,55 @@ auto AudioResampler::process(InterleavedBufferView<const float> input, Interleav
 	return {static_cast<f_cnt_t>(data.input_frames_used), static_cast<f_cnt_t>(data.output_frames_gen)};
 }
 
+auto AudioResampler::processKernel(InterleavedBufferView<const float> input, InterleavedBufferView<float> output)
+	-> Result
+{
+	const auto step = 1.0 / m_ratio;
+	return withKernel(m_mode, step, [&](const auto& kernel) -> Result {
+		using Kernel = std::decay_t<decltype(kernel)>;
+		constexpr auto HistoryFrames = Kernel::Before + Kernel::After + 1;
+		static_assert(HistoryFrames <= MaxHistoryFrames);
+
+		// The history followed by the next chunk of input, so that the kernels can read across the boundary
+		std::array<float, (MaxHistoryFrames + ChunkFrames) * 2> frames;
+
+		auto used = f_cnt_t{0};
+		auto generated = f_cnt_t{0};
+		while (generated < output.frames())
+		{
+			const auto chunk = std::min(input.frames() - used, ChunkFrames);
+			std::copy_n(m_history.data(), HistoryFrames * 2, frames.data());
+			std::copy_n(input.data() + used * 2, chunk * 2, frames.data() + HistoryFrames * 2);
+
+			generated += resample(kernel, frames.data(), HistoryFrames + chunk, m_position, step,
+				output.data() + generated * 2, output.frames() - generated);
+
+			// Consume the input up to the first frame the next output frame needs, keeping the frames after it
+			const auto consumed = std::min(chunk, static_cast<f_cnt_t>(m_position) - Kernel::Before);
+			std::copy_n(frames.data() + consumed * 2, HistoryFrames * 2, m_history.data());
+			m_position -= consumed;
+			used += consumed;
+
+			if (consumed == 0) { break; }
+		}
+
+		return {used, generated};
+	});
+}
+
 void AudioResampler::reset()
 {
+	if (!m_state)
+	{
+		// Start as if silence came before the input, with the first output frame on the first input frame
+		m_history.fill(0.f);
+		m_position = withKernel(m_mode, 1.0, [](const auto& kernel) {
+			using Kernel = std::decay_t<decltype(kernel)>;
+			return static_cast<double>(Kernel::Before + Kernel::After + 1);
+		});
+		return;
+	}
+
 	if ((m_error = src_reset(static_cast<SRC_STATE*>(m_state.get()))))
 	{
 		throw std::runtime_error{src_strerror(m_error)};
@@ -26,6 +26,10 @@
 
 #include <QRegularExpression>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "lmms_math.h"
 
 #include "AudioEngine.h"
@@ -39,6 +43,33 @@ namespace lmms
 {
 
 long AutomatableModel::s_periodCounter = 0;
+std::vector<AutomatableModel*> AutomatableModel::s_controlledModels;
+
+
+namespace
+{
+
+//! Write @p offset plus @p scale times @p src to @p dst
+void scaleLinear(const float* src, float* dst, float offset, float scale, int count)
+{
+	auto i = 0;
+
+#ifdef __SSE__
+	const auto offsets = _mm_set1_ps(offset);
+	const auto scales = _mm_set1_ps(scale);
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_ps(dst + i, _mm_add_ps(offsets, _mm_mul_ps(scales, _mm_loadu_ps(src + i))));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		dst[i] = offset + scale * src[i];
+	}
+}
+
+} // namespace
 
 
 
@@ -76,6 +107,10 @@ AutomatableModel::~AutomatableModel()
 
 	if (m_controllerConnection)
 	{
+		const auto guard = Engine::audioEngine()
+			? Engine::audioEngine()->requestChangesGuard()
+			: AudioEngine::RequestChangesGuard{};
+		std::erase(s_controlledModels, this);
 		delete m_controllerConnection;
 	}
 
@@ -291,6 +326,36 @@ void AutomatableModel::loadSettings( const QDomElement& element, const QString&
 
 
 
+class AutomatableModel::ValueJournalEntry : public JournalEntry
+{
+public:
+	explicit ValueJournalEntry(float value) : m_value(value) {}
+
+	void restore(JournallingObject& object) override
+	{
+		auto& model = static_cast<AutomatableModel&>(object);
+		const auto current = model.m_value;
+		model.setValue(m_value);
+		m_value = current;
+	}
+
+	std::size_t memoryUsage() const override { return sizeof(*this); }
+
+private:
+	float m_value;
+};
+
+
+
+
+std::unique_ptr<JournalEntry> AutomatableModel::createJournalEntry()
+{
+	return std::make_unique<ValueJournalEntry>(m_value);
+}
+
+
+
+
 void AutomatableModel::setValue(const float value, const bool isAutomated)
 {
 	if (fittedValue(value) == m_value)
@@ -497,7 +562,12 @@ void AutomatableModel::unlink()
 
 void AutomatableModel::setControllerConnection( ControllerConnection* c )
 {
-	m_controllerConnection = c;
+	{
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		std::erase(s_controlledModels, this);
+		if (c) { s_controlledModels.push_back(this); }
+		m_controllerConnection = c;
+	}
 	if( c )
 	{
 		QObject::connect( m_controllerConnection, SIGNAL(valueChanged()),
@@ -539,20 +609,29 @@ float AutomatableModel::controllerValue( int frameOffset ) const
 
 ValueBuffer * AutomatableModel::valueBuffer()
 {
+	// Models with a controller have usually been updated by the audio engine already, in which case this is all
+	// that instruments and effects need to do
+	if (m_lastUpdatedPeriod.load(std::memory_order_acquire) == s_periodCounter)
+	{
+		return m_hasSampleExactData ? &m_valueBuffer : nullptr;
+	}
+
 	QMutexLocker m( &m_valueBufferMutex );
 	// if we've already calculated the valuebuffer this period, return the cached buffer
-	if( m_lastUpdatedPeriod == s_periodCounter )
+	if (m_lastUpdatedPeriod.load(std::memory_order_relaxed) == s_periodCounter)
 	{
 		return m_hasSampleExactData
 			? &m_valueBuffer
 			: nullptr;
 	}
 
-	float val = m_value; // make sure our m_value doesn't change midway
+	const auto updated = [this](bool hasSampleExactData) {
+		m_hasSampleExactData = hasSampleExactData;
+		m_lastUpdatedPeriod.store(s_periodCounter, std::memory_order_release);
+		return hasSampleExactData ? &m_valueBuffer : nullptr;
+	};
 
-	// TODO
-	// Let the Controller set the value of connected Models,
-	// instead of each Model checking the Controller value every time.
+	float val = m_value; // make sure our m_value doesn't change midway
 
 	// Get value buffer from our controller
 	if (m_controllerConnection && m_useControllerValue && m_controllerConnection->getController()->isSampleExact())
@@ -565,10 +644,7 @@ ValueBuffer * AutomatableModel::valueBuffer()
 			switch( m_scaleType )
 			{
 			case ScaleType::Linear:
-				for( int i = 0; i < m_valueBuffer.length(); i++ )
-				{
-					nvalues[i] = minValue<float>() + ( range() * values[i] );
-				}
+				scaleLinear(values, nvalues, minValue<float>(), range(), m_valueBuffer.length());
 				break;
 			case ScaleType::Logarithmic:
 				for( int i = 0; i < m_valueBuffer.length(); i++ )
@@ -581,9 +657,7 @@ ValueBuffer * AutomatableModel::valueBuffer()
 					"lacks implementation for a scale type");
 				break;
 			}
-			m_lastUpdatedPeriod = s_periodCounter;
-			m_hasSampleExactData = true;
-			return &m_valueBuffer;
+			return updated(true);
 		}
 	}
 
@@ -602,9 +676,7 @@ ValueBuffer * AutomatableModel::valueBuffer()
 					{
 						nvalues[i] = fittedValue(values[i]);
 					}
-					m_lastUpdatedPeriod = s_periodCounter;
-					m_hasSampleExactData = true;
-					return &m_valueBuffer;
+					return updated(true);
 				}
 		}
 	}
@@ -618,16 +690,23 @@ ValueBuffer * AutomatableModel::valueBuffer()
 	{
 		m_valueBuffer.interpolate(m_oldValue, val);
 		m_oldValue = val;
-		m_lastUpdatedPeriod = s_periodCounter;
-		m_hasSampleExactData = true;
-		return &m_valueBuffer;
+		return updated(true);
 	}
 
 	// if we have no sample-exact source for a ValueBuffer, return NULL to signify that no data is available at the moment
 	// in which case the recipient knows to use the static value() instead
-	m_lastUpdatedPeriod = s_periodCounter;
-	m_hasSampleExactData = false;
-	return nullptr;
+	return updated(false);
+}
+
+
+
+
+void AutomatableModel::updateControlledValueBuffers()
+{
+	for (const auto model : s_controlledModels)
+	{
+		model->valueBuffer();
+	}
 }
 
 
@@ -638,6 +717,10 @@ void AutomatableModel::unlinkControllerConnection()
 		m_controllerConnection->disconnect( this );
 	}
 
+	const auto guard = Engine::audioEngine()
+		? Engine::audioEngine()->requestChangesGuard()
+		: AudioEngine::RequestChangesGuard{};
+	std::erase(s_controlledModels, this);
 	m_controllerConnection = nullptr;
 }
 
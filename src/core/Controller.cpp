@@ -55,6 +55,7 @@ Controller::Controller( ControllerType _type, Model * _parent,
 {
 	if( _type != ControllerType::Dummy && _type != ControllerType::Midi )
 	{
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
 		s_controllers.push_back(this);
 		// Determine which name to use
 		for ( uint i=s_controllers.size(); ; i++ )
@@ -89,6 +90,7 @@ Controller::~Controller()
 	auto it = std::find(s_controllers.begin(), s_controllers.end(), this);
 	if (it != s_controllers.end())
 	{
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
 		s_controllers.erase(it);
 	}
 
@@ -154,6 +156,19 @@ float Controller::runningTime()
 
 
 
+void Controller::updateValueBuffers()
+{
+	for (Controller * controller : s_controllers)
+	{
+		if (controller->m_connectionCount > 0 && controller->m_bufferLastUpdated != s_periods)
+		{
+			controller->updateValueBuffer();
+		}
+	}
+}
+
+
+
 void Controller::triggerFrameCounter()
 {
 	for (Controller * controller : s_controllers)
@@ -47,9 +47,11 @@
 #include "LocaleHelper.h"
 #include "Note.h"
 #include "PluginFactory.h"
+#include "ProjectContainer.h"
 #include "ProjectVersion.h"
 #include "SongEditor.h"
 #include "TextFloat.h"
+#include "TraceRecorder.h"
 #include "Track.h"
 #include "PathUtil.h"
 #include "UpgradeExtendedNoteRange.h"
@@ -70,22 +72,37 @@ const DataFile::ResourcesMap DataFile::ELEMENTS_WITH_RESOURCES = {
 };
 
 // Vector with all the upgrade methods
-const std::vector<DataFile::UpgradeMethod> DataFile::UPGRADE_METHODS = {
-	&DataFile::upgrade_0_2_1_20070501   ,   &DataFile::upgrade_0_2_1_20070508,
-	&DataFile::upgrade_0_3_0_rc2        ,   &DataFile::upgrade_0_3_0,
-	&DataFile::upgrade_0_4_0_20080104   ,   &DataFile::upgrade_0_4_0_20080118,
-	&DataFile::upgrade_0_4_0_20080129   ,   &DataFile::upgrade_0_4_0_20080409,
-	&DataFile::upgrade_0_4_0_20080607   ,   &DataFile::upgrade_0_4_0_20080622,
-	&DataFile::upgrade_0_4_0_beta1      ,   &DataFile::upgrade_0_4_0_rc2,
-	&DataFile::upgrade_1_0_99           ,   &DataFile::upgrade_1_1_0,
-	&DataFile::upgrade_1_1_91           ,   &DataFile::upgrade_1_2_0_rc3,
-	&DataFile::upgrade_1_3_0            ,   &DataFile::upgrade_noHiddenClipNames,
-	&DataFile::upgrade_automationNodes  ,   &DataFile::upgrade_extendedNoteRange,
-	&DataFile::upgrade_defaultTripleOscillatorHQ,
-	&DataFile::upgrade_mixerRename      ,   &DataFile::upgrade_bbTcoRename,
-	&DataFile::upgrade_sampleAndHold    ,   &DataFile::upgrade_midiCCIndexing,
-	&DataFile::upgrade_loopsRename      ,   &DataFile::upgrade_noteTypes,
-	&DataFile::upgrade_fixCMTDelays     ,   &DataFile::upgrade_fixBassLoopsTypo,
+const std::vector<DataFile::Upgrade> DataFile::UPGRADE_METHODS = {
+	&DataFile::upgrade_0_2_1_20070501,
+	&DataFile::upgrade_0_2_1_20070508,
+	{{"arpandchords"}, &DataFile::upgrade_0_3_0_rc2},
+	{{"pluckedstringsynth", "lb303", "channelsettings"}, &DataFile::upgrade_0_3_0},
+	{{"fx"}, &DataFile::upgrade_0_4_0_20080104},
+	&DataFile::upgrade_0_4_0_20080118,
+	&DataFile::upgrade_0_4_0_20080129,
+	{{"note", "pattern", "bbtco", "sampletco", "time", "timeline"}, &DataFile::upgrade_0_4_0_20080409},
+	{{"midi"}, &DataFile::upgrade_0_4_0_20080607},
+	{{"automation-pattern", "bbtrack"}, &DataFile::upgrade_0_4_0_20080622},
+	&DataFile::upgrade_0_4_0_beta1,
+	{{"audiofileprocessor", "lb302"}, &DataFile::upgrade_0_4_0_rc2},
+	&DataFile::upgrade_1_0_99,
+	&DataFile::upgrade_1_1_0,
+	{{"audiofileprocessor", "attribute", "crossoevereqcontrols", "arpeggiator"}, &DataFile::upgrade_1_1_91},
+	&DataFile::upgrade_1_2_0_rc3,
+	&DataFile::upgrade_1_3_0,
+	&DataFile::upgrade_noHiddenClipNames,
+	&DataFile::upgrade_automationNodes,
+	&DataFile::upgrade_extendedNoteRange,
+	{{"tripleoscillator"}, &DataFile::upgrade_defaultTripleOscillatorHQ},
+	{{"fxmixer", "fxchannel", "instrumenttrack", "sampletrack"}, &DataFile::upgrade_mixerRename},
+	{{"automationpattern", "bbtco", "pattern", "sampletco", "bbtrack", "bbtrackcontainer", "track"},
+		&DataFile::upgrade_bbTcoRename},
+	{{"lfocontroller"}, &DataFile::upgrade_sampleAndHold},
+	{{"Midicontroller"}, &DataFile::upgrade_midiCCIndexing},
+	{resourceElementNames(), &DataFile::upgrade_loopsRename},
+	{{"note"}, &DataFile::upgrade_noteTypes},
+	&DataFile::upgrade_fixCMTDelays,
+	{resourceElementNames(), &DataFile::upgrade_fixBassLoopsTypo},
 	&DataFile::findProblematicLadspaPlugins,
 	&DataFile::upgrade_noHiddenAutomationTracks
 };
@@ -160,6 +177,8 @@ DataFile::DataFile( const QString & _fileName ) :
 	m_head(),
 	m_fileVersion( UPGRADE_METHODS.size() )
 {
+	const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Read file"};
+
 	QFile inFile( _fileName );
 	if( !inFile.open( QIODevice::ReadOnly ) )
 	{
@@ -177,6 +196,12 @@ DataFile::DataFile( const QString & _fileName ) :
 		return;
 	}
 
+	if (ProjectContainer::isContainer(inFile))
+	{
+		loadContainer(_fileName);
+		return;
+	}
+
 	loadData( inFile.readAll(), _fileName );
 }
 
@@ -202,7 +227,7 @@ bool DataFile::validate( QString extension )
 	switch( m_type )
 	{
 	case Type::SongProject:
-		if( extension == "mmp" || extension == "mmpz" )
+		if( extension == "mmp" || extension == "mmpz" || extension == "mmpb" )
 		{
 			return true;
 		}
@@ -226,7 +251,7 @@ bool DataFile::validate( QString extension )
 		}
 		break;
 	case Type::Unknown:
-		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" ||
+		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" || extension == "mmpb" ||
 				extension == "xpf" || extension == "xml" ||
 				( extension == "xiz" && ! getPluginFactory()->pluginSupportingExtension(extension).isNull()) ||
 				extension == "sf2" || extension == "sf3" || extension == "pat" || extension == "mid" ||
@@ -268,7 +293,8 @@ QString DataFile::nameWithExtension( const QString & _fn ) const
 		case Type::SongProject:
 			if( extension != "mmp" &&
 					extension != "mpt" &&
-					extension != "mmpz" )
+					extension != "mmpz" &&
+					extension != "mmpb" )
 			{
 				if( ConfigManager::inst()->value( "app",
 						"nommpz" ).toInt() == 0 )
@@ -306,6 +332,9 @@ void DataFile::write( QTextStream & _strm )
 		cleanMetaNodes( documentElement() );
 	}
 
+	// Samples embedded in a binary project are base64 encoded in XML
+	if (m_container) { ProjectContainer::expandBlobs(*this); }
+
 	save(_strm, 2);
 }
 
@@ -402,7 +431,16 @@ bool DataFile::writeFile(const QString& filename, bool withResources)
 	}
 
 	const QString extension = fullName.section('.', -1);
-	if (extension == "mmpz" || extension == "xptz")
+	if (extension == "mmpb")
+	{
+		if (type() == Type::SongProject || type() == Type::SongProjectTemplate)
+		{
+			cleanMetaNodes(documentElement());
+		}
+		// Like failed writes of the other formats, this makes commit() below fail and report the error
+		if (!ProjectContainer::write(*this, outfile)) { outfile.cancelWriting(); }
+	}
+	else if (extension == "mmpz" || extension == "xptz")
 	{
 		QString xml;
 		QTextStream ts( &xml );
@@ -596,6 +634,27 @@ bool DataFile::hasLocalPlugins(QDomElement parent /* = QDomElement()*/, bool fir
 
 
 
+std::vector<QString> DataFile::sampleFiles() const
+{
+	auto files = std::vector<QString>{};
+	for (const auto& [elem, srcAttrs] : ELEMENTS_WITH_RESOURCES)
+	{
+		const auto elements = elementsByTagName(elem);
+		for (int i = 0; i < elements.length(); ++i)
+		{
+			const auto item = elements.item(i).toElement();
+			for (const auto& srcAttr : srcAttrs)
+			{
+				if (const auto src = item.attribute(srcAttr); !src.isEmpty()) { files.push_back(src); }
+			}
+		}
+	}
+	return files;
+}
+
+
+
+
 DataFile::Type DataFile::type( const QString& typeName )
 {
 	const auto it = std::find_if(s_types.begin(), s_types.end(),
@@ -650,30 +709,32 @@ void DataFile::cleanMetaNodes( QDomElement _de )
 	}
 }
 
-void DataFile::mapSrcAttributeInElementsWithResources(const QMap<QString, QString>& map)
+void DataFile::mapSrcAttribute(QDomElement& el, const QMap<QString, QString>& map)
 {
-	for (const auto& [elem, srcAttrs] : ELEMENTS_WITH_RESOURCES)
+	const auto resources = ELEMENTS_WITH_RESOURCES.find(el.tagName());
+	if (resources == ELEMENTS_WITH_RESOURCES.end()) { return; }
+
+	for (const auto& srcAttr : resources->second)
 	{
-		auto elements = elementsByTagName(elem);
+		if (!el.hasAttribute(srcAttr)) { continue; }
 
-		for (const auto& srcAttr : srcAttrs)
+		const auto it = map.constFind(el.attribute(srcAttr));
+		if (it != map.constEnd())
 		{
-			for (int i = 0; i < elements.length(); ++i)
-			{
-				auto item = elements.item(i).toElement();
-
-				if (item.isNull() || !item.hasAttribute(srcAttr)) { continue; }
+			el.setAttribute(srcAttr, *it);
+		}
+	}
+}
 
-				const QString srcVal = item.attribute(srcAttr);
 
-				const auto it = map.constFind(srcVal);
-				if (it != map.constEnd())
-				{
-					item.setAttribute(srcAttr, *it);
-				}
-			}
-		}
+std::vector<QString> DataFile::resourceElementNames()
+{
+	auto names = std::vector<QString>{};
+	for (const auto& element : ELEMENTS_WITH_RESOURCES)
+	{
+		names.push_back(element.first);
 	}
+	return names;
 }
 
 
@@ -857,61 +918,43 @@ void DataFile::upgrade_0_2_1_20070508()
 }
 
 
-void DataFile::upgrade_0_3_0_rc2()
+void DataFile::upgrade_0_3_0_rc2(QDomElement& el)
 {
 	// Upgrade to version 0.3.0-rc2 from some version greater than or equal to 0.2.1-20070508
-	QDomNodeList list = elementsByTagName( "arpandchords" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.attribute( "arpdir" ).toInt() > 0 )
 	{
-		QDomElement el = list.item( i ).toElement();
-		if( el.attribute( "arpdir" ).toInt() > 0 )
-		{
-			el.setAttribute( "arpdir",
-				el.attribute( "arpdir" ).toInt() - 1 );
-		}
+		el.setAttribute( "arpdir",
+			el.attribute( "arpdir" ).toInt() - 1 );
 	}
 }
 
 
-void DataFile::upgrade_0_3_0()
+void DataFile::upgrade_0_3_0(QDomElement& el)
 {
 	// Upgrade to version 0.3.0 (final) from some version greater than or equal to 0.3.0-rc2
-	QDomNodeList list;
-	while( !( list = elementsByTagName(
-				"pluckedstringsynth" ) ).isEmpty() )
+	if( el.tagName() == "pluckedstringsynth" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "vibedstrings" );
 		el.setAttribute( "active0", 1 );
 	}
-
-	while( !( list = elementsByTagName( "lb303" ) ).isEmpty() )
+	else if( el.tagName() == "lb303" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "lb302" );
 	}
-
-	while( !( list = elementsByTagName( "channelsettings" ) ).
-							isEmpty() )
+	else if( el.tagName() == "channelsettings" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "instrumenttracksettings" );
 	}
 }
 
 
-void DataFile::upgrade_0_4_0_20080104()
+void DataFile::upgrade_0_4_0_20080104(QDomElement& el)
 {
 	// Upgrade to version 0.4.0-20080104 from some version greater than or equal to 0.3.0 (final)
-	QDomNodeList list = elementsByTagName( "fx" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.hasAttribute( "fxdisabled" ) &&
+		el.attribute( "fxdisabled" ).toInt() == 0 )
 	{
-		QDomElement el = list.item( i ).toElement();
-		if( el.hasAttribute( "fxdisabled" ) &&
-			el.attribute( "fxdisabled" ).toInt() == 0 )
-		{
-			el.setAttribute( "enabled", 1 );
-		}
+		el.setAttribute( "enabled", 1 );
 	}
 }
 
@@ -954,62 +997,43 @@ void DataFile::upgrade_0_4_0_20080129()
 }
 
 
-void DataFile::upgrade_0_4_0_20080409()
+void DataFile::upgrade_0_4_0_20080409(QDomElement& el)
 {
 	// Upgrade to version 0.4.0-20080409 from some version greater than or equal to 0.4.0-20080129
-	QStringList s;
-	s << "note" << "pattern" << "bbtco" << "sampletco" << "time";
-	for( QStringList::iterator it = s.begin(); it < s.end(); ++it )
+	if( el.tagName() == "timeline" )
 	{
-		QDomNodeList list = elementsByTagName( *it );
-		for( int i = 0; !list.item( i ).isNull(); ++i )
-		{
-			QDomElement el = list.item( i ).toElement();
-			el.setAttribute( "pos",
-				el.attribute( "pos" ).toInt()*3 );
-			el.setAttribute( "len",
-				el.attribute( "len" ).toInt()*3 );
-		}
-	}
-	QDomNodeList list = elementsByTagName( "timeline" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
-	{
-		QDomElement el = list.item( i ).toElement();
 		el.setAttribute( "lp0pos",
 			el.attribute( "lp0pos" ).toInt()*3 );
 		el.setAttribute( "lp1pos",
 			el.attribute( "lp1pos" ).toInt()*3 );
 	}
+	else
+	{
+		// note, pattern, bbtco, sampletco and time
+		el.setAttribute( "pos",
+			el.attribute( "pos" ).toInt()*3 );
+		el.setAttribute( "len",
+			el.attribute( "len" ).toInt()*3 );
+	}
 }
 
 
-void DataFile::upgrade_0_4_0_20080607()
+void DataFile::upgrade_0_4_0_20080607(QDomElement& el)
 {
 	// Upgrade to version 0.4.0-20080607 from some version greater than or equal to 0.3.0-20080409
-	QDomNodeList list;
-	while( !( list = elementsByTagName( "midi" ) ).isEmpty() )
-	{
-		QDomElement el = list.item( 0 ).toElement();
-		el.setTagName( "midiport" );
-	}
+	el.setTagName( "midiport" );
 }
 
 
-void DataFile::upgrade_0_4_0_20080622()
+void DataFile::upgrade_0_4_0_20080622(QDomElement& el)
 {
 	// Upgrade to version 0.4.0-20080622 from some version greater than or equal to 0.3.0-20080607
-	QDomNodeList list;
-	while( !( list = elementsByTagName(
-				"automation-pattern" ) ).isEmpty() )
+	if( el.tagName() == "automation-pattern" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "automationpattern" );
 	}
-
-	list = elementsByTagName( "bbtrack" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "bbtrack" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		QString s = el.attribute( "name" );
 		s.replace(QRegularExpression("^Beat/Baseline "), "Beat/Bassline");
 		el.setAttribute( "name", s );
@@ -1056,23 +1080,19 @@ void DataFile::upgrade_0_4_0_beta1()
 }
 
 
-void DataFile::upgrade_0_4_0_rc2()
+void DataFile::upgrade_0_4_0_rc2(QDomElement& el)
 {
 	// Upgrade to version 0.4.0-rc2 from some version greater than or equal to 0.4.0-beta1
-	QDomNodeList list = elementsByTagName( "audiofileprocessor" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.tagName() == "audiofileprocessor" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		QString s = el.attribute( "src" );
 		s.replace( "drumsynth/misc ", "drumsynth/misc_" );
 		s.replace( "drumsynth/r&b", "drumsynth/r_n_b" );
 		s.replace( "drumsynth/r_b", "drumsynth/r_n_b" );
 		el.setAttribute( "src", s );
 	}
-	list = elementsByTagName( "lb302" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "lb302" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		int s = el.attribute( "shape" ).toInt();
 		if( s >= 1 )
 		{
@@ -1137,42 +1157,31 @@ void DataFile::upgrade_1_1_0()
 }
 
 
-void DataFile::upgrade_1_1_91()
+void DataFile::upgrade_1_1_91(QDomElement& el)
 {
 	// Upgrade to version 1.1.91 from some version less than 1.1.91
-	QDomNodeList list = elementsByTagName( "audiofileprocessor" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.tagName() == "audiofileprocessor" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		QString s = el.attribute( "src" );
 		s.replace(QRegularExpression("/samples/bassloopes/"), "/samples/bassloops/");
 		el.setAttribute( "src", s );
 	}
-
-	list = elementsByTagName( "attribute" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "attribute" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		if( el.attribute( "name" ) == "plugin" && el.attribute( "value" ) == "vocoder-lmms" ) {
 			el.setAttribute( "value", "vocoder" );
 		}
 	}
-
-	list = elementsByTagName( "crossoevereqcontrols" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "crossoevereqcontrols" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		// invert the mute LEDs
 		for( int j = 1; j <= 4; ++j ){
 			QString a = QString( "mute%1" ).arg( j );
 			el.setAttribute( a, ( el.attribute( a ) == "0" ) ? "1" : "0" );
 		}
 	}
-
-	list = elementsByTagName( "arpeggiator" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "arpeggiator" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		// Swap elements ArpDirRandom and ArpDirDownAndUp
 		if( el.attribute( "arpdir" ) == "3" )
 		{
@@ -1748,20 +1757,13 @@ void DataFile::upgrade_automationNodes()
 }
 
 // Convert the negative length notes to StepNotes
-void DataFile::upgrade_noteTypes()
+void DataFile::upgrade_noteTypes(QDomElement& note)
 {
-	const auto notes = elementsByTagName("note");
-
-	for (int i = 0; i < notes.size(); ++i)
+	const auto noteSize = note.attribute("len").toInt();
+	if (noteSize < 0)
 	{
-		auto note = notes.item(i).toElement();
-
-		const auto noteSize = note.attribute("len").toInt();
-		if (noteSize < 0)
-		{
-			note.setAttribute("len", DefaultTicksPerBar / 16);
-			note.setAttribute("type", static_cast<int>(Note::Type::Step));
-		}
+		note.setAttribute("len", DefaultTicksPerBar / 16);
+		note.setAttribute("type", static_cast<int>(Note::Type::Step));
 	}
 }
 
@@ -1823,87 +1825,45 @@ void DataFile::upgrade_extendedNoteRange()
  * Older projects were made without this feature and would sound differently if loaded
  * with the new default setting. This upgrade routine preserves their old behavior.
  */
-void DataFile::upgrade_defaultTripleOscillatorHQ()
+void DataFile::upgrade_defaultTripleOscillatorHQ(QDomElement& el)
 {
-	QDomNodeList tripleoscillators = elementsByTagName("tripleoscillator");
-	for (int i = 0; !tripleoscillators.item(i).isNull(); i++)
+	for (int j = 1; j <= 3; j++)
 	{
-		for (int j = 1; j <= 3; j++)
+		// Only set the attribute if it does not exist (default template has it but reports as 1.2.0)
+		if (el.attribute("useWaveTable" + QString::number(j)) == "")
 		{
-			// Only set the attribute if it does not exist (default template has it but reports as 1.2.0)
-			if (tripleoscillators.item(i).toElement().attribute("useWaveTable" + QString::number(j)) == "")
-			{
-				tripleoscillators.item(i).toElement().setAttribute("useWaveTable" + QString::number(j), 0);
-			}
+			el.setAttribute("useWaveTable" + QString::number(j), 0);
 		}
 	}
 }
 
 
 // Remove FX prefix from mixer and related nodes
-void DataFile::upgrade_mixerRename()
+void DataFile::upgrade_mixerRename(QDomElement& el)
 {
-	// Change nodename <fxmixer> to <mixer>
-	QDomNodeList fxmixer = elementsByTagName("fxmixer");
-	for (int i = 0; i < fxmixer.length(); ++i)
+	if (el.tagName() == "fxmixer")
 	{
-		auto item = fxmixer.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		item.setTagName("mixer");
+		// Change nodename <fxmixer> to <mixer>
+		el.setTagName("mixer");
 	}
-
-	// Change nodename <fxchannel> to <mixerchannel>
-	QDomNodeList fxchannel = elementsByTagName("fxchannel");
-	for (int i = 0; i < fxchannel.length(); ++i)
+	else if (el.tagName() == "fxchannel")
 	{
-		auto item = fxchannel.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		item.setTagName("mixerchannel");
-	}
-
-	// Change the attribute fxch of element <instrumenttrack> to mixch
-	QDomNodeList fxch = elementsByTagName("instrumenttrack");
-	for (int i = 0; i < fxch.length(); ++i)
-	{
-		auto item = fxch.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		if (item.hasAttribute("fxch"))
-		{
-			item.setAttribute("mixch", item.attribute("fxch"));
-			item.removeAttribute("fxch");
-		}
+		// Change nodename <fxchannel> to <mixerchannel>
+		el.setTagName("mixerchannel");
 	}
-	// Change the attribute fxch of element <sampletrack> to mixch
-	fxch = elementsByTagName("sampletrack");
-	for (int i = 0; i < fxch.length(); ++i)
+	else if (el.hasAttribute("fxch"))
 	{
-		auto item = fxch.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		if (item.hasAttribute("fxch"))
-		{
-			item.setAttribute("mixch", item.attribute("fxch"));
-			item.removeAttribute("fxch");
-		}
+		// Change the attribute fxch of elements <instrumenttrack> and <sampletrack> to mixch
+		el.setAttribute("mixch", el.attribute("fxch"));
+		el.removeAttribute("fxch");
 	}
 }
 
 
 // Rename BB to pattern and TCO to clip
-void DataFile::upgrade_bbTcoRename()
+void DataFile::upgrade_bbTcoRename(QDomElement& el)
 {
-	std::vector<std::pair<const char *, const char *>> names {
+	static const std::map<QString, QString> names {
 		{"automationpattern", "automationclip"},
 		{"bbtco", "patternclip"},
 		{"pattern", "midiclip"},
@@ -1912,41 +1872,27 @@ void DataFile::upgrade_bbTcoRename()
 		{"bbtrackcontainer", "patternstore"},
 	};
 	// Replace names of XML tags
-	for (auto name : names)
+	if (const auto name = names.find(el.tagName()); name != names.end())
 	{
-		QDomNodeList elements = elementsByTagName(name.first);
-		for (int i = 0; !elements.item(i).isNull(); ++i)
-		{
-			elements.item(i).toElement().setTagName(name.second);
-		}
+		el.setTagName(name->second);
+		return;
 	}
 	// Replace "Beat/Bassline" with "Pattern" in track names
-	QDomNodeList elements = elementsByTagName("track");
-	for (int i = 0; !elements.item(i).isNull(); ++i)
+	static_assert(Track::Type::Pattern == static_cast<Track::Type>(1), "Must be type=1 for backwards compatibility");
+	if (static_cast<Track::Type>(el.attribute("type").toInt()) == Track::Type::Pattern)
 	{
-		auto e = elements.item(i).toElement();
-		static_assert(Track::Type::Pattern == static_cast<Track::Type>(1), "Must be type=1 for backwards compatibility");
-		if (static_cast<Track::Type>(e.attribute("type").toInt()) == Track::Type::Pattern)
-		{
-			e.setAttribute("name", e.attribute("name").replace("Beat/Bassline", "Pattern"));
-		}
+		el.setAttribute("name", el.attribute("name").replace("Beat/Bassline", "Pattern"));
 	}
 }
 
 
 // Set LFO speed to 0.01 on projects made before sample-and-hold PR
-void DataFile::upgrade_sampleAndHold()
+void DataFile::upgrade_sampleAndHold(QDomElement& el)
 {
-	QDomNodeList elements = elementsByTagName("lfocontroller");
-	for (int i = 0; i < elements.length(); ++i)
+	// Correct old random wave LFO speeds
+	if (el.attribute("wave").toInt() == 6)
 	{
-		if (elements.item(i).isNull()) { continue; }
-		auto e = elements.item(i).toElement();
-		// Correct old random wave LFO speeds
-		if (e.attribute("wave").toInt() == 6)
-		{
-			e.setAttribute("speed", 0.01f);
-		}
+		el.setAttribute("speed", 0.01f);
 	}
 }
 
@@ -2004,31 +1950,25 @@ static QMap<QString, QString> buildReplacementMap()
 }
 
 // Change loops' filenames in <sampleclip>s
-void DataFile::upgrade_loopsRename()
+void DataFile::upgrade_loopsRename(QDomElement& el)
 {
 	static const QMap<QString, QString> namesToNamesWithBPMsMap = buildReplacementMap();
 
-	mapSrcAttributeInElementsWithResources(namesToNamesWithBPMsMap);
+	mapSrcAttribute(el, namesToNamesWithBPMsMap);
 }
 
 //! Update MIDI CC indexes, so that they are counted from 0. Older releases of LMMS
 //! count the CCs from 1.
-void DataFile::upgrade_midiCCIndexing()
+void DataFile::upgrade_midiCCIndexing(QDomElement& el)
 {
 	static constexpr std::array attributesToUpdate{"inputcontroller", "outputcontroller"};
 
-	QDomNodeList elements = elementsByTagName("Midicontroller");
-	for(int i = 0; i < elements.length(); i++)
+	for (const char* attrName : attributesToUpdate)
 	{
-		if (elements.item(i).isNull()) { continue; }
-		auto element = elements.item(i).toElement();
-		for (const char* attrName : attributesToUpdate)
+		if (el.hasAttribute(attrName))
 		{
-			if (element.hasAttribute(attrName))
-			{
-				int cc = element.attribute(attrName).toInt();
-				element.setAttribute(attrName, cc - 1);
-			}
+			int cc = el.attribute(attrName).toInt();
+			el.setAttribute(attrName, cc - 1);
 		}
 	}
 }
@@ -2066,7 +2006,7 @@ void DataFile::findProblematicLadspaPlugins()
 	}
 }
 
-void DataFile::upgrade_fixBassLoopsTypo()
+void DataFile::upgrade_fixBassLoopsTypo(QDomElement& el)
 {
 	static const QMap<QString, QString> replacementMap = {
 		{ "bassloopes/briff01.ogg", "bassloops/briff01 - 140 BPM.ogg" },
@@ -2081,19 +2021,29 @@ void DataFile::upgrade_fixBassLoopsTypo()
 		{ "bassloopes/techno_synth04.ogg", "bassloops/techno_synth04 - 140 BPM.ogg" }
 	};
 
-	mapSrcAttributeInElementsWithResources(replacementMap);
+	mapSrcAttribute(el, replacementMap);
 }
 
 void DataFile::upgrade()
 {
-	// Runs all necessary upgrade methods
-	std::size_t max = std::min(static_cast<std::size_t>(m_fileVersion), UPGRADE_METHODS.size());
-	std::for_each( UPGRADE_METHODS.begin() + max, UPGRADE_METHODS.end(),
-		[this](UpgradeMethod um)
+	const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Upgrade"};
+
+	// Runs all necessary upgrade methods, where consecutive element upgrades share a single walk over the document
+	auto it = UPGRADE_METHODS.begin() + std::min(static_cast<std::size_t>(m_fileVersion), UPGRADE_METHODS.size());
+	while (it != UPGRADE_METHODS.end())
+	{
+		if (it->method)
 		{
-			(this->*um)();
+			(this->*it->method)();
+			++it;
+			continue;
 		}
-	);
+
+		const auto last = std::find_if(it, UPGRADE_METHODS.end(),
+			[](const Upgrade& upgrade) { return upgrade.method != nullptr; });
+		upgradeElements(it, last);
+		it = last;
+	}
 
 	// Bump the file version (which should be the size of the upgrade methods vector)
 	m_fileVersion = UPGRADE_METHODS.size();
@@ -2125,6 +2075,50 @@ void DataFile::upgrade()
 
 
 
+void DataFile::upgradeElements(UpgradeIterator first, UpgradeIterator last)
+{
+	// The upgrades that apply to each tag, in order
+	auto upgradesByTag = std::map<QString, std::vector<UpgradeIterator>>{};
+	for (auto upgrade = first; upgrade != last; ++upgrade)
+	{
+		for (const auto& tag : upgrade->tags)
+		{
+			upgradesByTag[tag].push_back(upgrade);
+		}
+	}
+
+	const auto root = documentElement();
+	auto el = root;
+	while (!el.isNull())
+	{
+		// Every upgrade sees the element as left by the previous ones, so an upgrade renaming it makes the later
+		// upgrades of the new tag apply
+		auto next = first;
+		for (auto upgrades = upgradesByTag.find(el.tagName()); upgrades != upgradesByTag.end();
+			upgrades = upgradesByTag.find(el.tagName()))
+		{
+			const auto upgrade = std::find_if(upgrades->second.begin(), upgrades->second.end(),
+				[next](UpgradeIterator candidate) { return candidate >= next; });
+			if (upgrade == upgrades->second.end()) { break; }
+
+			(*upgrade)->elementMethod(el);
+			next = *upgrade + 1;
+		}
+
+		// Continue with the next element in document order
+		auto following = el.firstChildElement();
+		while (following.isNull() && el != root)
+		{
+			following = el.nextSiblingElement();
+			el = el.parentNode().toElement();
+		}
+		el = following;
+	}
+}
+
+
+
+
 void DataFile::loadData( const QByteArray & _data, const QString & _sourceFile )
 {
 	QString errorMsg;
@@ -2159,6 +2153,39 @@ void DataFile::loadData( const QByteArray & _data, const QString & _sourceFile )
 		}
 	}
 
+	loadDocument(_sourceFile);
+}
+
+
+
+
+void DataFile::loadContainer(const QString& sourceFile)
+{
+	auto container = std::make_shared<ProjectContainer>(sourceFile);
+
+	QString errorMsg;
+	if (!container->read(*this, &errorMsg))
+	{
+		using gui::SongEditor;
+
+		qWarning() << "Error in binary project" << errorMsg;
+		if (gui::getGUI() != nullptr)
+		{
+			QMessageBox::critical(nullptr, SongEditor::tr("Error in file"),
+				SongEditor::tr("The file %1 seems to contain errors and therefore can't be loaded.").arg(sourceFile));
+		}
+		return;
+	}
+
+	m_container = std::move(container);
+	loadDocument(sourceFile);
+}
+
+
+
+
+void DataFile::loadDocument(const QString& _sourceFile)
+{
 	QDomElement root = documentElement();
 	m_type = type( root.attribute( "type" ) );
 	m_head = root.elementsByTagName( "head" ).item( 0 ).toElement();
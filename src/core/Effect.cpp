@@ -31,7 +31,10 @@
 #include "EffectView.h"
 
 #include "ConfigManager.h"
+#include "MicroTimer.h"
+#include "MixHelpers.h"
 #include "SampleFrame.h"
+#include "TraceRecorder.h"
 
 namespace lmms
 {
@@ -48,7 +51,9 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	m_enabledModel( true, this, tr( "Effect enabled" ) ),
 	m_wetDryModel( 1.0f, -1.0f, 1.0f, 0.01f, this, tr( "Wet/Dry mix" ) ),
 	m_autoQuitModel( 1.0f, 1.0f, 8000.0f, 100.0f, 1.0f, this, tr( "Decay" ) ),
-	m_autoQuitEnabled(ConfigManager::inst()->value("ui", "disableautoquit", "1").toInt() == 0)
+	m_autoQuitEnabled(ConfigManager::inst()->value("ui", "disableautoquit", "1").toInt() == 0),
+	m_profilerSource(JobProfiler::SourceType::Effect, [this] { return displayName(); },
+		[this] { return m_parent ? m_parent->profilerOwner() : JobProfiler::NoSource; })
 {
 	m_wetDryModel.setCenterValue(0);
 
@@ -99,13 +104,22 @@ bool Effect::processAudioBuffer(SampleFrame* buf, const fpp_t frames)
 		return false;
 	}
 
+	const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Effect, "Effect", m_profilerSource.id()};
+	const auto timer = MicroTimer{};
 	const auto status = processImpl(buf, frames);
+
+	// Sanitizing the output and measuring its level for auto-quit share a single pass over the buffer
+	const auto outputPeak = MixHelpers::sanitizeAndGetPeak(buf, frames);
+	const auto elapsed = timer.elapsed();
+	m_timing.record(elapsed);
+	if (JobProfiler::instance().isEnabled()) { JobProfiler::instance().record(m_profilerSource.id(), elapsed); }
+
 	switch (status)
 	{
 		case ProcessStatus::Continue:
 			break;
 		case ProcessStatus::ContinueIfNotQuiet:
-			handleAutoQuit({buf, frames});
+			handleAutoQuit(outputPeak);
 			break;
 		case ProcessStatus::Sleep:
 			return false;
@@ -142,7 +156,7 @@ Effect * Effect::instantiate( const QString& pluginName,
 
 
 
-void Effect::handleAutoQuit(std::span<const SampleFrame> output)
+void Effect::handleAutoQuit(sample_t outputPeak)
 {
 	if (!m_autoQuitEnabled)
 	{
@@ -175,15 +189,11 @@ void Effect::handleAutoQuit(std::span<const SampleFrame> output)
 	// Check whether we need to continue processing input. Restart the
 	// counter if the threshold has been exceeded.
 
-	for (const SampleFrame& frame : output)
+	if (outputPeak >= threshold)
 	{
-		const auto abs = frame.abs();
-		if (abs.left() >= threshold || abs.right() >= threshold)
-		{
-			// The output buffer is not quiet
-			m_quietBufferCount = 0;
-			return;
-		}
+		// The output buffer is not quiet
+		m_quietBufferCount = 0;
+		return;
 	}
 
 	// The output buffer is quiet, so check if auto-quit should be activated yet
@@ -196,10 +196,10 @@ bool EffectChain::processAudioBuffer( SampleFrame* _buf, const fpp_t _frames, bo
 	bool moreEffects = false;
 	for (const auto& effect : m_effects)
 	{
+		// Effects sanitize their own output
 		if (hasInputNoise || effect->isRunning())
 		{
 			moreEffects |= effect->processAudioBuffer(_buf, _frames);
-			MixHelpers::sanitize(_buf, _frames);
 		}
 	}
 
@@ -33,6 +33,7 @@
 #include "Plugin.h"
 #include "PresetPreviewPlayHandle.h"
 #include "ProjectJournal.h"
+#include "SampleBuffer.h"
 #include "Song.h"
 #include "BandLimitedWave.h"
 #include "Oscillator.h"
@@ -68,6 +69,17 @@ void Engine::init( bool renderOnly )
 	emit engine->initProgress(tr("Initializing data structures"));
 	s_projectJournal = new ProjectJournal;
 	s_audioEngine = new AudioEngine( renderOnly );
+
+	// Samples kept at the engine sample rate have to be resampled again when it changes. Exporting only switches to
+	// the export rate and back, before the song knows it is exporting, which would resample everything twice.
+	connect(s_audioEngine, &AudioEngine::sampleRateChanged, [] {
+		if (!s_audioEngine->hasStoredAudioDevice()) { SampleBuffer::updateResampled(); }
+	});
+
+	// The audio device may change the period, so it is opened before anything allocates period sized buffers
+	emit engine->initProgress(tr("Opening audio device"));
+	s_audioEngine->initAudioDevice();
+
 	s_song = new Song;
 	s_mixer = new Mixer;
 	s_patternStore = new PatternStore;
@@ -80,8 +92,8 @@ void Engine::init( bool renderOnly )
 
 	s_projectJournal->setJournalling( true );
 
-	emit engine->initProgress(tr("Opening audio and midi devices"));
-	s_audioEngine->initDevices();
+	emit engine->initProgress(tr("Opening MIDI device"));
+	s_audioEngine->initMidiClient();
 
 	PresetPreviewPlayHandle::init();
 
@@ -94,6 +106,8 @@ void Engine::init( bool renderOnly )
 
 void Engine::destroy()
 {
+	emit inst()->aboutToDestroy();
+
 	s_projectJournal->stopAllJournalling();
 	s_audioEngine->stopProcessing();
 
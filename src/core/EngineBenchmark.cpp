@@ -0,0 +1,590 @@
+/*
+ * EngineBenchmark.cpp - Headless benchmark of the audio engine
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "EngineBenchmark.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+#include "lmmsconfig.h"
+#include "lmmsversion.h"
+
+#ifdef LMMS_BUILD_WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "AudioDummy.h"
+#include "AudioEngine.h"
+#include "AudioResampler.h"
+#include "AutomationClip.h"
+#include "Effect.h"
+#include "EffectChain.h"
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "Mixer.h"
+#include "Note.h"
+#include "SampleClip.h"
+#include "Song.h"
+#include "lmms_math.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr auto SyntheticBars = 16;
+constexpr auto SampleSeconds = 24;
+
+auto addInstrumentTrack(const QString& name) -> InstrumentTrack*
+{
+	auto track = static_cast<InstrumentTrack*>(Track::create(Track::Type::Instrument, Engine::getSong()));
+	track->setName(name);
+	track->loadInstrument("tripleoscillator");
+	return track;
+}
+
+//! Add @p voices notes starting at @p baseKey to each bar, so that new notes start every bar
+void addChords(InstrumentTrack* track, int voices, int baseKey)
+{
+	auto clip = static_cast<MidiClip*>(track->createClip(TimePos{0}));
+	for (auto bar = 0; bar < SyntheticBars; ++bar)
+	{
+		for (auto voice = 0; voice < voices; ++voice)
+		{
+			clip->addNote(Note{TimePos{1, 0}, TimePos{bar, 0}, baseKey + voice}, false);
+		}
+	}
+}
+
+void addEffect(EffectChain* chain, const QString& pluginName)
+{
+	if (auto effect = Effect::instantiate(pluginName, chain, nullptr))
+	{
+		chain->appendEffect(effect);
+		return;
+	}
+
+	fprintf(stderr, "Effect plugin \"%s\" is not available\n", pluginName.toUtf8().constData());
+}
+
+//! Automate @p model with a sine between @p min and @p max, with a point every 16th note
+void automate(AutomatableModel* model, float min, float max)
+{
+	auto track = Track::create(Track::Type::Automation, Engine::getSong());
+	auto clip = static_cast<AutomationClip*>(track->createClip(TimePos{0}));
+	clip->addObject(model);
+
+	constexpr auto Step = DefaultTicksPerBar / 16;
+	for (auto tick = 0; tick <= SyntheticBars * DefaultTicksPerBar; tick += Step)
+	{
+		const auto phase = 2 * std::numbers::pi_v<float> * tick / DefaultTicksPerBar;
+		clip->putValue(TimePos{tick}, min + (max - min) * (0.5f + 0.5f * std::sin(phase)), false);
+	}
+}
+
+//! Write a 16 bit stereo wave file with a sine sweep
+bool writeSineWave(const QString& fileName, int sampleRate, int seconds)
+{
+	auto file = QFile{fileName};
+	if (!file.open(QFile::WriteOnly | QFile::Truncate)) { return false; }
+
+	constexpr auto Channels = 2;
+	constexpr auto BytesPerSample = 2;
+	const auto frames = sampleRate * seconds;
+	const auto dataSize = static_cast<quint32>(frames * Channels * BytesPerSample);
+
+	auto stream = QDataStream{&file};
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData("RIFF", 4);
+	stream << quint32{36 + dataSize};
+	stream.writeRawData("WAVEfmt ", 8);
+	stream << quint32{16} << quint16{1} << quint16{Channels} << quint32(sampleRate)
+		<< quint32(sampleRate * Channels * BytesPerSample) << quint16{Channels * BytesPerSample}
+		<< quint16{BytesPerSample * 8};
+	stream.writeRawData("data", 4);
+	stream << dataSize;
+
+	auto phase = 0.f;
+	for (auto frame = 0; frame < frames; ++frame)
+	{
+		const auto frequency = 110.f + 770.f * frame / frames;
+		phase += 2 * std::numbers::pi_v<float> * frequency / sampleRate;
+		const auto value = static_cast<qint16>(std::sin(phase) * 16000);
+		stream << value << value;
+	}
+
+	return stream.status() == QDataStream::Ok;
+}
+
+void buildVoices(const QString&)
+{
+	for (auto i = 0; i < 4; ++i)
+	{
+		addChords(addInstrumentTrack(QString{"Voices %1"}.arg(i + 1)), 32, 36 + i * 8);
+	}
+}
+
+void buildMixerTree(const QString&)
+{
+	auto mixer = Engine::mixer();
+	const auto addChannel = [mixer](int parent) {
+		const auto channel = mixer->createChannel();
+		if (parent != 0)
+		{
+			mixer->deleteChannelSend(channel, 0);
+			mixer->createChannelSend(channel, parent);
+		}
+		addEffect(&mixer->mixerChannel(channel)->m_fxChain, "amplifier");
+		addEffect(&mixer->mixerChannel(channel)->m_fxChain, "eq");
+		return channel;
+	};
+
+	// A chain of channels leading to the master channel, below which a binary tree with 16 leaves is built
+	auto parent = 0;
+	for (auto i = 0; i < 8; ++i)
+	{
+		parent = addChannel(parent);
+	}
+
+	auto level = std::vector<int>{addChannel(parent)};
+	for (auto depth = 0; depth < 4; ++depth)
+	{
+		auto children = std::vector<int>{};
+		for (const auto channel : level)
+		{
+			children.push_back(addChannel(channel));
+			children.push_back(addChannel(channel));
+		}
+		level = std::move(children);
+	}
+
+	for (auto i = std::size_t{0}; i < level.size(); ++i)
+	{
+		auto track = addInstrumentTrack(QString{"Send %1"}.arg(i + 1));
+		track->mixerChannelModel()->setValue(level[i]);
+		addChords(track, 4, 48 + static_cast<int>(i));
+	}
+}
+
+void buildAutomation(const QString&)
+{
+	for (auto i = 0; i < 8; ++i)
+	{
+		auto track = addInstrumentTrack(QString{"Automated %1"}.arg(i + 1));
+		addChords(track, 4, 48 + i * 4);
+		automate(track->volumeModel(), 50.f, 100.f);
+		automate(track->panningModel(), -100.f, 100.f);
+		automate(track->pitchModel(), -100.f, 100.f);
+	}
+}
+
+void buildSampleClips(const QString& dir)
+{
+	const auto sampleFile = QDir{dir}.filePath("sweep.wav");
+	if (!writeSineWave(sampleFile, Engine::audioEngine()->outputSampleRate(), SampleSeconds))
+	{
+		fprintf(stderr, "Could not write %s\n", sampleFile.toUtf8().constData());
+		return;
+	}
+
+	for (auto i = 0; i < 16; ++i)
+	{
+		auto track = Track::create(Track::Type::Sample, Engine::getSong());
+		track->setName(QString{"Sample %1"}.arg(i + 1));
+		static_cast<SampleClip*>(track->createClip(TimePos{0}))->setSampleFile(sampleFile);
+	}
+}
+
+void buildEffectChains(const QString&)
+{
+	for (auto i = 0; i < 8; ++i)
+	{
+		auto track = addInstrumentTrack(QString{"Effects %1"}.arg(i + 1));
+		addChords(track, 8, 48 + i * 2);
+
+		for (const auto name : {"eq", "compressor", "dualfilter", "delay", "reverbsc", "amplifier"})
+		{
+			addEffect(track->audioBusHandle()->effects(), name);
+		}
+	}
+}
+
+struct SyntheticProject
+{
+	const char* name;
+	void (*build)(const QString& dir);
+};
+
+constexpr auto SyntheticProjects = std::array{
+	SyntheticProject{"synthetic-voices", buildVoices},
+	SyntheticProject{"synthetic-mixer-tree", buildMixerTree},
+	SyntheticProject{"synthetic-automation", buildAutomation},
+	SyntheticProject{"synthetic-sample-clips", buildSampleClips},
+	SyntheticProject{"synthetic-effect-chains", buildEffectChains},
+};
+
+//! In kilobytes
+auto peakResidentSetSize() -> qint64
+{
+#ifdef LMMS_BUILD_WIN32
+	auto counters = PROCESS_MEMORY_COUNTERS{};
+	if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return 0; }
+	return static_cast<qint64>(counters.PeakWorkingSetSize / 1024);
+#else
+	auto usage = rusage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+#ifdef LMMS_BUILD_APPLE
+	return usage.ru_maxrss / 1024; // In bytes on macOS
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+auto stageKey(AudioEngineProfiler::DetailType type) -> QString
+{
+	switch (type)
+	{
+		case AudioEngineProfiler::DetailType::NoteSetup: return "note_setup";
+		case AudioEngineProfiler::DetailType::Instruments: return "instruments";
+		case AudioEngineProfiler::DetailType::Effects: return "effects";
+		case AudioEngineProfiler::DetailType::Mixing: return "mixing";
+		default: return {};
+	}
+}
+
+//! Run `lmms benchmark` with @p arguments in a new process, returning whether it succeeded
+bool runBenchmarkProcess(const EngineBenchmark::Options& options, const QStringList& arguments)
+{
+	auto process = QProcess{};
+	process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+	process.setStandardOutputFile(QProcess::nullDevice());
+	process.start(QCoreApplication::applicationFilePath(), options.globalArguments + QStringList{"benchmark"} + arguments);
+
+	return process.waitForFinished(-1) && process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+//! Resample noise with each AudioResampler mode the way Sample::play does for each voice, changing the pitch every
+//! period, and report how many such voices a single core can play in realtime at 44.1 kHz
+auto measureResamplers() -> QJsonArray
+{
+	constexpr auto SampleRate = 44100.0;
+	constexpr auto Periods = 20000;
+	constexpr auto Ratios = std::array{0.5, 0.84, 1.19, 2.0};
+
+	const auto modes = std::array{
+		std::pair{AudioResampler::Mode::ZOH, "zoh"},
+		std::pair{AudioResampler::Mode::Linear, "linear"},
+		std::pair{AudioResampler::Mode::Cubic, "cubic"},
+		std::pair{AudioResampler::Mode::SincFastest, "sinc_fastest"},
+		std::pair{AudioResampler::Mode::SincMedium, "sinc_medium"},
+		std::pair{AudioResampler::Mode::SincBest, "sinc_best"},
+	};
+
+	auto input = std::vector<float>(DEFAULT_BUFFER_SIZE * 2);
+	for (auto& sample : input) { sample = fastRand(2.f) - 1.f; }
+	auto output = std::vector<float>(DEFAULT_BUFFER_SIZE * 2);
+
+	auto results = QJsonArray{};
+	for (const auto& [mode, name] : modes)
+	{
+		auto resampler = AudioResampler{mode};
+		auto frames = qint64{0};
+
+		auto timer = QElapsedTimer{};
+		timer.start();
+		for (auto period = 0; period < Periods; ++period)
+		{
+			resampler.setRatio(Ratios[period % Ratios.size()]);
+
+			// Render a period, feeding the input again whenever it is used up
+			auto generated = f_cnt_t{0};
+			while (generated < DEFAULT_BUFFER_SIZE)
+			{
+				const auto result = resampler.process({input.data(), 2, DEFAULT_BUFFER_SIZE},
+					{output.data() + generated * 2, 2, DEFAULT_BUFFER_SIZE - generated});
+				generated += result.outputFramesGenerated;
+			}
+			frames += generated;
+		}
+		const auto seconds = timer.nsecsElapsed() / 1e9;
+
+		const auto voices = seconds > 0 ? frames / SampleRate / seconds : 0.;
+		fprintf(stderr, "  %s: %.0f voices per core\n", name, voices);
+
+		auto result = QJsonObject{};
+		result["mode"] = name;
+		result["voices_per_core"] = voices;
+		results.append(result);
+	}
+
+	return results;
+}
+
+auto readJson(const QString& fileName) -> QJsonObject
+{
+	auto file = QFile{fileName};
+	if (!file.open(QFile::ReadOnly)) { return {}; }
+	return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+} // namespace
+
+
+
+
+int EngineBenchmark::run(const Options& options)
+{
+	auto tempDir = QTemporaryDir{};
+	if (!tempDir.isValid())
+	{
+		fprintf(stderr, "Could not create a temporary directory\n");
+		return EXIT_FAILURE;
+	}
+
+	auto projects = QStringList{};
+	if (options.synthetic)
+	{
+		if (!runBenchmarkProcess(options, {"--generate", tempDir.path()}))
+		{
+			fprintf(stderr, "Could not generate the synthetic projects\n");
+			return EXIT_FAILURE;
+		}
+
+		for (const auto& project : SyntheticProjects)
+		{
+			projects << QDir{tempDir.path()}.filePath(QString{project.name} + ".mmp");
+		}
+	}
+	projects << options.projects;
+
+	auto failed = false;
+	auto results = QJsonArray{};
+	for (const auto& project : projects)
+	{
+		fprintf(stderr, "Measuring %s...\n", QFileInfo{project}.completeBaseName().toUtf8().constData());
+
+		const auto resultFile = tempDir.filePath("result.json");
+		QFile::remove(resultFile);
+		if (!runBenchmarkProcess(options,
+			{"--measure", project, "--seconds", QString::number(options.maxSeconds), "--output", resultFile}))
+		{
+			fprintf(stderr, "Could not measure %s\n", project.toUtf8().constData());
+			failed = true;
+			continue;
+		}
+
+		const auto result = readJson(resultFile);
+		fprintf(stderr, "  %.2fx realtime, loaded in %.0f ms, peak memory %lld MB\n",
+			result.value("realtime_factor").toDouble(), result.value("load_ms").toDouble(),
+			static_cast<long long>(result.value("peak_rss_kb").toDouble() / 1024));
+		results.append(result);
+	}
+
+	fprintf(stderr, "Measuring resamplers...\n");
+	const auto resamplers = measureResamplers();
+
+	if (!options.baselineFile.isEmpty())
+	{
+		const auto baseline = readJson(options.baselineFile).value("results").toArray();
+		if (baseline.isEmpty())
+		{
+			fprintf(stderr, "Could not read baseline %s\n", options.baselineFile.toUtf8().constData());
+			return EXIT_FAILURE;
+		}
+
+		auto baselineFactors = QHash<QString, double>{};
+		for (const auto& value : baseline)
+		{
+			const auto result = value.toObject();
+			baselineFactors[result.value("project").toString()] = result.value("realtime_factor").toDouble();
+		}
+
+		for (const auto& value : results)
+		{
+			const auto result = value.toObject();
+			const auto name = result.value("project").toString();
+			if (!baselineFactors.contains(name)) { continue; }
+
+			const auto before = baselineFactors[name];
+			const auto after = result.value("realtime_factor").toDouble();
+			if (after < before * (1 - options.tolerance))
+			{
+				fprintf(stderr, "Regression in %s: %.2fx realtime, was %.2fx\n", name.toUtf8().constData(), after,
+					before);
+				failed = true;
+			}
+		}
+	}
+
+	auto report = QJsonObject{};
+	report["version"] = LMMS_VERSION;
+	report["results"] = results;
+	report["resamplers"] = resamplers;
+	const auto json = QJsonDocument{report}.toJson();
+
+	if (options.outputFile.isEmpty())
+	{
+		fwrite(json.constData(), 1, json.size(), stdout);
+		fflush(stdout);
+	}
+	else
+	{
+		auto file = QFile{options.outputFile};
+		if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(json) != json.size())
+		{
+			fprintf(stderr, "Could not write %s\n", options.outputFile.toUtf8().constData());
+			return EXIT_FAILURE;
+		}
+	}
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+
+
+int EngineBenchmark::generateSyntheticProjects(const QString& dir)
+{
+	Engine::init(true);
+
+	auto success = true;
+	for (const auto& project : SyntheticProjects)
+	{
+		Engine::getSong()->clearProject();
+		project.build(dir);
+
+		const auto fileName = QDir{dir}.filePath(QString{project.name} + ".mmp");
+		if (!Engine::getSong()->saveProjectFile(fileName))
+		{
+			fprintf(stderr, "Could not write %s\n", fileName.toUtf8().constData());
+			success = false;
+		}
+	}
+
+	Engine::destroy();
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+
+
+int EngineBenchmark::measure(const QString& project, int maxSeconds, const QString& outputFile)
+{
+	Engine::init(true);
+
+	auto audioEngine = Engine::audioEngine();
+	auto song = Engine::getSong();
+
+	// The dummy device of the render-only engine is paced to realtime, so replace it with one that is never
+	// started, and render the periods from here as fast as possible
+	auto success = false;
+	audioEngine->setAudioDevice(new AudioDummy(success, audioEngine), false, false);
+
+	auto timer = QElapsedTimer{};
+	timer.start();
+	song->loadProject(project);
+	const auto loadTime = timer.nsecsElapsed() / 1e6;
+
+	if (song->isEmpty())
+	{
+		fprintf(stderr, "The project %s is empty\n", project.toUtf8().constData());
+		Engine::destroy();
+		return EXIT_FAILURE;
+	}
+
+	const auto sampleRate = audioEngine->outputSampleRate();
+	const auto framesPerPeriod = audioEngine->framesPerPeriod();
+	const auto maxFrames = static_cast<qint64>(maxSeconds) * sampleRate;
+
+	song->setExportLoop(false);
+	song->startExport();
+	audioEngine->profiler().resetDetailTotals();
+
+	auto frames = qint64{0};
+	timer.restart();
+	while (!song->isExportDone() && (maxSeconds <= 0 || frames < maxFrames))
+	{
+		audioEngine->nextBuffer();
+		frames += framesPerPeriod;
+	}
+	const auto renderTime = timer.nsecsElapsed() / 1e9;
+
+	song->stopExport();
+
+	auto stages = QJsonObject{};
+	for (auto i = std::size_t{0}; i < AudioEngineProfiler::DetailCount; ++i)
+	{
+		const auto type = static_cast<AudioEngineProfiler::DetailType>(i);
+		stages[stageKey(type)] = audioEngine->profiler().detailTotalTime(type) / 1000.0;
+	}
+
+	const auto audioTime = static_cast<double>(frames) / sampleRate;
+
+	auto result = QJsonObject{};
+	result["project"] = QFileInfo{project}.completeBaseName();
+	result["sample_rate"] = static_cast<int>(sampleRate);
+	result["frames_per_period"] = static_cast<int>(framesPerPeriod);
+	result["load_ms"] = loadTime;
+	result["audio_seconds"] = audioTime;
+	result["render_seconds"] = renderTime;
+	result["realtime_factor"] = renderTime > 0 ? audioTime / renderTime : 0.;
+	result["stages_ms"] = stages;
+	result["peak_rss_kb"] = peakResidentSetSize();
+
+	Engine::destroy();
+
+	auto file = QFile{outputFile};
+	if (!file.open(QFile::WriteOnly | QFile::Truncate))
+	{
+		fprintf(stderr, "Could not write %s\n", outputFile.toUtf8().constData());
+		return EXIT_FAILURE;
+	}
+	file.write(QJsonDocument{result}.toJson());
+
+	return EXIT_SUCCESS;
+}
+
+} // namespace lmms
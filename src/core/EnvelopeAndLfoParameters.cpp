@@ -24,9 +24,14 @@
 
 #include "EnvelopeAndLfoParameters.h"
 
+#include <algorithm>
 #include <QDomElement>
 #include <QFileInfo>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "AudioEngine.h"
 #include "Engine.h"
 #include "Oscillator.h"
@@ -44,17 +49,58 @@ extern const float SECS_PER_LFO_OSCILLATION = 20.0f;
 const f_cnt_t minimumFrames = 1;
 
 
+namespace
+{
+
+//! Combine the LFO levels in @p levels with the envelope, which is @p scale times @p env, or @p scale throughout if
+//! @p env is nullptr. Modulating the envelope amount multiplies the envelope with the LFO, otherwise they are added.
+void combineEnvelope(float* levels, const float* env, float scale, fpp_t count, bool modulateAmount)
+{
+	auto i = fpp_t{0};
+
+#ifdef __SSE__
+	const auto scales = _mm_set1_ps(scale);
+	const auto half = _mm_set1_ps(0.5f);
+	for (; i + 4 <= count; i += 4)
+	{
+		const auto envLevels = env ? _mm_mul_ps(_mm_loadu_ps(env + i), scales) : scales;
+		const auto lfoLevels = _mm_loadu_ps(levels + i);
+		_mm_storeu_ps(levels + i, modulateAmount
+			? _mm_mul_ps(envLevels, _mm_add_ps(half, lfoLevels))
+			: _mm_add_ps(envLevels, lfoLevels));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const auto envLevel = env ? env[i] * scale : scale;
+		levels[i] = modulateAmount ? envLevel * (0.5f + levels[i]) : envLevel + levels[i];
+	}
+}
+
+} // namespace
+
+
 EnvelopeAndLfoParameters::LfoInstances * EnvelopeAndLfoParameters::s_lfoInstances = nullptr;
+std::atomic<unsigned> EnvelopeAndLfoParameters::s_periods = 0;
+
+
+void EnvelopeAndLfoParameters::LfoInstances::startPeriod()
+{
+	s_periods.fetch_add(1);
+}
+
+
 
 
 void EnvelopeAndLfoParameters::LfoInstances::trigger()
 {
-	QMutexLocker m( &m_lfoListMutex );
 	for (const auto& lfo : m_lfos)
 	{
 		lfo->m_lfoFrame += Engine::audioEngine()->framesPerPeriod();
-		lfo->m_bad_lfoShapeData = true;
+		lfo->updateLfoShapeData();
 	}
+	s_periods.fetch_add(1);
 }
 
 
@@ -62,11 +108,10 @@ void EnvelopeAndLfoParameters::LfoInstances::trigger()
 
 void EnvelopeAndLfoParameters::LfoInstances::reset()
 {
-	QMutexLocker m( &m_lfoListMutex );
 	for (const auto& lfo : m_lfos)
 	{
 		lfo->m_lfoFrame = 0;
-		lfo->m_bad_lfoShapeData = true;
+		lfo->updateLfoShapeData();
 	}
 }
 
@@ -75,8 +120,7 @@ void EnvelopeAndLfoParameters::LfoInstances::reset()
 
 void EnvelopeAndLfoParameters::LfoInstances::add( EnvelopeAndLfoParameters * lfo )
 {
-	QMutexLocker m( &m_lfoListMutex );
-	m_lfos.append( lfo );
+	m_lfos.push_back(lfo);
 }
 
 
@@ -84,8 +128,7 @@ void EnvelopeAndLfoParameters::LfoInstances::add( EnvelopeAndLfoParameters * lfo
 
 void EnvelopeAndLfoParameters::LfoInstances::remove( EnvelopeAndLfoParameters * lfo )
 {
-	QMutexLocker m( &m_lfoListMutex );
-	m_lfos.removeAll( lfo );
+	std::erase(m_lfos, lfo);
 }
 
 
@@ -95,7 +138,6 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 					float _value_for_zero_amount,
 							Model * _parent ) :
 	Model( _parent ),
-	m_used( false ),
 	m_predelayModel(0.f, 0.f, 2.f, 0.001f, this, tr("Env pre-delay")),
 	m_attackModel(0.f, 0.f, 2.f, 0.001f, this, tr("Env attack")),
 	m_holdModel(0.5f, 0.f, 2.f, 0.001f, this, tr("Env hold")),
@@ -104,12 +146,6 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 	m_releaseModel(0.1f, 0.f, 2.f, 0.001f, this, tr("Env release")),
 	m_amountModel(0.f, -1.f, 1.f, 0.005f, this, tr("Env mod amount")),
 	m_valueForZeroAmount( _value_for_zero_amount ),
-	m_pahdFrames( 0 ),
-	m_rFrames( 0 ),
-	m_pahdEnv( nullptr ),
-	m_rEnv( nullptr ),
-	m_pahdBufSize( 0 ),
-	m_rBufSize( 0 ),
 	m_lfoPredelayModel(0.f, 0.f, 1.f, 0.001f, this, tr("LFO pre-delay")),
 	m_lfoAttackModel(0.f, 0.f, 1.f, 0.001f, this, tr("LFO attack")),
 	m_lfoSpeedModel(0.1f, 0.001f, 1.f, 0.0001f,
@@ -120,19 +156,12 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 	m_x100Model( false, this, tr( "LFO frequency x 100" ) ),
 	m_controlEnvAmountModel( false, this, tr( "Modulate env amount" ) ),
 	m_lfoFrame( 0 ),
-	m_lfoAmountIsZero( false ),
-	m_lfoShapeData(nullptr)
+	m_lfoShapeData(Engine::audioEngine()->framesPerPeriod()),
+	m_random(0.f)
 {
 	m_amountModel.setCenterValue( 0 );
 	m_lfoAmountModel.setCenterValue( 0 );
 
-	if( s_lfoInstances == nullptr )
-	{
-		s_lfoInstances = new LfoInstances();
-	}
-
-	instances()->add( this );
-
 	connect( &m_predelayModel, SIGNAL(dataChanged()),
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 	connect( &m_attackModel, SIGNAL(dataChanged()),
@@ -160,15 +189,23 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 	connect( &m_x100Model, SIGNAL(dataChanged()),
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
+	connect( &m_controlEnvAmountModel, SIGNAL(dataChanged()),
+			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 
 	connect( Engine::audioEngine(), SIGNAL(sampleRateChanged()),
 				this, SLOT(updateSampleVars()));
 
+	updateSampleVars();
+	updateLfoShapeData();
 
-	m_lfoShapeData =
-		new sample_t[Engine::audioEngine()->framesPerPeriod()];
+	// Only now that there are parameters, the audio engine may trigger the LFO
+	const auto guard = Engine::audioEngine()->requestChangesGuard();
+	if( s_lfoInstances == nullptr )
+	{
+		s_lfoInstances = new LfoInstances();
+	}
 
-	updateSampleVars();
+	instances()->add( this );
 }
 
 
@@ -189,11 +226,9 @@ EnvelopeAndLfoParameters::~EnvelopeAndLfoParameters()
 	m_lfoAmountModel.disconnect( this );
 	m_lfoWaveModel.disconnect( this );
 	m_x100Model.disconnect( this );
+	m_controlEnvAmountModel.disconnect( this );
 
-	delete[] m_pahdEnv;
-	delete[] m_rEnv;
-	delete[] m_lfoShapeData;
-
+	const auto guard = Engine::audioEngine()->requestChangesGuard();
 	instances()->remove( this );
 
 	if( instances()->isEmpty() )
@@ -206,13 +241,12 @@ EnvelopeAndLfoParameters::~EnvelopeAndLfoParameters()
 
 
 
-inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( fpp_t _frame_offset )
+inline sample_t EnvelopeAndLfoParameters::lfoShapeSample(const Params& params, fpp_t frameOffset)
 {
-	f_cnt_t frame = ( m_lfoFrame + _frame_offset ) % m_lfoOscillationFrames;
-	const float phase = frame / static_cast<float>(
-						m_lfoOscillationFrames );
+	const f_cnt_t frame = (m_lfoFrame + frameOffset) % params.lfoOscillationFrames;
+	const float phase = frame / static_cast<float>(params.lfoOscillationFrames);
 	sample_t shape_sample;
-	switch( static_cast<LfoShape>(m_lfoWaveModel.value())  )
+	switch (params.lfoShape)
 	{
 		case LfoShape::TriangleWave:
 			shape_sample = Oscillator::triangleSample( phase );
@@ -224,7 +258,7 @@ inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( fpp_t _frame_offset )
 			shape_sample = Oscillator::sawSample( phase );
 			break;
 		case LfoShape::UserDefinedWave:
-			shape_sample = Oscillator::userWaveSample(m_userWave.get(), phase);
+			shape_sample = Oscillator::userWaveSample(params.userWave.get(), phase);
 			break;
 		case LfoShape::RandomWave:
 			if( frame == 0 )
@@ -238,7 +272,7 @@ inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( fpp_t _frame_offset )
 			shape_sample = Oscillator::sinSample( phase );
 			break;
 	}
-	return shape_sample * m_lfoAmount;
+	return shape_sample * params.lfoAmount;
 }
 
 
@@ -246,47 +280,38 @@ inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( fpp_t _frame_offset )
 
 void EnvelopeAndLfoParameters::updateLfoShapeData()
 {
+	const auto& p = params();
+	// Voices do not read the shape of LFOs that are switched off
+	if (p.lfoAmountIsZero) { return; }
+
 	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
 	for( fpp_t offset = 0; offset < frames; ++offset )
 	{
-		m_lfoShapeData[offset] = lfoShapeSample( offset );
+		m_lfoShapeData[offset] = lfoShapeSample(p, offset);
 	}
-	m_bad_lfoShapeData = false;
 }
 
 
 
 
-inline void EnvelopeAndLfoParameters::fillLfoLevel( float * _buf,
-							f_cnt_t _frame,
-							const fpp_t _frames )
+void EnvelopeAndLfoParameters::fillLfoLevel(const Params& params, float* buf, f_cnt_t frame, const fpp_t frames) const
 {
-	if( m_lfoAmountIsZero || _frame <= m_lfoPredelayFrames )
+	// The shape is computed once per period for all voices and may lag behind a change of the parameters until the
+	// next one
+	if (params.lfoAmountIsZero || frame <= params.lfoPredelayFrames)
 	{
-		for( fpp_t offset = 0; offset < _frames; ++offset )
-		{
-			*_buf++ = 0.0f;
-		}
+		std::fill_n(buf, frames, 0.f);
 		return;
 	}
-	_frame -= m_lfoPredelayFrames;
-
-	if( m_bad_lfoShapeData )
-	{
-		updateLfoShapeData();
-	}
+	frame -= params.lfoPredelayFrames;
 
 	fpp_t offset = 0;
-	const float lafI = 1.0f / std::max(minimumFrames, m_lfoAttackFrames);
-	for( ; offset < _frames && _frame < m_lfoAttackFrames; ++offset,
-								++_frame )
-	{
-		*_buf++ = m_lfoShapeData[offset] * _frame * lafI;
-	}
-	for( ; offset < _frames; ++offset )
+	const float lafI = 1.0f / std::max(minimumFrames, params.lfoAttackFrames);
+	for (; offset < frames && frame < params.lfoAttackFrames; ++offset, ++frame)
 	{
-		*_buf++ = m_lfoShapeData[offset];
+		buf[offset] = m_lfoShapeData[offset] * frame * lafI;
 	}
+	std::copy(m_lfoShapeData.begin() + offset, m_lfoShapeData.begin() + frames, buf + offset);
 }
 
 
@@ -296,39 +321,47 @@ void EnvelopeAndLfoParameters::fillLevel( float * _buf, f_cnt_t _frame,
 						const f_cnt_t _release_begin,
 						const fpp_t _frames )
 {
-	QMutexLocker m(&m_paramMutex);
+	const auto& p = params();
 
-	fillLfoLevel( _buf, _frame, _frames );
+	fillLfoLevel(p, _buf, _frame, _frames);
 
-	for( fpp_t offset = 0; offset < _frames; ++offset, ++_buf, ++_frame )
+	// Apply the envelope in spans of the same stage: the pre-delay, attack, hold and decay table, the sustain level,
+	// the release table and silence
+	fpp_t offset = 0;
+	while (offset < _frames)
 	{
-		float env_level;
-		if( _frame < _release_begin )
+		const f_cnt_t frame = _frame + offset;
+		const fpp_t left = _frames - offset;
+		fpp_t count;
+
+		if (frame < _release_begin)
 		{
-			if( _frame < m_pahdFrames )
+			const auto untilRelease = static_cast<fpp_t>(std::min<f_cnt_t>(left, _release_begin - frame));
+			if (frame < p.pahdFrames)
 			{
-				env_level = m_pahdEnv[_frame];
+				count = static_cast<fpp_t>(std::min<f_cnt_t>(untilRelease, p.pahdFrames - frame));
+				combineEnvelope(_buf + offset, p.pahdEnv.data() + frame, 1.f, count, p.controlEnvAmount);
 			}
 			else
 			{
-				env_level = m_sustainLevel;
+				count = untilRelease;
+				combineEnvelope(_buf + offset, nullptr, p.sustainLevel, count, p.controlEnvAmount);
 			}
 		}
-		else if( ( _frame - _release_begin ) < m_rFrames )
+		else if (frame - _release_begin < p.rFrames)
 		{
-			env_level = m_rEnv[_frame - _release_begin] *
-				( ( _release_begin < m_pahdFrames ) ?
-				m_pahdEnv[_release_begin] : m_sustainLevel );
+			const f_cnt_t released = frame - _release_begin;
+			count = static_cast<fpp_t>(std::min<f_cnt_t>(left, p.rFrames - released));
+			const float releaseLevel = _release_begin < p.pahdFrames ? p.pahdEnv[_release_begin] : p.sustainLevel;
+			combineEnvelope(_buf + offset, p.rEnv.data() + released, releaseLevel, count, p.controlEnvAmount);
 		}
 		else
 		{
-			env_level = 0.0f;
+			count = left;
+			combineEnvelope(_buf + offset, nullptr, 0.f, count, p.controlEnvAmount);
 		}
 
-		// at this point, *_buf is LFO level
-		*_buf = m_controlEnvAmountModel.value() ?
-			env_level * ( 0.5f + *_buf ) :
-			env_level + *_buf;
+		offset += count;
 	}
 }
 
@@ -399,9 +432,18 @@ void EnvelopeAndLfoParameters::loadSettings( const QDomElement & _this )
 
 
 
+void EnvelopeAndLfoParameters::setLfoUserWave(std::shared_ptr<const SampleBuffer> wave)
+{
+	m_userWave = std::move(wave);
+	updateSampleVars();
+}
+
+
+
+
 void EnvelopeAndLfoParameters::updateSampleVars()
 {
-	QMutexLocker m(&m_paramMutex);
+	auto params = std::make_unique<Params>();
 
 	const float frames_per_env_seg = SECS_PER_ENV_SEGMENT *
 				Engine::audioEngine()->outputSampleRate();
@@ -420,118 +462,91 @@ void EnvelopeAndLfoParameters::updateSampleVars()
 					expKnobVal(m_decayModel.value() *
 					(1 - m_sustainModel.value()))));
 
-	m_sustainLevel = m_sustainModel.value();
-	m_amount = m_amountModel.value();
-	if( m_amount >= 0 )
-	{
-		m_amountAdd = ( 1.0f - m_amount ) * m_valueForZeroAmount;
-	}
-	else
-	{
-		m_amountAdd = m_valueForZeroAmount;
-	}
+	const float sustainLevel = m_sustainModel.value();
+	const float amount = m_amountModel.value();
+	const float amountAdd = amount >= 0 ? (1.0f - amount) * m_valueForZeroAmount : m_valueForZeroAmount;
 
-	m_pahdFrames = predelay_frames + attack_frames + hold_frames +
+	params->pahdFrames = predelay_frames + attack_frames + hold_frames +
 								decay_frames;
-	m_rFrames = static_cast<f_cnt_t>( frames_per_env_seg *
+	params->rFrames = static_cast<f_cnt_t>( frames_per_env_seg *
 					expKnobVal( m_releaseModel.value() ) );
-	m_rFrames = std::max(minimumFrames, m_rFrames);
+	params->rFrames = std::max(minimumFrames, params->rFrames);
 
-	if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
+	if( static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 	{
-		m_rFrames = minimumFrames;
+		params->rFrames = minimumFrames;
 	}
 
-	// if the buffers are too small, make bigger ones - so we only alloc new memory when necessary
-	if( m_pahdBufSize < m_pahdFrames )
-	{
-		sample_t * tmp = m_pahdEnv;
-		m_pahdEnv = new sample_t[m_pahdFrames];
-		delete[] tmp;
-		m_pahdBufSize = m_pahdFrames;
-	}
-	if( m_rBufSize < m_rFrames )
-	{
-		sample_t * tmp = m_rEnv;
-		m_rEnv = new sample_t[m_rFrames];
-		delete[] tmp;
-		m_rBufSize = m_rFrames;
-	}
+	auto& pahdEnv = params->pahdEnv;
+	pahdEnv.resize(params->pahdFrames);
+	params->rEnv.resize(params->rFrames);
 
-	const float aa = m_amountAdd;
-	for( f_cnt_t i = 0; i < predelay_frames; ++i )
-	{
-		m_pahdEnv[i] = aa;
-	}
+	const float aa = amountAdd;
+	std::fill_n(pahdEnv.begin(), predelay_frames, aa);
 
 	f_cnt_t add = predelay_frames;
 
-	const float afI = ( 1.0f / attack_frames ) * m_amount;
+	const float afI = ( 1.0f / attack_frames ) * amount;
 	for( f_cnt_t i = 0; i < attack_frames; ++i )
 	{
-		m_pahdEnv[add+i] = i * afI + aa;
+		pahdEnv[add + i] = i * afI + aa;
 	}
 
 	add += attack_frames;
-	const float amsum = m_amount + m_amountAdd;
-	for( f_cnt_t i = 0; i < hold_frames; ++i )
-	{
-		m_pahdEnv[add + i] = amsum;
-	}
+	const float amsum = amount + amountAdd;
+	std::fill_n(pahdEnv.begin() + add, hold_frames, amsum);
 
 	add += hold_frames;
-	const float dfI = ( 1.0 / decay_frames ) * ( m_sustainLevel -1 ) * m_amount;
+	const float dfI = ( 1.0 / decay_frames ) * ( sustainLevel -1 ) * amount;
 	for( f_cnt_t i = 0; i < decay_frames; ++i )
 	{
-/*
-		m_pahdEnv[add + i] = ( m_sustainLevel + ( 1.0f -
-						(float)i / decay_frames ) *
-						( 1.0f - m_sustainLevel ) ) *
-							m_amount + m_amountAdd;
-*/
-		m_pahdEnv[add + i] = amsum + i*dfI;
+		pahdEnv[add + i] = amsum + i*dfI;
 	}
 
-	const float rfI = ( 1.0f / m_rFrames ) * m_amount;
-	for( f_cnt_t i = 0; i < m_rFrames; ++i )
+	const float rfI = ( 1.0f / params->rFrames ) * amount;
+	for( f_cnt_t i = 0; i < params->rFrames; ++i )
 	{
-		m_rEnv[i] = (float)( m_rFrames - i ) * rfI;
+		params->rEnv[i] = (float)( params->rFrames - i ) * rfI;
 	}
 
 	// save this calculation in real-time-part
-	m_sustainLevel = m_sustainLevel * m_amount + m_amountAdd;
+	params->sustainLevel = sustainLevel * amount + amountAdd;
+	params->controlEnvAmount = m_controlEnvAmountModel.value();
 
 
 	const float frames_per_lfo_oscillation = SECS_PER_LFO_OSCILLATION *
 				Engine::audioEngine()->outputSampleRate();
-	m_lfoPredelayFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	params->lfoPredelayFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
 				expKnobVal( m_lfoPredelayModel.value() ) );
-	m_lfoAttackFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	params->lfoAttackFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
 				expKnobVal( m_lfoAttackModel.value() ) );
-	m_lfoOscillationFrames = static_cast<f_cnt_t>(
+	params->lfoOscillationFrames = static_cast<f_cnt_t>(
 						frames_per_lfo_oscillation *
 						m_lfoSpeedModel.value() );
 	if( m_x100Model.value() )
 	{
-		m_lfoOscillationFrames /= 100;
+		params->lfoOscillationFrames /= 100;
 	}
-	m_lfoAmount = m_lfoAmountModel.value() * 0.5f;
+	params->lfoOscillationFrames = std::max(minimumFrames, params->lfoOscillationFrames);
+	params->lfoAmount = m_lfoAmountModel.value() * 0.5f;
+	params->lfoShape = static_cast<LfoShape>(m_lfoWaveModel.value());
+	params->userWave = m_userWave;
 
-	m_used = true;
-	if( static_cast<int>( floorf( m_lfoAmount * 1000.0f ) ) == 0 )
+	params->used = true;
+	if( static_cast<int>( floorf( params->lfoAmount * 1000.0f ) ) == 0 )
 	{
-		m_lfoAmountIsZero = true;
-		if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
+		params->lfoAmountIsZero = true;
+		if( static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 		{
-			m_used = false;
+			params->used = false;
 		}
 	}
 	else
 	{
-		m_lfoAmountIsZero = false;
+		params->lfoAmountIsZero = false;
 	}
 
-	m_bad_lfoShapeData = true;
+	publish(std::move(params));
 
 	emit dataChanged();
 
@@ -540,6 +555,24 @@ void EnvelopeAndLfoParameters::updateSampleVars()
 
 
 
+void EnvelopeAndLfoParameters::publish(std::unique_ptr<const Params> params)
+{
+	QMutexLocker m(&m_paramMutex);
+
+	// Voices only use parameters during a period. The period is read after the store, so if a voice loaded the
+	// replaced parameters, it did so in this period or an earlier one.
+	m_params.store(params.get());
+	const auto period = s_periods.load();
+
+	// Parameters replaced in a period that is over are unused, and so are all of them while no period is rendered
+	std::erase_if(m_retiredParams, [period](const auto& retired) { return retired.second != period; });
+	if (m_currentParams && period % 2 == 1) { m_retiredParams.emplace_back(std::move(m_currentParams), period); }
+	m_currentParams = std::move(params);
+}
+
+
+
+
 
 
 
@@ -0,0 +1,134 @@
+/*
+ * FrozenAudio.cpp - Cached output of a frozen track
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "FrozenAudio.h"
+
+#include <QDir>
+#include <algorithm>
+#include <cmath>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "SampleFrame.h"
+#include "Song.h"
+
+namespace lmms
+{
+
+
+FrozenAudio::FrozenAudio()
+	: m_sampleRate(Engine::audioEngine()->outputSampleRate())
+	, m_file(QDir::tempPath() + "/lmms-freeze-XXXXXX.raw")
+{
+	m_failed = !m_file.open();
+}
+
+
+
+
+FrozenAudio::~FrozenAudio()
+{
+	if (m_frames) { m_file.unmap(reinterpret_cast<uchar*>(const_cast<SampleFrame*>(m_frames))); }
+}
+
+
+
+
+void FrozenAudio::write(const SampleFrame* buffer, fpp_t frames, double position)
+{
+	if (m_failed) { return; }
+
+	const auto bytes = static_cast<qint64>(frames * sizeof(SampleFrame));
+	if (m_file.write(reinterpret_cast<const char*>(buffer), bytes) != bytes)
+	{
+		m_failed = true;
+		return;
+	}
+
+	m_periods.push_back({position, m_frameCount});
+	m_frameCount += frames;
+}
+
+
+
+
+bool FrozenAudio::finish()
+{
+	if (m_failed || m_frameCount == 0 || !m_file.flush()) { return false; }
+
+	const auto data = m_file.map(0, static_cast<qint64>(m_frameCount * sizeof(SampleFrame)));
+	m_frames = reinterpret_cast<const SampleFrame*>(data);
+	return m_frames != nullptr;
+}
+
+
+
+
+void FrozenAudio::read(SampleFrame* dst, fpp_t frames, double position) const
+{
+	auto available = f_cnt_t{0};
+
+	// Find the rendered period the position falls into
+	const auto next = std::upper_bound(m_periods.begin(), m_periods.end(), position,
+		[](double pos, const Period& period) { return pos < period.position; });
+	if (m_frames && next != m_periods.begin())
+	{
+		const auto& period = *(next - 1);
+		auto frame = static_cast<double>(period.frame);
+		if (next != m_periods.end() && next->position > period.position)
+		{
+			frame += (position - period.position) / (next->position - period.position) * (next->frame - period.frame);
+		}
+		else { frame += (position - period.position) * Engine::framesPerTick(); }
+
+		const auto start = static_cast<f_cnt_t>(std::lround(frame));
+		if (start < m_frameCount)
+		{
+			available = std::min<f_cnt_t>(frames, m_frameCount - start);
+			std::copy_n(m_frames + start, available, dst);
+		}
+	}
+
+	std::fill(dst + available, dst + frames, SampleFrame{});
+}
+
+
+
+
+bool FrozenAudio::isSongPlaying()
+{
+	const auto song = Engine::getSong();
+	return song->playMode() == Song::PlayMode::Song && (song->isPlaying() || song->isExporting());
+}
+
+
+
+
+double FrozenAudio::songPosition()
+{
+	return Engine::getSong()->periodStartPosition();
+}
+
+
+} // namespace lmms
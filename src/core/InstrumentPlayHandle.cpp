@@ -44,6 +44,9 @@ void InstrumentPlayHandle::play(SampleFrame* working_buffer)
 {
 	InstrumentTrack * instrumentTrack = m_instrument->instrumentTrack();
 
+	// The bus handle plays the frozen audio instead
+	if (instrumentTrack->playsFrozen()) { return; }
+
 	// ensure that all our nph's have been processed first
 	auto nphv = NotePlayHandle::nphsOfInstrumentTrack(instrumentTrack, true);
 
@@ -24,6 +24,7 @@
 
 #include <QVarLengthArray>
 #include <QDomElement>
+#include <algorithm>
 
 #include "InstrumentSoundShaping.h"
 #include "AudioEngine.h"
@@ -40,6 +41,18 @@ namespace lmms
 const float CUT_FREQ_MULTIPLIER = 6000.0f;
 const float RES_MULTIPLIER = 2.0f;
 const float RES_PRECISION = 1000.0f;
+//! Frames between updates of the filter coefficients while cutoff or resonance are modulated
+const fpp_t FILTER_CONTROL_INTERVAL = 16;
+
+
+static void filterFrames(BasicFilters<>& filter, SampleFrame* buffer, const fpp_t frames)
+{
+	for (fpp_t frame = 0; frame < frames; ++frame)
+	{
+		buffer[frame][0] = filter.update(buffer[frame][0], 0);
+		buffer[frame][1] = filter.update(buffer[frame][1], 1);
+	}
+}
 
 
 InstrumentSoundShaping::InstrumentSoundShaping(
@@ -118,52 +131,57 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 		envReleaseBegin += frames;
 	}
 
-	// because of optimizations, there's special code for several cases:
-	// 	- cut- and res-lfo/envelope active
-	// 	- cut-lfo/envelope active
-	// 	- res-lfo/envelope active
-	//	- no lfo/envelope active but filter is used
-
-	// only use filter, if it is really needed
-
 	auto& cutoffParameters = getCutoffParameters();
 	auto& resonanceParameters = getResonanceParameters();
 
+	// only use filter, if it is really needed
 	if( m_filterEnabledModel.value() )
 	{
-		QVarLengthArray<float> cutBuffer(frames);
-		QVarLengthArray<float> resBuffer(frames);
-
-		int old_filter_cut = 0;
-		int old_filter_res = 0;
-
 		if( n->m_filter == nullptr )
 		{
-			n->m_filter = std::make_unique<BasicFilters<>>( Engine::audioEngine()->outputSampleRate() );
+			n->m_filter = m_filterPool.make( Engine::audioEngine()->outputSampleRate() );
 		}
 		n->m_filter->setFilterType( static_cast<BasicFilters<>::FilterType>(m_filterModel.value()) );
 
-		if (cutoffParameters.isUsed())
-		{
-			cutoffParameters.fillLevel(cutBuffer.data(), envTotalFrames, envReleaseBegin, frames);
-		}
+		const float fcv = m_filterCutModel.value();
+		const float frv = m_filterResModel.value();
 
-		if (resonanceParameters.isUsed())
+		if (!cutoffParameters.isUsed() && !resonanceParameters.isUsed())
 		{
-			resonanceParameters.fillLevel(resBuffer.data(), envTotalFrames, envReleaseBegin, frames);
+			n->m_filter->calcFilterCoeffs( fcv, frv );
+			filterFrames(*n->m_filter, buffer, frames);
 		}
+		else
+		{
+			QVarLengthArray<float> cutBuffer(frames);
+			QVarLengthArray<float> resBuffer(frames);
 
-		const float fcv = m_filterCutModel.value();
-		const float frv = m_filterResModel.value();
+			if (cutoffParameters.isUsed())
+			{
+				cutoffParameters.fillLevel(cutBuffer.data(), envTotalFrames, envReleaseBegin, frames);
+			}
 
-		if (cutoffParameters.isUsed() && resonanceParameters.isUsed())
-		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
+			if (resonanceParameters.isUsed())
 			{
-				const float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
+				resonanceParameters.fillLevel(resBuffer.data(), envTotalFrames, envReleaseBegin, frames);
+			}
 
-				const float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
+			int old_filter_cut = 0;
+			int old_filter_res = 0;
+
+			// Modulation of cutoff and resonance is applied at control rate, since calculating the coefficients
+			// is far more expensive than filtering. Each block uses the modulation at its center.
+			for (fpp_t start = 0; start < frames; start += FILTER_CONTROL_INTERVAL)
+			{
+				const fpp_t count = std::min(frames - start, FILTER_CONTROL_INTERVAL);
+				const fpp_t center = start + count / 2;
+
+				const float new_cut_val = cutoffParameters.isUsed()
+					? EnvelopeAndLfoParameters::expKnobVal(cutBuffer[center]) * CUT_FREQ_MULTIPLIER + fcv
+					: fcv;
+				const float new_res_val = resonanceParameters.isUsed()
+					? frv + RES_MULTIPLIER * resBuffer[center]
+					: frv;
 
 				if( static_cast<int>( new_cut_val ) != old_filter_cut ||
 					static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
@@ -173,51 +191,7 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
 				}
 
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
-		}
-		else if (cutoffParameters.isUsed())
-		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
-			{
-				float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
-
-				if( static_cast<int>( new_cut_val ) != old_filter_cut )
-				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, frv );
-					old_filter_cut = static_cast<int>( new_cut_val );
-				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
-		}
-		else if(resonanceParameters.isUsed() )
-		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
-			{
-				float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
-
-				if( static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
-				{
-					n->m_filter->calcFilterCoeffs( fcv, new_res_val );
-					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
-				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
-		}
-		else
-		{
-			n->m_filter->calcFilterCoeffs( fcv, frv );
-
-			for( fpp_t frame = 0; frame < frames; ++frame )
-			{
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
+				filterFrames(*n->m_filter, buffer + start, count);
 			}
 		}
 	}
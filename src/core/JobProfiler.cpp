@@ -0,0 +1,294 @@
+/*
+ * JobProfiler.cpp - Per-job processing time statistics of the audio engine
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "JobProfiler.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr auto AggregationInterval = std::chrono::milliseconds{100};
+
+} // namespace
+
+
+JobProfiler::Source::Source(SourceType type, std::function<QString()> name, std::function<SourceId()> parent)
+	: m_id(instance().addSource(type, std::move(name), std::move(parent)))
+{
+}
+
+JobProfiler::Source::~Source()
+{
+	instance().removeSource(m_id);
+}
+
+
+
+
+JobProfiler::JobProfiler() = default;
+
+JobProfiler::~JobProfiler()
+{
+	setEnabled(false);
+}
+
+auto JobProfiler::instance() -> JobProfiler&
+{
+	static auto s_profiler = JobProfiler{};
+	return s_profiler;
+}
+
+
+
+
+void JobProfiler::setEnabled(bool enabled)
+{
+	if (enabled == m_enabled.load(std::memory_order_relaxed)) { return; }
+
+	if (enabled)
+	{
+		m_samples.startDraining(AggregationInterval, [this] { aggregate(); });
+		m_enabled.store(true, std::memory_order_relaxed);
+		return;
+	}
+
+	m_enabled.store(false, std::memory_order_relaxed);
+	m_samples.stopDraining();
+}
+
+
+
+
+void JobProfiler::record(SourceId source, int microseconds)
+{
+	const auto sample = Sample{source, m_period.load(std::memory_order_relaxed), microseconds};
+
+	// Samples are dropped if the aggregator cannot keep up
+	m_samples.local()->ring.write(&sample, 1);
+}
+
+
+
+
+auto JobProfiler::stats() -> std::vector<Stats>
+{
+	aggregate();
+
+	const auto lock = std::lock_guard{m_sourcesMutex};
+
+	auto result = std::vector<Stats>{};
+	for (const auto& [id, source] : m_sources)
+	{
+		if (source.windowFill == 0) { continue; }
+
+		auto times = std::vector<int>(source.window.begin(), source.window.begin() + source.windowFill);
+		const auto sum = std::accumulate(times.begin(), times.end(), 0.f);
+		const auto max = *std::max_element(times.begin(), times.end());
+
+		const auto p99 = times.begin() + (times.size() - 1) * 99 / 100;
+		std::nth_element(times.begin(), p99, times.end());
+
+		result.push_back(Stats{fullName(id), source.type, sum / times.size(), *p99, max, times.size()});
+	}
+
+	std::sort(result.begin(), result.end(), [](const Stats& a, const Stats& b) { return a.meanTime > b.meanTime; });
+	return result;
+}
+
+
+
+
+bool JobProfiler::writeStats(const QString& fileName)
+{
+	auto file = QFile{fileName};
+	if (!file.open(QFile::WriteOnly | QFile::Truncate)) { return false; }
+
+	const auto allStats = stats();
+
+	if (fileName.endsWith(".json", Qt::CaseInsensitive))
+	{
+		auto array = QJsonArray{};
+		for (const auto& stats : allStats)
+		{
+			auto object = QJsonObject{};
+			object["name"] = stats.name;
+			object["type"] = typeName(stats.type);
+			object["mean_us"] = stats.meanTime;
+			object["p99_us"] = stats.p99Time;
+			object["max_us"] = stats.maxTime;
+			object["periods"] = static_cast<qint64>(stats.periods);
+			array.append(object);
+		}
+
+		file.write(QJsonDocument{array}.toJson());
+		return true;
+	}
+
+	auto stream = QTextStream{&file};
+	stream << "name,type,mean_us,p99_us,max_us,periods\n";
+	for (const auto& stats : allStats)
+	{
+		auto name = stats.name;
+		name.replace('"', "\"\"");
+
+		stream << '"' << name << "\"," << typeName(stats.type) << ',' << QString::number(stats.meanTime, 'f', 1)
+			<< ',' << stats.p99Time << ',' << stats.maxTime << ',' << stats.periods << '\n';
+	}
+
+	return true;
+}
+
+
+
+
+auto JobProfiler::sourceName(SourceId source) -> QString
+{
+	const auto lock = std::lock_guard{m_sourcesMutex};
+	return fullName(source);
+}
+
+
+
+
+auto JobProfiler::typeName(SourceType type) -> QString
+{
+	switch (type)
+	{
+		case SourceType::PlayHandles: return "instrument";
+		case SourceType::AudioBus: return "track";
+		case SourceType::Effect: return "effect";
+		case SourceType::MixerChannel: return "mixer";
+	}
+	return {};
+}
+
+
+
+
+auto JobProfiler::addSource(SourceType type, std::function<QString()> name, std::function<SourceId()> parent)
+	-> SourceId
+{
+	const auto lock = std::lock_guard{m_sourcesMutex};
+
+	const auto id = m_nextSourceId++;
+	auto& source = m_sources[id];
+	source.type = type;
+	source.name = std::move(name);
+	source.parent = std::move(parent);
+	return id;
+}
+
+void JobProfiler::removeSource(SourceId id)
+{
+	const auto lock = std::lock_guard{m_sourcesMutex};
+	m_sources.erase(id);
+}
+
+
+
+
+void JobProfiler::aggregate()
+{
+	const auto lock = std::lock_guard{m_sourcesMutex};
+
+	m_samples.forEach([this](ThreadRings<Sample>::Buffer& buffer) {
+		const auto samples = buffer.reader.read_max(m_samples.capacity());
+		for (std::size_t i = 0; i < samples.size(); ++i)
+		{
+			m_pending.push_back(samples[i]);
+		}
+	});
+
+	// Jobs of the current period may still be running, so its samples are left for the next round
+	const auto currentPeriod = m_period.load(std::memory_order_relaxed);
+	const auto unfinished = std::stable_partition(m_pending.begin(), m_pending.end(),
+		[currentPeriod](const Sample& sample) { return sample.period != currentPeriod; });
+	std::stable_sort(m_pending.begin(), unfinished,
+		[](const Sample& a, const Sample& b) { return a.period < b.period; });
+
+	const auto closePeriod = [](SourceData& source) {
+		if (source.openTime < 0) { return; }
+
+		source.window[source.windowPos] = source.openTime;
+		source.windowPos = (source.windowPos + 1) % SourceData::WindowSize;
+		source.windowFill = std::min(source.windowFill + 1, SourceData::WindowSize);
+		source.openTime = -1;
+	};
+
+	for (auto it = m_pending.begin(); it != unfinished; ++it)
+	{
+		const auto source = m_sources.find(it->source);
+		if (source == m_sources.end()) { continue; }
+
+		auto& data = source->second;
+		if (data.openPeriod != it->period)
+		{
+			closePeriod(data);
+			data.openPeriod = it->period;
+			data.openTime = 0;
+		}
+
+		data.openTime += it->microseconds;
+	}
+
+	// All samples of finished periods have been collected by now
+	for (auto& [id, source] : m_sources)
+	{
+		closePeriod(source);
+	}
+
+	m_pending.erase(m_pending.begin(), unfinished);
+}
+
+
+
+
+auto JobProfiler::fullName(SourceId id) const -> QString
+{
+	const auto source = m_sources.find(id);
+	if (source == m_sources.end()) { return {}; }
+
+	auto name = source->second.name ? source->second.name() : QString{};
+	const auto parent = source->second.parent ? source->second.parent() : NoSource;
+	if (parent != NoSource && parent != id)
+	{
+		const auto parentName = fullName(parent);
+		if (!parentName.isEmpty()) { name = parentName + " > " + name; }
+	}
+
+	return name;
+}
+
+} // namespace lmms
@@ -28,6 +28,10 @@
 #include <QDomElement>
 #include <QFileInfo>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "AudioEngine.h"
 #include "Oscillator.h"
 #include "PathUtil.h"
@@ -36,6 +40,52 @@
 namespace lmms
 {
 
+namespace
+{
+
+//! Fill @p values with @p count samples of the wave shape @p sample, starting at @p phase and advancing by @p step.
+//! The wave shape is a template argument so that the loop can be inlined and vectorized by the compiler.
+template<sample_t (*sample)(const float)>
+void fillWave(float* values, float phase, float step, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		values[i] = sample(phase + i * step);
+	}
+}
+
+
+
+
+//! Turn the waveform in @p values into controller values around @p base, scaled by @p amounts, or by @p amount
+//! throughout if @p amounts is nullptr
+void applyAmount(float* values, const float* amounts, float amount, float base, int count)
+{
+	auto i = 0;
+
+#ifdef __SSE__
+	const auto bases = _mm_set1_ps(base);
+	const auto halfAmounts = _mm_set1_ps(amount / 2.0f);
+	const auto half = _mm_set1_ps(0.5f);
+	const auto zero = _mm_setzero_ps();
+	const auto one = _mm_set1_ps(1.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		const auto scales = amounts ? _mm_mul_ps(_mm_loadu_ps(amounts + i), half) : halfAmounts;
+		const auto v = _mm_add_ps(bases, _mm_mul_ps(scales, _mm_loadu_ps(values + i)));
+		_mm_storeu_ps(values + i, _mm_min_ps(_mm_max_ps(v, zero), one));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const auto scale = (amounts ? amounts[i] : amount) / 2.0f;
+		values[i] = std::clamp(base + scale * values[i], 0.0f, 1.0f);
+	}
+}
+
+} // namespace
+
 
 LfoController::LfoController( Model * _parent ) :
 	Controller( ControllerType::Lfo, _parent, tr( "LFO Controller" ) ),
@@ -49,13 +99,9 @@ LfoController::LfoController( Model * _parent ) :
 	m_duration( 1000 ),
 	m_phaseOffset( 0 ),
 	m_currentPhase( 0 ),
-	m_sampleFunction( &Oscillator::sinSample ),
 	m_userDefSampleBuffer(std::make_shared<SampleBuffer>())
 {
 	setSampleExact( true );
-	connect( &m_waveModel, SIGNAL(dataChanged()),
-			this, SLOT(updateSampleFunction()), Qt::DirectConnection );
-
 	connect( &m_speedModel, SIGNAL(dataChanged()),
 			this, SLOT(updateDuration()), Qt::DirectConnection );
 	connect( &m_multiplierModel, SIGNAL(dataChanged()),
@@ -89,7 +135,6 @@ void LfoController::updateValueBuffer()
 {
 	m_phaseOffset = m_phaseModel.value() / 360.0;
 	float phase = m_currentPhase + m_phaseOffset;
-	float phasePrev = 0.0f;
 
 	// roll phase up until we're in sync with period counter
 	m_bufferLastUpdated++;
@@ -100,49 +145,61 @@ void LfoController::updateValueBuffer()
 		m_bufferLastUpdated += diff;
 	}
 
-	float amount = m_amountModel.value();
-	ValueBuffer *amountBuffer = m_amountModel.valueBuffer();
-	int amountInc = amountBuffer ? 1 : 0;
-	float *amountPtr = amountBuffer ? &(amountBuffer->values()[ 0 ] ) : &amount;
-	Oscillator::WaveShape waveshape = static_cast<Oscillator::WaveShape>(m_waveModel.value());
+	float* values = m_valueBuffer.values();
+	const int frames = m_valueBuffer.length();
+	const float step = 1.0f / m_duration;
 
-	for( float& f : m_valueBuffer )
+	// Render the raw waveform first, with one loop per wave shape
+	switch (static_cast<Oscillator::WaveShape>(m_waveModel.value()))
 	{
-		float currentSample = 0;
-		switch (waveshape)
-		{
+		case Oscillator::WaveShape::Sine:
+		default:
+			fillWave<&Oscillator::sinSample>(values, phase, step, frames);
+			break;
+		case Oscillator::WaveShape::Triangle:
+			fillWave<&Oscillator::triangleSample>(values, phase, step, frames);
+			break;
+		case Oscillator::WaveShape::Saw:
+			fillWave<&Oscillator::sawSample>(values, phase, step, frames);
+			break;
+		case Oscillator::WaveShape::Square:
+			fillWave<&Oscillator::squareSample>(values, phase, step, frames);
+			break;
+		case Oscillator::WaveShape::MoogSaw:
+			fillWave<&Oscillator::moogSawSample>(values, phase, step, frames);
+			break;
+		case Oscillator::WaveShape::Exponential:
+			fillWave<&Oscillator::expSample>(values, phase, step, frames);
+			break;
 		case Oscillator::WaveShape::WhiteNoise:
 		{
-			if (absFraction(phase) < absFraction(phasePrev))
+			float phasePrev = 0.0f;
+			for (int i = 0; i < frames; ++i)
 			{
-				// Resample when phase period has completed
-				m_heldSample = m_sampleFunction(phase);
+				const float currentPhase = phase + i * step;
+				if (absFraction(currentPhase) < absFraction(phasePrev))
+				{
+					// Resample when phase period has completed
+					m_heldSample = Oscillator::noiseSample(currentPhase);
+				}
+				values[i] = m_heldSample;
+				phasePrev = currentPhase;
 			}
-			currentSample = m_heldSample;
 			break;
 		}
 		case Oscillator::WaveShape::UserDefined:
-		{
-			currentSample = Oscillator::userWaveSample(m_userDefSampleBuffer.get(), phase);
-			break;
-		}
-		default:
-		{
-			if (m_sampleFunction != nullptr)
+			for (int i = 0; i < frames; ++i)
 			{
-				currentSample = m_sampleFunction(phase);
+				values[i] = Oscillator::userWaveSample(m_userDefSampleBuffer.get(), phase + i * step);
 			}
-		}
+			break;
 	}
 
-		f = std::clamp(m_baseModel.value() + (*amountPtr * currentSample / 2.0f), 0.0f, 1.0f);
+	const ValueBuffer* amountBuffer = m_amountModel.valueBuffer();
+	applyAmount(values, amountBuffer ? amountBuffer->values() : nullptr, m_amountModel.value(), m_baseModel.value(),
+		frames);
 
-		phasePrev = phase;
-		phase += 1.0 / m_duration;
-		amountPtr += amountInc;
-	}
-
-	m_currentPhase = absFraction(phase - m_phaseOffset);
+	m_currentPhase = absFraction(phase + frames * step - m_phaseOffset);
 	m_bufferLastUpdated = s_periods;
 }
 
@@ -174,43 +231,6 @@ void LfoController::updateDuration()
 	m_duration = newDurationF;
 }
 
-void LfoController::updateSampleFunction()
-{
-	switch( static_cast<Oscillator::WaveShape>(m_waveModel.value()) )
-	{
-		case Oscillator::WaveShape::Sine:
-		default:
-			m_sampleFunction = &Oscillator::sinSample;
-			break;
-		case Oscillator::WaveShape::Triangle:
-			m_sampleFunction = &Oscillator::triangleSample;
-			break;
-		case Oscillator::WaveShape::Saw:
-			m_sampleFunction = &Oscillator::sawSample;
-			break;
-		case Oscillator::WaveShape::Square:
-			m_sampleFunction = &Oscillator::squareSample;
-			break;
-		case Oscillator::WaveShape::MoogSaw:
-			m_sampleFunction = &Oscillator::moogSawSample;
-			break;
-		case Oscillator::WaveShape::Exponential:
-			m_sampleFunction = &Oscillator::expSample;
-			break;
-		case Oscillator::WaveShape::WhiteNoise:
-			m_sampleFunction = &Oscillator::noiseSample;
-			break;
-		case Oscillator::WaveShape::UserDefined:
-			m_sampleFunction = nullptr;
-			/*TODO: If C++11 is allowed, should change the type of
-			 m_sampleFunction be std::function<sample_t(const float)>
-			 and use the line below:
-			*/
-			//m_sampleFunction = &(m_userDefSampleBuffer->userWaveSample)
-			break;
-	}
-}
-
 
 
 void LfoController::saveSettings( QDomDocument & _doc, QDomElement & _this )
@@ -247,8 +267,6 @@ void LfoController::loadSettings( const QDomElement & _this )
 		}
 		else { Engine::getSong()->collectError(QString("%1: %2").arg(tr("Sample not found"), userWaveFile)); }
 	}
-
-	updateSampleFunction();
 }
 
 
@@ -28,8 +28,13 @@
 #include <cstdio>
 #endif
 
+#include <algorithm>
 #include <cmath>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "ValueBuffer.h"
 #include "SampleFrame.h"
 
@@ -123,6 +128,39 @@ bool sanitize( SampleFrame* src, int frames )
 	return false;
 }
 
+sample_t sanitizeAndGetPeak(SampleFrame* src, int frames)
+{
+	auto peak = sample_t{0};
+
+	if (!useNaNHandler())
+	{
+		for (int f = 0; f < frames; ++f)
+		{
+			peak = std::max({peak, std::abs(src[f].left()), std::abs(src[f].right())});
+		}
+		return peak;
+	}
+
+	// Branchless so that the loop can be vectorized; a bad frame clears the whole buffer afterwards anyway
+	bool badData = false;
+	for (int f = 0; f < frames; ++f)
+	{
+		auto& currentFrame = src[f];
+		badData |= !std::isfinite(currentFrame.left()) | !std::isfinite(currentFrame.right());
+
+		currentFrame.clamp(sample_t(-1000.0), sample_t(1000.0));
+		peak = std::max({peak, std::abs(currentFrame.left()), std::abs(currentFrame.right())});
+	}
+
+	if (badData)
+	{
+		zeroSampleFrames(src, frames);
+		return 0;
+	}
+
+	return peak;
+}
+
 
 struct AddOp
 {
@@ -329,5 +367,49 @@ void multiplyAndAddMultipliedJoined( SampleFrame* dst,
 	run<>( dst, srcLeft, srcRight, frames, MultiplyAndAddMultipliedOp(coeffDst, coeffSrc) );
 }
 
+
+
+
+void deinterleave(const SampleFrame* src, sample_t* dstLeft, sample_t* dstRight, int frames)
+{
+	int f = 0;
+#ifdef __SSE__
+	for (; f + 4 <= frames; f += 4)
+	{
+		const auto first = _mm_loadu_ps(&src[f][0]);
+		const auto second = _mm_loadu_ps(&src[f + 2][0]);
+		_mm_storeu_ps(dstLeft + f, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(dstRight + f, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+#endif
+	for (; f < frames; ++f)
+	{
+		dstLeft[f] = src[f][0];
+		dstRight[f] = src[f][1];
+	}
+}
+
+
+
+
+void interleave(const sample_t* srcLeft, const sample_t* srcRight, SampleFrame* dst, int frames)
+{
+	int f = 0;
+#ifdef __SSE__
+	for (; f + 4 <= frames; f += 4)
+	{
+		const auto left = _mm_loadu_ps(srcLeft + f);
+		const auto right = _mm_loadu_ps(srcRight + f);
+		_mm_storeu_ps(&dst[f][0], _mm_unpacklo_ps(left, right));
+		_mm_storeu_ps(&dst[f + 2][0], _mm_unpackhi_ps(left, right));
+	}
+#endif
+	for (; f < frames; ++f)
+	{
+		dst[f][0] = srcLeft[f];
+		dst[f][1] = srcRight[f];
+	}
+}
+
 } // namespace lmms::MixHelpers
 
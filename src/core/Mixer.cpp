@@ -71,8 +71,13 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_lock(),
 	m_queued( false ),
 	m_dependenciesMet(0),
-	m_channelIndex(idx)
+	m_channelIndex(idx),
+	m_profilerSource(JobProfiler::SourceType::MixerChannel, [this] {
+		if (!m_name.isEmpty()) { return m_name; }
+		return isMaster() ? QString{"Master"} : QString{"Channel %1"}.arg(m_channelIndex);
+	})
 {
+	m_fxChain.setProfilerOwner(m_profilerSource.id());
 	zeroSampleFrames(m_buffer, Engine::audioEngine()->framesPerPeriod());
 }
 
@@ -0,0 +1,85 @@
+/*
+ * NoteIndex.cpp - Lookup of the notes of a clip by time and key
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include "NoteIndex.h"
+
+#include <algorithm>
+
+#include "AutomationClip.h"
+#include "DetuningHelper.h"
+
+namespace lmms
+{
+
+
+void NoteIndex::rebuild(const NoteVector& notes)
+{
+	m_index.rebuild(notes, [](const Note* note) {
+		auto length = note->length().getTicks();
+		if (length < 0) { length = 4; }
+		if (note->detuning())
+		{
+			const auto& detuning = note->detuning()->automationClip()->getTimeMap();
+			if (!detuning.isEmpty()) { length = std::max<tick_t>(length, detuning.lastKey()); }
+		}
+		return std::pair{note->pos().getTicks(), note->pos().getTicks() + length};
+	});
+}
+
+
+
+
+void NoteIndex::clear()
+{
+	m_index.clear();
+}
+
+
+
+
+NoteVector NoteIndex::notesInRange(tick_t first, tick_t last) const
+{
+	auto result = NoteVector{};
+	m_index.forEachInRange(first, last, [&](Note* note) { result.push_back(note); });
+	return result;
+}
+
+
+
+
+NoteVector NoteIndex::notesAt(tick_t tick, int key) const
+{
+	auto result = NoteVector{};
+	m_index.forEachInRange(tick, tick, [&](Note* note) {
+		if (note->key() == key && note->length() > 0 && tick <= note->endPos().getTicks())
+		{
+			result.push_back(note);
+		}
+	});
+	return result;
+}
+
+
+} // namespace lmms
@@ -26,11 +26,16 @@
 #include "Oscillator.h"
 
 #include <algorithm>
+#include <cstdint>
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
 	#include <thread>
 #endif
 #include <numbers>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "Engine.h"
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
@@ -548,6 +553,116 @@ inline void Oscillator::recalcPhase()
 		m_phase += m_phaseOffset;
 	}
 	m_phase = absFraction( m_phase );
+
+	const float frequency = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate();
+	m_waveTableBand = waveTableBandFromFreq(frequency);
+	m_sineAboveMaxFreq = m_useWaveTable && frequency >= OscillatorConstants::MAX_FREQ;
+}
+
+
+
+
+template<Oscillator::WaveShape W>
+inline const sample_t* Oscillator::bandLimitedTable() const
+{
+	if (!m_useWaveTable || m_isModulator) { return nullptr; }
+
+	if constexpr (W == WaveShape::UserDefined)
+	{
+		return m_userAntiAliasWaveTable ? (*m_userAntiAliasWaveTable)[m_waveTableBand].data() : nullptr;
+	}
+	else if constexpr (W == WaveShape::Sine || W == WaveShape::WhiteNoise)
+	{
+		return nullptr;
+	}
+	else
+	{
+		return s_waveTables[static_cast<std::size_t>(W) - FirstWaveShapeTable][m_waveTableBand];
+	}
+}
+
+
+
+
+inline sample_t Oscillator::tableSample(const sample_t* table, const float sample)
+{
+	const float frame = absFraction(sample) * OscillatorConstants::WAVETABLE_LENGTH;
+	const auto f1 = static_cast<f_cnt_t>(frame);
+	const auto f2 = f1 < OscillatorConstants::WAVETABLE_LENGTH - 1 ? f1 + 1 : 0;
+	return std::lerp(table[f1], table[f2], fraction(frame));
+}
+
+
+
+
+void Oscillator::renderTable(const sample_t* table, const float increment, sample_t* out, const fpp_t frames)
+{
+	fpp_t frame = 0;
+
+#ifdef __SSE2__
+	// Same as tableSample(), but four frames at a time. Only the table lookups are done per frame.
+	constexpr auto length = OscillatorConstants::WAVETABLE_LENGTH;
+	const auto at = [table](std::int32_t index) { return table[index < length ? index : index - length]; };
+
+	const auto lengths = _mm_set1_ps(static_cast<float>(length));
+	const auto steps = _mm_set1_ps(4 * increment);
+	auto phases = _mm_add_ps(_mm_set1_ps(m_phase), _mm_mul_ps(_mm_set1_ps(increment), _mm_setr_ps(0, 1, 2, 3)));
+
+	for (; frame + 4 <= frames; frame += 4)
+	{
+		// The phase starts in [0, 1) and only grows during an update, so truncation yields whole periods
+		const auto fractions = _mm_sub_ps(phases, _mm_cvtepi32_ps(_mm_cvttps_epi32(phases)));
+		const auto positions = _mm_mul_ps(fractions, lengths);
+		const auto indices = _mm_cvttps_epi32(positions);
+		const auto weights = _mm_sub_ps(positions, _mm_cvtepi32_ps(indices));
+
+		alignas(16) auto i = std::array<std::int32_t, 4>{};
+		_mm_store_si128(reinterpret_cast<__m128i*>(i.data()), indices);
+
+		const auto a = _mm_setr_ps(at(i[0]), at(i[1]), at(i[2]), at(i[3]));
+		const auto b = _mm_setr_ps(at(i[0] + 1), at(i[1] + 1), at(i[2] + 1), at(i[3] + 1));
+		_mm_storeu_ps(out + frame, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), weights)));
+
+		phases = _mm_add_ps(phases, steps);
+	}
+	m_phase += frame * increment;
+#endif
+
+	for (; frame < frames; ++frame)
+	{
+		out[frame] = tableSample(table, m_phase);
+		m_phase += increment;
+	}
+}
+
+
+
+
+template<Oscillator::WaveShape W, typename Combine>
+inline void Oscillator::renderUnmodulated(SampleFrame* ab, const fpp_t frames, const ch_cnt_t chnl,
+	const float increment, Combine combine)
+{
+	const auto table = bandLimitedTable<W>();
+	if (!table)
+	{
+		for (fpp_t frame = 0; frame < frames; ++frame)
+		{
+			combine(ab[frame][chnl], getSample<W>(m_phase) * m_volume);
+			m_phase += increment;
+		}
+		return;
+	}
+
+	auto block = std::array<sample_t, RenderBlockSize>{};
+	for (fpp_t start = 0; start < frames; start += RenderBlockSize)
+	{
+		const auto count = std::min(frames - start, RenderBlockSize);
+		renderTable(table, increment, block.data(), count);
+		for (fpp_t frame = 0; frame < count; ++frame)
+		{
+			combine(ab[start + frame][chnl], block[frame] * m_volume);
+		}
+	}
 }
 
 
@@ -586,11 +701,7 @@ void Oscillator::updateNoSub( SampleFrame* _ab, const fpp_t _frames,
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	renderUnmodulated<W>(_ab, _frames, _chnl, osc_coeff, [](sample_t& out, sample_t sample) { out = sample; });
 }
 
 
@@ -626,11 +737,7 @@ void Oscillator::updateAM( SampleFrame* _ab, const fpp_t _frames,
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] *= getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	renderUnmodulated<W>(_ab, _frames, _chnl, osc_coeff, [](sample_t& out, sample_t sample) { out *= sample; });
 }
 
 
@@ -645,11 +752,7 @@ void Oscillator::updateMix( SampleFrame* _ab, const fpp_t _frames,
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] += getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	renderUnmodulated<W>(_ab, _frames, _chnl, osc_coeff, [](sample_t& out, sample_t sample) { out += sample; });
 }
 
 
@@ -703,16 +806,7 @@ void Oscillator::updateFM( SampleFrame* _ab, const fpp_t _frames,
 template<>
 inline sample_t Oscillator::getSample<Oscillator::WaveShape::Sine>(const float sample)
 {
-	const float current_freq = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate();
-
-	if (!m_useWaveTable || current_freq < OscillatorConstants::MAX_FREQ)
-	{
-		return sinSample(sample);
-	}
-	else
-	{
-		return 0;
-	}
+	return m_sineAboveMaxFreq ? 0 : sinSample(sample);
 }
 
 
@@ -722,14 +816,8 @@ template<>
 inline sample_t Oscillator::getSample<Oscillator::WaveShape::Triangle>(
 		const float _sample )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Triangle) - FirstWaveShapeTable],_sample);
-	}
-	else
-	{
-		return triangleSample(_sample);
-	}
+	if (const auto table = bandLimitedTable<WaveShape::Triangle>()) { return tableSample(table, _sample); }
+	return triangleSample(_sample);
 }
 
 
@@ -739,14 +827,8 @@ template<>
 inline sample_t Oscillator::getSample<Oscillator::WaveShape::Saw>(
 		const float _sample )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Saw) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return sawSample(_sample);
-	}
+	if (const auto table = bandLimitedTable<WaveShape::Saw>()) { return tableSample(table, _sample); }
+	return sawSample(_sample);
 }
 
 
@@ -756,14 +838,8 @@ template<>
 inline sample_t Oscillator::getSample<Oscillator::WaveShape::Square>(
 		const float _sample )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Square) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return squareSample(_sample);
-	}
+	if (const auto table = bandLimitedTable<WaveShape::Square>()) { return tableSample(table, _sample); }
+	return squareSample(_sample);
 }
 
 
@@ -773,14 +849,8 @@ template<>
 inline sample_t Oscillator::getSample<Oscillator::WaveShape::MoogSaw>(
 							const float _sample )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return moogSawSample(_sample);
-	}
+	if (const auto table = bandLimitedTable<WaveShape::MoogSaw>()) { return tableSample(table, _sample); }
+	return moogSawSample(_sample);
 }
 
 
@@ -790,14 +860,8 @@ template<>
 inline sample_t Oscillator::getSample<Oscillator::WaveShape::Exponential>(
 							const float _sample )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return expSample(_sample);
-	}
+	if (const auto table = bandLimitedTable<WaveShape::Exponential>()) { return tableSample(table, _sample); }
+	return expSample(_sample);
 }
 
 
@@ -817,14 +881,8 @@ template<>
 inline sample_t Oscillator::getSample<Oscillator::WaveShape::UserDefined>(
 							const float _sample )
 {
-	if (m_useWaveTable && m_userAntiAliasWaveTable && !m_isModulator)
-	{
-		return wtSample(m_userAntiAliasWaveTable.get(), _sample);
-	}
-	else
-	{
-		return userWaveSample(m_userWave.get(), _sample);
-	}
+	if (const auto table = bandLimitedTable<WaveShape::UserDefined>()) { return tableSample(table, _sample); }
+	return userWaveSample(m_userWave.get(), _sample);
 }
 
 
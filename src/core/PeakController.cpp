@@ -29,6 +29,10 @@
 #include <QDomElement>
 #include <QMessageBox>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "AudioEngine.h"
 #include "EffectChain.h"
 #include "plugins/PeakControllerEffect/PeakControllerEffect.h"
@@ -36,6 +40,42 @@
 namespace lmms
 {
 
+namespace
+{
+
+//! Fill @p values with a one-pole filter moving from @p start towards @p target, keeping 1 - @p coeff of the
+//! remaining distance per frame. Uses the closed form target - (target - start) * (1 - coeff)^(f + 1), so that
+//! frames don't depend on each other.
+void approachTarget(float* values, float start, float target, float coeff, f_cnt_t count)
+{
+	const float diff = target - start;
+	const float ratio = 1.0f - coeff;
+	auto f = f_cnt_t{0};
+	float power = ratio;
+
+#ifdef __SSE__
+	const float ratio2 = ratio * ratio;
+	const auto targets = _mm_set1_ps(target);
+	const auto diffs = _mm_set1_ps(diff);
+	const auto ratios4 = _mm_set1_ps(ratio2 * ratio2);
+	auto powers = _mm_setr_ps(ratio, ratio2, ratio2 * ratio, ratio2 * ratio2);
+	for (; f + 4 <= count; f += 4)
+	{
+		_mm_storeu_ps(values + f, _mm_sub_ps(targets, _mm_mul_ps(diffs, powers)));
+		powers = _mm_mul_ps(powers, ratios4);
+	}
+	power = _mm_cvtss_f32(powers);
+#endif
+
+	for (; f < count; ++f)
+	{
+		values[f] = target - diff * power;
+		power *= ratio;
+	}
+}
+
+} // namespace
+
 
 PeakControllerEffectVector PeakController::s_effects;
 int PeakController::m_getCount;
@@ -93,19 +133,10 @@ void PeakController::updateValueBuffer()
 			const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
 			float * values = m_valueBuffer.values();
 
-			for( f_cnt_t f = 0; f < frames; ++f )
-			{
-				const float diff = ( targetSample - m_currentSample );
-				if( m_currentSample < targetSample ) // going up...
-				{
-					m_currentSample += diff * m_attackCoeff;
-				}
-				else if( m_currentSample > targetSample ) // going down
-				{
-					m_currentSample += diff * m_decayCoeff;
-				}
-				values[f] = m_currentSample;
-			}
+			// The filter never overshoots, so the direction is the same for the whole period
+			const float coeff = m_currentSample < targetSample ? m_attackCoeff : m_decayCoeff;
+			approachTarget(values, m_currentSample, targetSample, coeff, frames);
+			m_currentSample = values[frames - 1];
 		}
 		else
 		{
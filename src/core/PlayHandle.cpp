@@ -23,6 +23,7 @@
  */
  
 #include "PlayHandle.h"
+#include "AudioBusHandle.h"
 #include "AudioEngine.h"
 #include "BufferManager.h"
 #include "Engine.h"
@@ -39,7 +40,8 @@ PlayHandle::PlayHandle(const Type type, f_cnt_t offset) :
 		m_affinity(QThread::currentThread()),
 		m_playHandleBuffer(BufferManager::acquire()),
 		m_bufferReleased(true),
-		m_usesBuffer(true)
+		m_usesBuffer(true),
+		m_audioBusHandle(nullptr)
 {
 }
 
@@ -65,6 +67,12 @@ void PlayHandle::doProcessing()
 }
 
 
+JobProfiler::SourceId PlayHandle::profilerSource() const
+{
+	return m_audioBusHandle ? m_audioBusHandle->playHandlesProfilerSource() : JobProfiler::NoSource;
+}
+
+
 void PlayHandle::releaseBuffer()
 {
 	m_bufferReleased = true;
@@ -26,6 +26,7 @@
 
 #include "PresetPreviewPlayHandle.h"
 #include "AudioEngine.h"
+#include "DataFile.h"
 #include "Engine.h"
 #include "Instrument.h"
 #include "InstrumentTrack.h"
@@ -0,0 +1,365 @@
+/*
+ * ProjectContainer.cpp - Chunked binary storage for projects
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ProjectContainer.h"
+
+#include <QDataStream>
+#include <QDomDocument>
+#include <QTextStream>
+#include <QtEndian>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+
+#include "DeprecationHelper.h"
+#include "ThreadPool.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr auto Magic = std::array<char, 8>{'L', 'M', 'M', 'S', 'P', 'R', 'J', 'B'};
+constexpr auto FormatVersion = quint32{1};
+
+constexpr auto HeaderSize = quint64{16};	//!< Magic, format version and number of sections
+constexpr auto EntrySize = quint64{24};		//!< Type, flags, offset and size of a section
+//! Alignment of all sections, so that embedded samples can be read from the mapped file as they are
+constexpr auto SectionAlignment = quint64{16};
+
+constexpr auto Compressed = quint32{1};
+
+//! Elements that are stored as sections of their own
+const auto ElementSectionTags = std::array<QString, 5>{"track", "midiclip", "automationclip", "sampleclip", "patternclip"};
+const auto SectionPlaceholderTag = QString{"lmms-section"};
+
+//! Attributes holding base64 encoded data, which is stored as raw data in containers
+const auto ElementsWithBlobs = std::map<QString, std::vector<QString>>{
+	{"sampleclip", {"data"}},
+	{"audiofileprocessor", {"sampledata"}},
+	{"slicert", {"sampledata"}},
+};
+
+//! Blob references are "lmms-blob:<section>" in files and "lmms-blob:<container>:<section>" once loaded
+const auto BlobPrefix = QString{"lmms-blob:"};
+
+std::mutex s_containersMutex;
+std::map<quint64, const ProjectContainer*> s_containers;
+std::atomic<quint64> s_nextSerial = 0;
+
+
+quint64 aligned(quint64 offset)
+{
+	return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+}
+
+
+//! Call @p func with every attribute holding embedded data in @p document, and its value
+template<typename Func>
+void forEachBlobAttribute(QDomDocument& document, Func func)
+{
+	for (const auto& [tagName, attributes] : ElementsWithBlobs)
+	{
+		const auto elements = document.elementsByTagName(tagName);
+		for (int i = 0; i < elements.size(); ++i)
+		{
+			auto element = elements.item(i).toElement();
+			for (const auto& attribute : attributes)
+			{
+				const auto value = element.attribute(attribute);
+				if (!value.isEmpty()) { func(element, attribute, value); }
+			}
+		}
+	}
+}
+
+
+struct PendingSection
+{
+	ProjectContainer::SectionType type;
+	quint32 flags;
+	QByteArray data;
+};
+
+
+//! Move the section elements below @p parent into sections of their own, innermost first
+void extractSections(QDomElement parent, std::vector<PendingSection>& sections)
+{
+	auto child = parent.firstChildElement();
+	while (!child.isNull())
+	{
+		const auto next = child.nextSiblingElement();
+		extractSections(child, sections);
+
+		if (std::find(ElementSectionTags.begin(), ElementSectionTags.end(), child.tagName()) != ElementSectionTags.end())
+		{
+			auto xml = QString{};
+			auto stream = QTextStream{&xml};
+			child.save(stream, -1);
+			stream.flush();
+
+			auto placeholder = parent.ownerDocument().createElement(SectionPlaceholderTag);
+			placeholder.setAttribute("index", static_cast<qulonglong>(sections.size()));
+			parent.replaceChild(placeholder, child);
+
+			sections.push_back({ProjectContainer::SectionType::Element, Compressed, qCompress(xml.toUtf8())});
+		}
+
+		child = next;
+	}
+}
+
+} // namespace
+
+
+
+
+ProjectContainer::ProjectContainer(const QString& fileName)
+	: m_file(fileName)
+	, m_serial(s_nextSerial++)
+{
+	if (!m_file.open(QIODevice::ReadOnly)) { return; }
+
+	const auto fileSize = static_cast<quint64>(m_file.size());
+	if (fileSize < HeaderSize) { return; }
+
+	const auto data = m_file.map(0, m_file.size());
+	if (data == nullptr || std::memcmp(data, Magic.data(), Magic.size()) != 0) { return; }
+
+	const auto version = qFromLittleEndian<quint32>(data + 8);
+	const auto count = quint64{qFromLittleEndian<quint32>(data + 12)};
+	if (version > FormatVersion || HeaderSize + count * EntrySize > fileSize) { return; }
+
+	for (auto i = quint64{0}; i < count; ++i)
+	{
+		const auto entry = data + HeaderSize + i * EntrySize;
+		const auto section = Section{
+			static_cast<SectionType>(qFromLittleEndian<quint32>(entry)),
+			qFromLittleEndian<quint32>(entry + 4),
+			qFromLittleEndian<quint64>(entry + 8),
+			qFromLittleEndian<quint64>(entry + 16)
+		};
+		if (section.offset > fileSize || section.size > fileSize - section.offset) { return; }
+		m_sections.push_back(section);
+	}
+	if (m_sections.empty() || m_sections.front().type != SectionType::Document) { return; }
+
+	m_data = data;
+
+	const auto lock = std::lock_guard{s_containersMutex};
+	s_containers[m_serial] = this;
+}
+
+
+
+
+ProjectContainer::~ProjectContainer()
+{
+	const auto lock = std::lock_guard{s_containersMutex};
+	s_containers.erase(m_serial);
+}
+
+
+
+
+bool ProjectContainer::read(QDomDocument& document, QString* errorMsg) const
+{
+	if (!isValid()) { return false; }
+
+	// Parse all sections in parallel, the document itself on this thread
+	auto parsed = std::vector<QDomDocument>(m_sections.size());
+	auto pending = std::vector<std::future<bool>>{};
+	for (auto i = std::size_t{1}; i < m_sections.size(); ++i)
+	{
+		if (m_sections[i].type != SectionType::Element) { continue; }
+		pending.push_back(ThreadPool::instance().enqueue([this, i, &parsed] {
+			return parseSection(i, parsed[i], nullptr);
+		}));
+	}
+
+	auto success = parseSection(0, document, errorMsg);
+	for (auto& result : pending)
+	{
+		success = result.get() && success;
+	}
+	if (!success) { return false; }
+
+	// Put the sections back in place of their placeholders, which sections may contain as well
+	auto used = std::vector<bool>(m_sections.size());
+	auto placeholders = std::vector<QDomElement>{};
+	const auto collectPlaceholders = [&placeholders](const QDomElement& root) {
+		const auto elements = root.elementsByTagName(SectionPlaceholderTag);
+		for (int i = 0; i < elements.size(); ++i)
+		{
+			placeholders.push_back(elements.item(i).toElement());
+		}
+	};
+
+	collectPlaceholders(document.documentElement());
+	while (!placeholders.empty())
+	{
+		const auto placeholder = placeholders.back();
+		placeholders.pop_back();
+
+		const auto index = placeholder.attribute("index").toULongLong();
+		if (index >= m_sections.size() || m_sections[index].type != SectionType::Element || used[index])
+		{
+			if (errorMsg) { *errorMsg = QString{"Invalid section %1"}.arg(index); }
+			return false;
+		}
+		used[index] = true;
+
+		const auto element = document.importNode(parsed[index].documentElement(), true).toElement();
+		placeholder.parentNode().replaceChild(element, placeholder);
+		collectPlaceholders(element);
+	}
+
+	// Make the blob references refer to this container
+	forEachBlobAttribute(document, [this](QDomElement& element, const QString& attribute, const QString& value) {
+		if (isBlobReference(value))
+		{
+			element.setAttribute(attribute, BlobPrefix + QString::number(m_serial) + ':' + value.mid(BlobPrefix.size()));
+		}
+	});
+
+	return true;
+}
+
+
+
+
+bool ProjectContainer::parseSection(std::size_t index, QDomDocument& document, QString* errorMsg) const
+{
+	const auto& section = m_sections[index];
+	auto data = QByteArray::fromRawData(
+		reinterpret_cast<const char*>(m_data + section.offset), static_cast<qsizetype>(section.size));
+	if (section.flags & Compressed) { data = qUncompress(data); }
+
+	int line = -1, col = -1;
+	return lmms::setContent(document, data, errorMsg, &line, &col);
+}
+
+
+
+
+bool ProjectContainer::write(const QDomDocument& document, QIODevice& device)
+{
+	auto copy = document.cloneNode(true).toDocument();
+
+	// The document goes first
+	auto sections = std::vector<PendingSection>(1);
+
+	forEachBlobAttribute(copy, [&sections](QDomElement& element, const QString& attribute, const QString& value) {
+		auto data = isBlobReference(value) ? blob(value) : QByteArray::fromBase64(value.toLatin1());
+		element.setAttribute(attribute, BlobPrefix + QString::number(sections.size()));
+		sections.push_back({SectionType::Blob, 0, std::move(data)});
+	});
+
+	extractSections(copy.documentElement(), sections);
+
+	sections[0] = {SectionType::Document, Compressed, qCompress(copy.toByteArray(-1))};
+
+	auto header = QByteArray{};
+	auto stream = QDataStream{&header, QIODevice::WriteOnly};
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData(Magic.data(), Magic.size());
+	stream << FormatVersion << static_cast<quint32>(sections.size());
+
+	auto offsets = std::vector<quint64>{};
+	auto offset = HeaderSize + EntrySize * sections.size();
+	for (const auto& section : sections)
+	{
+		offset = aligned(offset);
+		offsets.push_back(offset);
+		stream << static_cast<quint32>(section.type) << section.flags << offset << static_cast<quint64>(section.data.size());
+		offset += section.data.size();
+	}
+
+	if (device.write(header) != header.size()) { return false; }
+
+	auto position = static_cast<quint64>(header.size());
+	for (std::size_t i = 0; i < sections.size(); ++i)
+	{
+		const auto padding = QByteArray(static_cast<qsizetype>(offsets[i] - position), '\0');
+		const auto& data = sections[i].data;
+		if (device.write(padding) != padding.size() || device.write(data) != data.size()) { return false; }
+		position = offsets[i] + data.size();
+	}
+
+	return true;
+}
+
+
+
+
+bool ProjectContainer::isContainer(QIODevice& device)
+{
+	return device.peek(Magic.size()) == QByteArray(Magic.data(), Magic.size());
+}
+
+
+
+
+bool ProjectContainer::isBlobReference(const QString& value)
+{
+	return value.startsWith(BlobPrefix);
+}
+
+
+
+
+QByteArray ProjectContainer::blob(const QString& reference)
+{
+	const auto serial = reference.section(':', 1, 1).toULongLong();
+	const auto index = reference.section(':', 2, 2).toULongLong();
+
+	const auto lock = std::lock_guard{s_containersMutex};
+	const auto it = s_containers.find(serial);
+	if (it == s_containers.end()) { return {}; }
+
+	const auto container = it->second;
+	if (index >= container->m_sections.size() || container->m_sections[index].type != SectionType::Blob) { return {}; }
+
+	const auto& section = container->m_sections[index];
+	return QByteArray::fromRawData(
+		reinterpret_cast<const char*>(container->m_data + section.offset), static_cast<qsizetype>(section.size));
+}
+
+
+
+
+void ProjectContainer::expandBlobs(QDomDocument& document)
+{
+	forEachBlobAttribute(document, [](QDomElement& element, const QString& attribute, const QString& value) {
+		if (isBlobReference(value)) { element.setAttribute(attribute, QString{blob(value).toBase64()}); }
+	});
+}
+
+
+} // namespace lmms
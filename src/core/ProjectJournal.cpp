@@ -26,11 +26,13 @@
 #include <QDomElement>
 
 #include "ProjectJournal.h"
+#include "DataFile.h"
 #include "Engine.h"
 #include "JournallingObject.h"
 #include "lmms_math.h"
 #include "Song.h"
 #include "AutomationClip.h"
+#include "TraceRecorder.h"
 
 namespace lmms
 {
@@ -41,6 +43,60 @@ static const int EO_ID_MSB = 1 << 23;
 
 const int ProjectJournal::MAX_UNDO_STATES = 100; // TODO: make this configurable in settings
 
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+std::chrono::nanoseconds elapsedSince(Clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+}
+
+
+//! Keeps the whole state of objects that have no more compact journal entry
+class SnapshotEntry : public JournalEntry
+{
+public:
+	explicit SnapshotEntry(JournallingObject& object)
+	{
+		object.saveState(m_data, m_data.content());
+	}
+
+	void restore(JournallingObject& object) override
+	{
+		auto current = DataFile{DataFile::Type::JournalData};
+		object.saveState(current, current.content());
+
+		object.restoreState(m_data.content().firstChildElement());
+
+		// loading AutomationClip connections correctly
+		if (!m_data.content().elementsByTagName("automationclip").isEmpty())
+		{
+			AutomationClip::resolveAllIDs();
+		}
+
+		m_data = current;
+		m_memoryUsage = 0;
+	}
+
+	std::size_t memoryUsage() const override
+	{
+		// Only estimated on demand, as serializing the document again is about as expensive as taking it
+		if (m_memoryUsage == 0) { m_memoryUsage = m_data.toString(-1).size() * sizeof(QChar); }
+		return m_memoryUsage;
+	}
+
+private:
+	DataFile m_data{DataFile::Type::JournalData};
+	mutable std::size_t m_memoryUsage = 0;
+};
+
+} // namespace
+
+
+
+
 ProjectJournal::ProjectJournal() :
 	m_joIDs(),
 	m_undoCheckPoints(),
@@ -52,90 +108,117 @@ ProjectJournal::ProjectJournal() :
 
 
 
+ProjectJournal::~ProjectJournal() = default;
+
+
+
+
 void ProjectJournal::undo()
 {
-	while( !m_undoCheckPoints.isEmpty() )
-	{
-		CheckPoint c = m_undoCheckPoints.pop();
-		JournallingObject *jo = m_joIDs[c.joID];
-
-		if( jo )
-		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_redoCheckPoints.push( CheckPoint( c.joID, curState ) );
-
-			bool prev = isJournalling();
-			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
-			setJournalling( prev );
-			Engine::getSong()->setModified();
-
-			// loading AutomationClip connections correctly
-			if (!c.data.content().elementsByTagName("automationclip").isEmpty())
-			{
-				AutomationClip::resolveAllIDs();
-			}
-			break;
-		}
-	}
+	restore(m_undoCheckPoints, m_redoCheckPoints);
 }
 
 
 
+
 void ProjectJournal::redo()
 {
-	while( !m_redoCheckPoints.isEmpty() )
-	{
-		CheckPoint c = m_redoCheckPoints.pop();
-		JournallingObject *jo = m_joIDs[c.joID];
-
-		if( jo )
-		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_undoCheckPoints.push( CheckPoint( c.joID, curState ) );
-
-			bool prev = isJournalling();
-			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
-			setJournalling( prev );
-			Engine::getSong()->setModified();
-			break;
-		}
-	}
+	restore(m_redoCheckPoints, m_undoCheckPoints);
 }
 
 bool ProjectJournal::canUndo() const
 {
-	return !m_undoCheckPoints.isEmpty();
+	return !m_undoCheckPoints.empty();
 }
 
 bool ProjectJournal::canRedo() const
 {
-	return !m_redoCheckPoints.isEmpty();
+	return !m_redoCheckPoints.empty();
 }
 
 
 
 void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
 {
+	emit objectChanged(jo);
+
 	if( isJournalling() )
 	{
+		const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Journal, "Check point"};
+		const auto start = Clock::now();
+
 		m_redoCheckPoints.clear();
 
-		DataFile dataFile( DataFile::Type::JournalData );
-		jo->saveState( dataFile, dataFile.content() );
+		// The change recorded by the previous check point is complete now
+		if (!m_undoCheckPoints.empty())
+		{
+			auto& previous = m_undoCheckPoints.back();
+			seal(previous, m_joIDs.value(previous.joID));
+		}
+
+		auto entry = jo->createJournalEntry();
+		if (!entry)
+		{
+			entry = std::make_unique<SnapshotEntry>(*jo);
+			++m_statistics.snapshots;
+		}
+		++m_statistics.checkPoints;
 
-		m_undoCheckPoints.push( CheckPoint( jo->id(), dataFile ) );
-		if( m_undoCheckPoints.size() > MAX_UNDO_STATES )
+		m_undoCheckPoints.push_back(CheckPoint{jo->id(), std::move(entry)});
+		while (m_undoCheckPoints.size() > static_cast<std::size_t>(MAX_UNDO_STATES))
 		{
-			m_undoCheckPoints.remove( 0, m_undoCheckPoints.size() - MAX_UNDO_STATES );
+			m_undoCheckPoints.pop_front();
 		}
+
+		m_statistics.time += elapsedSince(start);
+	}
+}
+
+
+
+
+void ProjectJournal::restore(CheckPointStack& from, CheckPointStack& to)
+{
+	while (!from.empty())
+	{
+		auto checkPoint = std::move(from.back());
+		from.pop_back();
+
+		JournallingObject* jo = m_joIDs.value(checkPoint.joID);
+		if (!jo) { continue; }
+
+		const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Journal, "Restore"};
+
+		seal(checkPoint, jo);
+
+		const bool prev = isJournalling();
+		setJournalling(false);
+		checkPoint.entry->restore(*jo);
+		setJournalling(prev);
+
+		to.push_back(std::move(checkPoint));
+
+		Engine::getSong()->setModified();
+		emit objectChanged(jo);
+		break;
 	}
 }
 
 
+
+
+void ProjectJournal::seal(CheckPoint& checkPoint, JournallingObject* jo)
+{
+	// Objects that are gone have their entries sealed once they come back, if ever
+	if (checkPoint.sealed || !jo) { return; }
+
+	const auto start = Clock::now();
+	checkPoint.entry->seal(*jo);
+	checkPoint.sealed = true;
+	m_statistics.time += elapsedSince(start);
+}
+
+
 jo_id_t ProjectJournal::allocID(JournallingObject* obj)
 {
 	jo_id_t id;
@@ -174,6 +257,7 @@ void ProjectJournal::clearJournal()
 {
 	m_undoCheckPoints.clear();
 	m_redoCheckPoints.clear();
+	m_statistics = Statistics{};
 
 	for( JoIdMap::Iterator it = m_joIDs.begin(); it != m_joIDs.end(); )
 	{
@@ -202,4 +286,21 @@ void ProjectJournal::stopAllJournalling()
 
 
 
+
+ProjectJournal::Statistics ProjectJournal::statistics() const
+{
+	auto statistics = m_statistics;
+	statistics.memoryUsage = 0;
+	for (const auto* stack : {&m_undoCheckPoints, &m_redoCheckPoints})
+	{
+		for (const auto& checkPoint : *stack)
+		{
+			statistics.memoryUsage += sizeof(CheckPoint) + checkPoint.entry->memoryUsage();
+		}
+	}
+	return statistics;
+}
+
+
+
 } // namespace lmms
@@ -156,8 +156,6 @@ void ProjectRenderer::run()
 	PerfLogTimer perfLog("Project Render");
 
 	Engine::getSong()->startExport();
-	// Skip first empty buffer.
-	Engine::audioEngine()->nextBuffer();
 
 	m_progress = 0;
 
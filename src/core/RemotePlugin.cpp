@@ -37,6 +37,7 @@
 #include "Engine.h"
 #include "MidiEvent.h"
 #include "Song.h"
+#include "TraceRecorder.h"
 
 #include <QCoreApplication>
 #include <QDebug>
@@ -403,7 +404,10 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		return false;
 	}
 
-	waitForMessage( IdProcessingDone );
+	{
+		const auto trace = TraceRecorder::Scope{TraceRecorder::Category::RemotePlugin, "Remote plugin wait"};
+		waitForMessage( IdProcessingDone );
+	}
 	unlock();
 
 	const ch_cnt_t outputs = std::min<ch_cnt_t>(m_outputCount,
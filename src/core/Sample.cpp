@@ -24,8 +24,18 @@
 
 #include "Sample.h"
 
+#include "Song.h"
+
 namespace lmms {
 
+namespace {
+
+//! Playing the copy of a sample at the engine sample rate instead of the original only saves work up to about a
+//! semitone of pitch, beyond which both are resampled anyway
+constexpr auto MaxResampledPitchRatio = 1.06;
+
+} // namespace
+
 Sample::Sample(const SampleFrame* data, size_t numFrames, int sampleRate)
 	: m_buffer(std::make_shared<SampleBuffer>(data, numFrames, sampleRate))
 	, m_startFrame(0)
@@ -98,11 +108,13 @@ auto Sample::operator=(Sample&& other) noexcept -> Sample&
 
 bool Sample::play(SampleFrame* dst, PlaybackState* state, size_t numFrames, Loop loop, double ratio) const
 {
-	state->m_frameIndex = std::max<int>(m_startFrame, state->m_frameIndex);
+	const auto pitchRatio = frequency() / DefaultBaseFreq * ratio;
+	const auto& source = selectSource(state, pitchRatio);
+
+	state->m_frameIndex = std::max(static_cast<int>(startFrame() * state->m_frameScale), state->m_frameIndex);
 
-	const auto sampleRateRatio = static_cast<double>(Engine::audioEngine()->outputSampleRate()) / m_buffer->sampleRate();
-	const auto freqRatio = frequency() / DefaultBaseFreq;
-	state->m_resampler.setRatio(sampleRateRatio * freqRatio * ratio);
+	const auto sampleRateRatio = static_cast<double>(Engine::audioEngine()->outputSampleRate()) / source.sampleRate();
+	state->m_resampler.setRatio(sampleRateRatio * pitchRatio);
 
 	// TODO: These kind of playback pipelines/graphs are repeated within other parts of the codebase that work with
 	// audio samples. We should find a way to unify this but the right abstraction is not so clear yet.
@@ -110,7 +122,7 @@ bool Sample::play(SampleFrame* dst, PlaybackState* state, size_t numFrames, Loop
 	{
 		if (state->m_bufferView.empty())
 		{
-			const auto rendered = render(state->m_buffer.data(), state->m_buffer.size(), state, loop);
+			const auto rendered = render(source, state->m_buffer.data(), state->m_buffer.size(), state, loop);
 			state->m_bufferView = {state->m_buffer.data(), rendered};
 		}
  
@@ -131,31 +143,71 @@ bool Sample::play(SampleFrame* dst, PlaybackState* state, size_t numFrames, Loop
 	return numFrames < Engine::audioEngine()->framesPerPeriod();
 }
 
-f_cnt_t Sample::render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loop loop) const
+auto Sample::selectSource(PlaybackState* state, double pitchRatio) const -> const SampleBuffer&
+{
+	const auto resampled = m_buffer->resampled(Engine::audioEngine()->outputSampleRate());
+	const auto frameScale = [this](const SampleBuffer* buffer) {
+		return static_cast<double>(buffer->sampleRate()) / m_buffer->sampleRate();
+	};
+
+	// Switching between the original and the copy while playing would be audible, so the copy is only picked at the
+	// start. Exports always resample the original, so that they don't depend on whether the copy is ready.
+	if (!state->m_started)
+	{
+		state->m_started = true;
+		const auto slightlyPitched = pitchRatio < MaxResampledPitchRatio && pitchRatio > 1 / MaxResampledPitchRatio;
+		if (resampled && slightlyPitched && !Engine::getSong()->isExporting())
+		{
+			state->m_resampled = resampled;
+			state->m_frameScale = frameScale(resampled);
+			state->m_frameIndex = static_cast<int>(state->m_frameIndex * state->m_frameScale);
+		}
+	}
+	else if (state->m_resampled && (state->m_resampled != resampled || state->m_frameScale != frameScale(resampled)))
+	{
+		// The sample or the sample rate changed in the meantime
+		state->m_frameIndex = state->frameIndex();
+		state->m_resampled = nullptr;
+		state->m_frameScale = 1.0;
+	}
+
+	return state->m_resampled ? *state->m_resampled : *m_buffer;
+}
+
+f_cnt_t Sample::render(const SampleBuffer& source, SampleFrame* dst, f_cnt_t size, PlaybackState* state,
+	Loop loop) const
 {
+	// The points are set in frames of the sample, which differ from the ones of a copy at another sample rate
+	const auto toSource = [scale = state->m_frameScale](int frame) { return static_cast<int>(frame * scale); };
+	const auto end = toSource(endFrame());
+	const auto loopStart = toSource(loopStartFrame());
+	const auto loopEnd = toSource(loopEndFrame());
+	const auto amplification = this->amplification();
+	const auto reversed = this->reversed();
+
 	for (f_cnt_t frame = 0; frame < size; ++frame)
 	{
 		switch (loop)
 		{
 		case Loop::Off:
-			if (state->m_frameIndex < 0 || state->m_frameIndex >= m_endFrame) { return frame; }
+			if (state->m_frameIndex < 0 || state->m_frameIndex >= end) { return frame; }
 			break;
 		case Loop::On:
-			if (state->m_frameIndex < m_loopStartFrame && state->m_backwards)
+			if (state->m_frameIndex < loopStart && state->m_backwards)
 			{
-				state->m_frameIndex = m_loopEndFrame - 1;
+				state->m_frameIndex = loopEnd - 1;
 			}
-			else if (state->m_frameIndex >= m_loopEndFrame) { state->m_frameIndex = m_loopStartFrame; }
+			else if (state->m_frameIndex >= loopEnd) { state->m_frameIndex = loopStart; }
 			break;
 		case Loop::PingPong:
-			if (state->m_frameIndex < m_loopStartFrame && state->m_backwards)
+			if (state->m_frameIndex < loopStart && state->m_backwards)
 			{
-				state->m_frameIndex = m_loopStartFrame;
+				state->m_frameIndex = loopStart;
 				state->m_backwards = false;
 			}
-			else if (state->m_frameIndex >= m_loopEndFrame)
+			else if (state->m_frameIndex >= loopEnd)
 			{
-				state->m_frameIndex = m_loopEndFrame - 1;
+				state->m_frameIndex = loopEnd - 1;
 				state->m_backwards = true;
 			}
 			break;
@@ -163,9 +215,23 @@ f_cnt_t Sample::render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loo
 			break;
 		}
 
+		// Play forward up to the next loop point or the end in one go
+		const auto runEnd = loop == Loop::Off ? end : loopEnd;
+		if (!state->m_backwards && !reversed && state->m_frameIndex < runEnd)
+		{
+			const auto count = std::min<f_cnt_t>(size - frame, runEnd - state->m_frameIndex);
+			const auto src = source.data() + state->m_frameIndex;
+			for (f_cnt_t i = 0; i < count; ++i)
+			{
+				dst[frame + i] = src[i] * amplification;
+			}
+			state->m_frameIndex += count;
+			frame += count - 1;
+			continue;
+		}
+
 		const auto value
-			= m_buffer->data()[m_reversed ? m_buffer->size() - state->m_frameIndex - 1 : state->m_frameIndex]
-			* m_amplification;
+			= source.data()[reversed ? source.size() - state->m_frameIndex - 1 : state->m_frameIndex] * amplification;
 		dst[frame] = value;
 		state->m_backwards ? --state->m_frameIndex : ++state->m_frameIndex;
 	}
@@ -26,14 +26,65 @@
 
 #include <QDebug>
 #include <QMessageBox>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <stdexcept>
 
+#include "AudioResampler.h"
 #include "GuiApplication.h"
 #include "PathUtil.h"
+#include "ProjectContainer.h"
 #include "SampleDecoder.h"
+#include "ThreadPool.h"
+#include "TraceRecorder.h"
 
 namespace lmms {
 
+namespace {
+
+//! Samples being decoded or decoded by SampleBuffer::preload(), by absolute path
+struct PreloadedBuffers
+{
+	std::mutex mutex;
+	std::map<QString, std::shared_future<std::shared_ptr<const SampleBuffer>>> buffers;
+};
+
+auto preloadedBuffers() -> PreloadedBuffers&
+{
+	static auto s_preloaded = PreloadedBuffers{};
+	return s_preloaded;
+}
+
+//! Samples that have a copy at the sample rate of the audio engine
+struct ResampledBuffers
+{
+	std::mutex mutex;
+	std::vector<std::weak_ptr<const SampleBuffer>> buffers;
+};
+
+auto resampledBuffers() -> ResampledBuffers&
+{
+	static auto s_resampled = ResampledBuffers{};
+	return s_resampled;
+}
+
+} // namespace
+
+//! The copy of a sample at the sample rate of the audio engine
+struct SampleBuffer::Resampled
+{
+	std::mutex mutex;
+	//! The rate of the copy that is being made or was made
+	sample_rate_t sampleRate = 0;
+	std::unique_ptr<const SampleBuffer> buffer;
+	//! Read by the audio threads. Only reset while the audio engine is stopped.
+	std::atomic<const SampleBuffer*> published = nullptr;
+};
+
 SampleBuffer::SampleBuffer(const SampleFrame* data, size_t numFrames, int sampleRate)
 	: m_data(data, data + numFrames)
 	, m_sampleRate(sampleRate)
@@ -53,6 +104,7 @@ void swap(SampleBuffer& first, SampleBuffer& second) noexcept
 	swap(first.m_data, second.m_data);
 	swap(first.m_audioFile, second.m_audioFile);
 	swap(first.m_sampleRate, second.m_sampleRate);
+	swap(first.m_resampled, second.m_resampled);
 }
 
 QString SampleBuffer::toBase64() const
@@ -77,6 +129,22 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePa
 	const auto absolutePath = PathUtil::toAbsolute(filePath);
 	const auto storedPath = PathUtil::toShortestRelative(filePath);
 
+	auto preloaded = std::shared_future<std::shared_ptr<const SampleBuffer>>{};
+	{
+		auto& preloads = preloadedBuffers();
+		const auto lock = std::lock_guard{preloads.mutex};
+		if (const auto it = preloads.buffers.find(absolutePath); it != preloads.buffers.end())
+		{
+			preloaded = it->second;
+		}
+	}
+
+	// Files that failed to preload are decoded again below, to report the error
+	if (preloaded.valid())
+	{
+		if (const auto& buffer = preloaded.get(); buffer && buffer->audioFile() == storedPath) { return buffer; }
+	}
+
 	auto result = SampleDecoder::decode(absolutePath);
 
 	if (!result)
@@ -99,14 +167,47 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePa
 	}
 
 	auto& [data, sampleRate] = *result;
-	return std::make_shared<SampleBuffer>(std::move(data), sampleRate, storedPath);
+	return withResampled(std::make_shared<SampleBuffer>(std::move(data), sampleRate, storedPath));
+}
+
+void SampleBuffer::preload(const std::vector<QString>& paths)
+{
+	auto& preloaded = preloadedBuffers();
+	const auto lock = std::lock_guard{preloaded.mutex};
+
+	for (const auto& path : paths)
+	{
+		const auto absolutePath = PathUtil::toAbsolute(path);
+		if (preloaded.buffers.find(absolutePath) != preloaded.buffers.end()) { continue; }
+
+		const auto storedPath = PathUtil::toShortestRelative(path);
+		auto decode = [absolutePath, storedPath]() -> std::shared_ptr<const SampleBuffer> {
+			const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Decode sample"};
+
+			auto result = SampleDecoder::decode(absolutePath);
+			if (!result) { return nullptr; }
+
+			auto& [data, sampleRate] = *result;
+			return withResampled(std::make_shared<SampleBuffer>(std::move(data), sampleRate, storedPath));
+		};
+		preloaded.buffers.emplace(absolutePath, ThreadPool::instance().enqueue(std::move(decode)).share());
+	}
+}
+
+void SampleBuffer::clearPreloaded()
+{
+	auto& preloaded = preloadedBuffers();
+	const auto lock = std::lock_guard{preloaded.mutex};
+	preloaded.buffers.clear();
 }
 
 std::shared_ptr<const SampleBuffer> SampleBuffer::fromBase64(const QString& str, int sampleRate)
 {
 	if (str.isEmpty()) { return SampleBuffer::emptyBuffer(); }
 
-	const auto bytes = QByteArray::fromBase64(str.toUtf8());
+	// Samples embedded in binary projects are read straight from the mapped file
+	const auto bytes = ProjectContainer::isBlobReference(str) ? ProjectContainer::blob(str)
+		: QByteArray::fromBase64(str.toUtf8());
 
 	if (bytes.size() % sizeof(SampleFrame) != 0)
 	{
@@ -127,7 +228,98 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromBase64(const QString& str,
 
 	auto data = std::vector<SampleFrame>(bytes.size() / sizeof(SampleFrame));
 	std::memcpy(reinterpret_cast<char*>(data.data()), bytes, bytes.size());
-	return std::make_shared<SampleBuffer>(std::move(data), sampleRate);
+	return withResampled(std::make_shared<SampleBuffer>(std::move(data), sampleRate));
+}
+
+auto SampleBuffer::resampled(sample_rate_t sampleRate) const -> const SampleBuffer*
+{
+	if (!m_resampled) { return nullptr; }
+
+	const auto buffer = m_resampled->published.load(std::memory_order_acquire);
+	return buffer && buffer->sampleRate() == sampleRate ? buffer : nullptr;
+}
+
+void SampleBuffer::updateResampled()
+{
+	const auto sampleRate = Engine::audioEngine()->outputSampleRate();
+
+	auto& resampled = resampledBuffers();
+	const auto lock = std::lock_guard{resampled.mutex};
+	std::erase_if(resampled.buffers, [](const auto& buffer) { return buffer.expired(); });
+
+	for (const auto& weakBuffer : resampled.buffers)
+	{
+		if (auto buffer = weakBuffer.lock()) { startResampling(std::move(buffer), sampleRate); }
+	}
+}
+
+auto SampleBuffer::withResampled(std::shared_ptr<SampleBuffer> buffer) -> std::shared_ptr<const SampleBuffer>
+{
+	if (!Engine::audioEngine()->resamplesSamples() || buffer->empty()) { return buffer; }
+
+	buffer->m_resampled = std::make_shared<Resampled>();
+	{
+		auto& resampled = resampledBuffers();
+		const auto lock = std::lock_guard{resampled.mutex};
+		std::erase_if(resampled.buffers, [](const auto& buffer) { return buffer.expired(); });
+		resampled.buffers.push_back(buffer);
+	}
+
+	startResampling(buffer, Engine::audioEngine()->outputSampleRate());
+	return buffer;
+}
+
+void SampleBuffer::startResampling(std::shared_ptr<const SampleBuffer> buffer, sample_rate_t sampleRate)
+{
+	const auto resampled = buffer->m_resampled;
+	{
+		const auto lock = std::lock_guard{resampled->mutex};
+		if (resampled->sampleRate == sampleRate) { return; }
+
+		// Either no audio thread is running or there was no copy yet
+		resampled->sampleRate = sampleRate;
+		resampled->published.store(nullptr, std::memory_order_release);
+		resampled->buffer.reset();
+	}
+
+	if (buffer->sampleRate() == sampleRate) { return; }
+
+	ThreadPool::instance().enqueue([buffer = std::move(buffer), resampled, sampleRate] {
+		const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Resample sample"};
+
+		auto resampler = AudioResampler{AudioResampler::Mode::SincBest};
+		resampler.setRatio(buffer->sampleRate(), sampleRate);
+
+		auto data = std::vector<SampleFrame>(static_cast<f_cnt_t>(buffer->size() * resampler.ratio()));
+		const auto silence = std::array<SampleFrame, DEFAULT_BUFFER_SIZE>{};
+		auto used = f_cnt_t{0};
+		auto generated = f_cnt_t{0};
+		try
+		{
+			// Followed by silence to get the frames the resampler holds back
+			while (generated < data.size())
+			{
+				const auto remaining = used < buffer->size();
+				const auto input = remaining ? &buffer->data()[used][0] : &silence[0][0];
+				const auto inputFrames = remaining ? buffer->size() - used : silence.size();
+				const auto result = resampler.process(
+					{input, 2, inputFrames}, {&data[generated][0], 2, data.size() - generated});
+				if (remaining) { used += result.inputFramesUsed; }
+				generated += result.outputFramesGenerated;
+			}
+		}
+		catch (const std::runtime_error& error)
+		{
+			qWarning() << "Could not resample" << buffer->audioFile() << ":" << error.what();
+			return;
+		}
+
+		const auto lock = std::lock_guard{resampled->mutex};
+		if (resampled->sampleRate != sampleRate) { return; }
+
+		resampled->buffer = std::make_unique<const SampleBuffer>(std::move(data), sampleRate, buffer->audioFile());
+		resampled->published.store(resampled->buffer.get(), std::memory_order_release);
+	});
 }
 
 } // namespace lmms
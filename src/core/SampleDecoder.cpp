@@ -27,6 +27,7 @@
 #include <QFile>
 #include <QString>
 #include <memory>
+#include <mutex>
 #include <sndfile.h>
 
 #ifdef LMMS_HAVE_OGGVORBIS
@@ -96,12 +97,17 @@ auto decodeSampleSF(const QString& audioFile) -> std::optional<SampleDecoder::Re
 
 auto decodeSampleDS(const QString& audioFile) -> std::optional<SampleDecoder::Result>
 {
+	// DrumSynth keeps its state in globals, so only one file can be synthesized at a time
+	static auto s_mutex = std::mutex{};
+
 	// Populated by DrumSynth::GetDSFileSamples
 	int_sample_t* dataPtr = nullptr;
 
 	auto ds = DrumSynth{};
 	const auto engineRate = Engine::audioEngine()->outputSampleRate();
+	auto lock = std::unique_lock{s_mutex};
 	const auto frames = ds.GetDSFileSamples(audioFile, dataPtr, DEFAULT_CHANNELS, engineRate);
+	lock.unlock();
 	const auto data = std::unique_ptr<int_sample_t[]>{dataPtr}; // NOLINT, we have to use a C-style array here
 
 	if (frames <= 0 || !data) { return std::nullopt; }
@@ -232,4 +238,22 @@ auto SampleDecoder::decode(const QString& audioFile) -> std::optional<Result>
 	return result;
 }
 
+auto SampleDecoder::probe(const QString& audioFile) -> std::optional<AudioInfo>
+{
+	auto sfInfo = SF_INFO{};
+	SNDFILE* sndFile = sf_open(
+#ifdef LMMS_BUILD_WIN32
+		audioFile.toLocal8Bit().constData(),
+#else
+		audioFile.toUtf8().constData(),
+#endif
+		SFM_READ,
+		&sfInfo
+	);
+	if (sndFile == nullptr) { return std::nullopt; }
+	sf_close(sndFile);
+
+	return AudioInfo{static_cast<long long>(sfInfo.frames), sfInfo.samplerate, sfInfo.channels};
+}
+
 } // namespace lmms
@@ -27,7 +27,6 @@
 #include "AudioEngine.h"
 #include "Engine.h"
 #include "PatternTrack.h"
-#include "SampleBuffer.h"
 #include "SampleClip.h"
 
 
@@ -37,8 +36,9 @@ namespace lmms
 
 SampleRecordHandle::SampleRecordHandle( SampleClip* clip ) :
 	PlayHandle( Type::SamplePlayHandle ),
+	m_started( false ),
+	m_take( nullptr ),
 	m_framesRecorded( 0 ),
-	m_minLength( clip->length() ),
 	m_track( clip->getTrack() ),
 	m_patternTrack( nullptr ),
 	m_clip( clip )
@@ -50,13 +50,9 @@ SampleRecordHandle::SampleRecordHandle( SampleClip* clip ) :
 
 SampleRecordHandle::~SampleRecordHandle()
 {
-	if (!m_buffers.empty()) { m_clip->setSampleBuffer(createSampleBuffer()); }
+	// The recorder hands the take to the clip once it is saved
+	if (m_take) { Engine::audioEngine()->sampleRecorder().finish(m_take); }
 
-	while( !m_buffers.empty() )
-	{
-		delete[] m_buffers.front().first;
-		m_buffers.erase( m_buffers.begin() );
-	}
 	m_clip->setRecord( false );
 }
 
@@ -65,17 +61,19 @@ SampleRecordHandle::~SampleRecordHandle()
 
 void SampleRecordHandle::play( SampleFrame* /*_working_buffer*/ )
 {
-	const SampleFrame* recbuf = Engine::audioEngine()->inputBuffer();
-	const f_cnt_t frames = Engine::audioEngine()->inputBufferFrames();
-	writeBuffer( recbuf, frames );
-	m_framesRecorded += frames;
-
-	TimePos len = (tick_t)( m_framesRecorded / Engine::framesPerTick() );
-	if( len > m_minLength )
+	const auto audioEngine = Engine::audioEngine();
+	if (!m_started)
 	{
-//		m_clip->changeLength( len );
-		m_minLength = len;
+		// Punch in at the frame the clip starts at. The input also lags behind the playback by the round trip
+		// latency of the audio device, which is dropped as well so that the take lines up with the song.
+		m_take = audioEngine->sampleRecorder().start(m_clip->id(), offset() + audioEngine->latencyReport().total());
+		m_started = true;
 	}
+
+	const SampleFrame* recbuf = audioEngine->inputBuffer();
+	const f_cnt_t frames = audioEngine->inputBufferFrames();
+	if (m_take) { audioEngine->sampleRecorder().write(m_take, recbuf, frames); }
+	m_framesRecorded += frames;
 }
 
 
@@ -103,41 +101,4 @@ f_cnt_t SampleRecordHandle::framesRecorded() const
 }
 
 
-
-
-std::shared_ptr<const SampleBuffer> SampleRecordHandle::createSampleBuffer()
-{
-	const f_cnt_t frames = framesRecorded();
-	// create buffer to store all recorded buffers in
-	auto bigBuffer = std::vector<SampleFrame>(frames);
-
-	// now copy all buffers into big buffer
-	auto framesCopied = 0;
-	for (const auto& [buf, numFrames] : m_buffers)
-	{
-		std::copy_n(buf, numFrames, bigBuffer.begin() + framesCopied);
-		framesCopied += numFrames;
-	}
-
-	// create according sample-buffer out of big buffer
-	return std::make_shared<const SampleBuffer>(std::move(bigBuffer), Engine::audioEngine()->inputSampleRate());
-}
-
-
-
-
-void SampleRecordHandle::writeBuffer( const SampleFrame* _ab, const f_cnt_t _frames )
-{
-	auto buf = new SampleFrame[_frames];
-	for( f_cnt_t frame = 0; frame < _frames; ++frame )
-	{
-		for( ch_cnt_t chnl = 0; chnl < DEFAULT_CHANNELS; ++chnl )
-		{
-			buf[frame][chnl] = _ab[frame][chnl];
-		}
-	}
-	m_buffers.push_back( qMakePair( buf, _frames ) );
-}
-
-
 } // namespace lmms
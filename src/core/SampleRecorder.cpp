@@ -0,0 +1,355 @@
+/*
+ * SampleRecorder.cpp - Streams recorded audio to disk for sample clips
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <sndfile.h>
+#include <QDir>
+#include <QTemporaryFile>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "LocklessRingBuffer.h"
+#include "ProjectJournal.h"
+#include "SampleBuffer.h"
+#include "SampleClip.h"
+#include "SampleDecoder.h"
+#include "Song.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+//! How often the background thread writes the queued frames to disk
+constexpr auto PollInterval = std::chrono::milliseconds{10};
+
+//! Frames written to the file at once
+constexpr auto ChunkFrames = std::size_t{4096};
+
+} // namespace
+
+
+
+
+class SampleRecorder::Take
+{
+public:
+	enum class State
+	{
+		Idle,
+		Reserved,	//!< Being set up by an audio thread
+		Recording,	//!< Filled by an audio thread and written to disk by the background thread
+		Finishing	//!< Given up by the audio thread, to be saved by the background thread
+	};
+
+	Take()
+		: queue(QueueFrames)
+		, reader(queue)
+	{
+	}
+
+	std::atomic<State> state = State::Idle;
+
+	// Written by the audio thread before the take starts recording
+	jo_id_t clipId = 0;
+	f_cnt_t skipFrames = 0;
+	sample_rate_t sampleRate = 0;
+
+	LocklessRingBuffer<SampleFrame> queue;
+	LocklessRingBufferReader<SampleFrame> reader;
+
+	// Owned by the background thread
+	std::unique_ptr<QTemporaryFile> file;
+	SNDFILE* sndFile = nullptr;
+	f_cnt_t framesWritten = 0;
+	Peak peak;
+	f_cnt_t peakFill = 0;
+
+	// Shared by the background thread and the main thread
+	mutable std::mutex mutex;
+	std::optional<jo_id_t> shownClipId;
+	std::vector<Peak> peaks;
+};
+
+
+
+
+SampleRecorder::SampleRecorder()
+	: m_writeBuffer(ChunkFrames * DEFAULT_CHANNELS)
+{
+	for (std::size_t i = 0; i < MaxTakes; ++i)
+	{
+		m_takes.push_back(std::make_unique<Take>());
+	}
+
+	m_thread = std::thread{[this] { run(); }};
+}
+
+
+
+
+SampleRecorder::~SampleRecorder()
+{
+	{
+		const auto lock = std::lock_guard{m_quitMutex};
+		m_quit = true;
+	}
+	m_quitCond.notify_one();
+	m_thread.join();
+
+	// Takes that were not saved yet are lost along with their temporary files
+	for (auto& take : m_takes)
+	{
+		if (take->sndFile) { sf_close(take->sndFile); }
+	}
+}
+
+
+
+
+SampleRecorder::Take* SampleRecorder::start(jo_id_t clipId, f_cnt_t skipFrames)
+{
+	for (auto& take : m_takes)
+	{
+		auto expected = Take::State::Idle;
+		if (!take->state.compare_exchange_strong(expected, Take::State::Reserved, std::memory_order_acquire))
+		{
+			continue;
+		}
+
+		take->clipId = clipId;
+		take->skipFrames = skipFrames;
+		take->sampleRate = Engine::audioEngine()->inputSampleRate();
+		take->state.store(Take::State::Recording, std::memory_order_release);
+		return take.get();
+	}
+	return nullptr;
+}
+
+
+
+
+void SampleRecorder::write(Take* take, const SampleFrame* frames, f_cnt_t count)
+{
+	take->queue.write(frames, count);
+}
+
+
+
+
+void SampleRecorder::finish(Take* take)
+{
+	take->state.store(Take::State::Finishing, std::memory_order_release);
+}
+
+
+
+
+bool SampleRecorder::isRecording(jo_id_t clipId) const
+{
+	return std::any_of(m_takes.begin(), m_takes.end(), [clipId](const auto& take) {
+		const auto lock = std::lock_guard{take->mutex};
+		return take->shownClipId == clipId;
+	});
+}
+
+
+
+
+std::vector<SampleRecorder::Peak> SampleRecorder::peaks(jo_id_t clipId, f_cnt_t framesPerPeak) const
+{
+	const auto merged = std::max<std::size_t>(framesPerPeak / PeakFrames, 1);
+
+	for (const auto& take : m_takes)
+	{
+		const auto lock = std::lock_guard{take->mutex};
+		if (take->shownClipId != clipId) { continue; }
+
+		auto result = std::vector<Peak>{};
+		result.reserve(take->peaks.size() / merged + 1);
+		for (std::size_t i = 0; i < take->peaks.size(); i += merged)
+		{
+			const auto end = take->peaks.begin() + std::min(i + merged, take->peaks.size());
+			auto peak = take->peaks[i];
+			for (auto it = take->peaks.begin() + i + 1; it < end; ++it)
+			{
+				peak.min = std::min(peak.min, it->min);
+				peak.max = std::max(peak.max, it->max);
+			}
+			result.push_back(peak);
+		}
+		return result;
+	}
+	return {};
+}
+
+
+
+
+void SampleRecorder::run()
+{
+	auto quitLock = std::unique_lock{m_quitMutex};
+	while (!m_quitCond.wait_for(quitLock, PollInterval, [this] { return m_quit; }))
+	{
+		for (auto& take : m_takes)
+		{
+			switch (take->state.load(std::memory_order_acquire))
+			{
+				case Take::State::Recording:
+					drain(*take);
+					break;
+				case Take::State::Finishing:
+					// The audio thread is done with the take, so this gets everything it recorded
+					drain(*take);
+					save(*take);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
+
+
+
+void SampleRecorder::open(Take& take)
+{
+	take.file = std::make_unique<QTemporaryFile>(QDir::temp().filePath("lmms-recording-XXXXXX.w64"));
+	if (take.file->open())
+	{
+		auto info = SF_INFO{};
+		info.samplerate = take.sampleRate;
+		info.channels = DEFAULT_CHANNELS;
+		info.format = SF_FORMAT_W64 | SF_FORMAT_FLOAT;
+
+		// Use file handle to handle unicode file name on Windows
+		take.sndFile = sf_open_fd(take.file->handle(), SFM_WRITE, &info, false);
+	}
+
+	if (!take.sndFile)
+	{
+		qWarning("SampleRecorder: could not create %s: %s", qUtf8Printable(take.file->fileName()),
+			sf_strerror(nullptr));
+	}
+
+	const auto lock = std::lock_guard{take.mutex};
+	take.shownClipId = take.clipId;
+}
+
+
+
+
+void SampleRecorder::drain(Take& take)
+{
+	if (!take.file) { open(take); }
+
+	while (true)
+	{
+		const auto frames = take.reader.read_max(ChunkFrames);
+		if (frames.size() == 0) { break; }
+
+		// Drop everything before the punch-in point
+		const auto skipped = std::min<std::size_t>(take.skipFrames, frames.size());
+		take.skipFrames -= skipped;
+
+		auto count = std::size_t{0};
+		for (auto i = skipped; i < frames.size(); ++i, ++count)
+		{
+			const auto& frame = frames[i];
+			m_writeBuffer[count * DEFAULT_CHANNELS] = frame[0];
+			m_writeBuffer[count * DEFAULT_CHANNELS + 1] = frame[1];
+
+			take.peak.min = std::min({take.peak.min, frame[0], frame[1]});
+			take.peak.max = std::max({take.peak.max, frame[0], frame[1]});
+			if (++take.peakFill == PeakFrames)
+			{
+				m_newPeaks.push_back(take.peak);
+				take.peak = Peak{};
+				take.peakFill = 0;
+			}
+		}
+
+		if (take.sndFile && count > 0) { sf_writef_float(take.sndFile, m_writeBuffer.data(), count); }
+		take.framesWritten += count;
+
+		if (!m_newPeaks.empty())
+		{
+			const auto lock = std::lock_guard{take.mutex};
+			take.peaks.insert(take.peaks.end(), m_newPeaks.begin(), m_newPeaks.end());
+			m_newPeaks.clear();
+		}
+	}
+}
+
+
+
+
+void SampleRecorder::save(Take& take)
+{
+	auto buffer = std::shared_ptr<const SampleBuffer>{};
+	if (take.sndFile)
+	{
+		sf_close(take.sndFile);
+		take.sndFile = nullptr;
+		take.file->close();
+
+		if (take.framesWritten > 0)
+		{
+			if (auto result = SampleDecoder::decode(take.file->fileName()))
+			{
+				buffer = std::make_shared<const SampleBuffer>(std::move(result->data), result->sampleRate);
+			}
+		}
+	}
+	take.file.reset();
+
+	if (buffer)
+	{
+		// Looked up by ID on the main thread, as the clip may have been deleted in the meantime
+		QMetaObject::invokeMethod(Engine::getSong(), [clipId = take.clipId, buffer] {
+			const auto object = Engine::projectJournal()->journallingObject(clipId);
+			if (const auto clip = dynamic_cast<SampleClip*>(object)) { clip->setSampleBuffer(buffer); }
+		}, Qt::QueuedConnection);
+	}
+
+	{
+		const auto lock = std::lock_guard{take.mutex};
+		take.shownClipId.reset();
+		take.peaks.clear();
+	}
+	take.framesWritten = 0;
+	take.peak = Peak{};
+	take.peakFill = 0;
+
+	take.state.store(Take::State::Idle, std::memory_order_release);
+}
+
+} // namespace lmms
@@ -37,6 +37,7 @@
 #include "ConfigManager.h"
 #include "ControllerRackView.h"
 #include "ControllerConnection.h"
+#include "DataFile.h"
 #include "EnvelopeAndLfoParameters.h"
 #include "Mixer.h"
 #include "MixerView.h"
@@ -52,8 +53,10 @@
 #include "PianoRoll.h"
 #include "ProjectJournal.h"
 #include "ProjectNotes.h"
+#include "SampleBuffer.h"
 #include "Scale.h"
 #include "SongEditor.h"
+#include "TraceRecorder.h"
 #include "PeakController.h"
 
 
@@ -321,8 +324,8 @@ void Song::processNextBuffer()
 			// First frame of buffer: update VST sync position.
 			// This must be done after we've corrected the frame/tick count,
 			// but before actually playing any frames.
-			m_vstSyncController.setAbsolutePosition(getPlayPos().getTicks()
-				+ timeline.frameOffset() / static_cast<double>(framesPerTick));
+			m_periodStartPosition = getPlayPos().getTicks() + timeline.frameOffset() / static_cast<double>(framesPerTick);
+			m_vstSyncController.setAbsolutePosition(m_periodStartPosition);
 			m_vstSyncController.update();
 		}
 
@@ -1006,6 +1009,8 @@ void Song::loadProject( const QString & fileName )
 {
 	using gui::getGUI;
 
+	const auto loadTrace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Load project"};
+
 	QDomNode node;
 
 	m_loadingProject = true;
@@ -1063,6 +1068,9 @@ void Song::loadProject( const QString & fileName )
 
 	clearErrors();
 
+	// Decode the samples on the thread pool while the tracks using them are created
+	SampleBuffer::preload(dataFile.sampleFiles());
+
 	Engine::audioEngine()->requestChangeInModel();
 
 	// get the header information from the DOM
@@ -1080,6 +1088,7 @@ void Song::loadProject( const QString & fileName )
 	node = dataFile.content().firstChildElement( Engine::mixer()->nodeName() );
 	if( !node.isNull() )
 	{
+		const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Mixer"};
 		Engine::mixer()->restoreState( node.toElement() );
 		if( getGUI() != nullptr )
 		{
@@ -1116,10 +1125,12 @@ void Song::loadProject( const QString & fileName )
 		{
 			if( node.nodeName() == "trackcontainer" )
 			{
+				const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Tracks"};
 				( (JournallingObject *)( this ) )->restoreState( node.toElement() );
 			}
 			else if( node.nodeName() == "controllers" )
 			{
+				const auto trace = TraceRecorder::Scope{TraceRecorder::Category::Load, "Controllers"};
 				restoreControllerStates( node.toElement() );
 			}
 			else if (node.nodeName() == "scales")
@@ -1157,6 +1168,8 @@ void Song::loadProject( const QString & fileName )
 		node = node.nextSibling();
 	}
 
+	SampleBuffer::clearPreloaded();
+
 	// quirk for fixing projects with broken positions of Clips inside pattern tracks
 	Engine::patternStore()->fixIncorrectPositions();
 
@@ -0,0 +1,233 @@
+/*
+ * TraceRecorder.cpp - Timeline recording of the audio engine in Chrome trace format
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "TraceRecorder.h"
+
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr auto CollectionInterval = std::chrono::milliseconds{50};
+
+thread_local const char* t_threadName = nullptr;
+
+auto jsonString(const QString& text) -> QString
+{
+	auto result = QString{QChar{'"'}};
+	for (const auto c : text)
+	{
+		switch (c.unicode())
+		{
+			case '"': result += "\\\""; break;
+			case '\\': result += "\\\\"; break;
+			case '\n': result += "\\n"; break;
+			case '\t': result += "\\t"; break;
+			default:
+				if (c.unicode() < 0x20) { result += QString{"\\u%1"}.arg(c.unicode(), 4, 16, QChar{'0'}); }
+				else { result += c; }
+		}
+	}
+	return result + '"';
+}
+
+//! Chrome trace timestamps are in microseconds
+auto microseconds(std::int64_t nanoseconds) -> QString
+{
+	return QString::number(nanoseconds / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+
+
+
+TraceRecorder::~TraceRecorder()
+{
+	setEnabled(false);
+}
+
+auto TraceRecorder::instance() -> TraceRecorder&
+{
+	static auto s_recorder = TraceRecorder{};
+	return s_recorder;
+}
+
+
+
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+	if (enabled == m_enabled.load(std::memory_order_relaxed)) { return; }
+
+	if (enabled)
+	{
+		m_events.forEach([this](Rings::Buffer& buffer) {
+			buffer.reader.read_max(m_events.capacity());
+			buffer.data.events.clear();
+		});
+		m_eventCount = 0;
+		m_droppedCount = 0;
+		m_overflowCount = 0;
+		m_startTime = now();
+
+		m_events.startDraining(CollectionInterval, [this] { collect(); });
+		m_enabled.store(true, std::memory_order_relaxed);
+		return;
+	}
+
+	m_enabled.store(false, std::memory_order_relaxed);
+	m_events.stopDraining();
+
+	// Pick up the events written since the last collection
+	collect();
+}
+
+
+
+
+void TraceRecorder::setThreadName(const char* name)
+{
+	t_threadName = name;
+	if (const auto buffer = Rings::existing()) { buffer->data.name.store(name, std::memory_order_relaxed); }
+}
+
+
+
+
+bool TraceRecorder::writeTrace(const QString& fileName)
+{
+	auto file = QFile{fileName};
+	if (!file.open(QFile::WriteOnly | QFile::Truncate)) { return false; }
+
+	auto stream = QTextStream{&file};
+	stream << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":"
+		<< m_droppedCount + m_overflowCount.load(std::memory_order_relaxed) << "},\"traceEvents\":[\n";
+	stream << R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"LMMS"}})";
+
+	auto sourceNames = QHash<JobProfiler::SourceId, QString>{};
+	const auto eventName = [&sourceNames](const Event& event) {
+		if (event.source == JobProfiler::NoSource) { return jsonString(event.name); }
+
+		auto name = sourceNames.find(event.source);
+		if (name == sourceNames.end())
+		{
+			// Sources that were removed during the recording can no longer be named
+			auto sourceName = JobProfiler::instance().sourceName(event.source);
+			if (sourceName.isEmpty()) { sourceName = QString{"%1 #%2"}.arg(event.name).arg(event.source); }
+			name = sourceNames.insert(event.source, jsonString(sourceName));
+		}
+		return *name;
+	};
+
+	m_events.forEach([&](const Rings::Buffer& buffer) {
+		if (buffer.data.events.empty()) { return; }
+
+		const auto threadName = buffer.data.name.load(std::memory_order_relaxed);
+		stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.id << ",\"args\":{\"name\":"
+			<< jsonString(threadName ? QString{threadName} : QString{"Thread %1"}.arg(buffer.id)) << "}}";
+
+		for (const auto& event : buffer.data.events)
+		{
+			stream << ",\n{\"name\":" << eventName(event) << ",\"cat\":\"" << categoryName(event.category)
+				<< "\",\"pid\":1,\"tid\":" << buffer.id << ",\"ts\":" << microseconds(event.start - m_startTime);
+
+			if (event.duration < 0) { stream << ",\"ph\":\"i\",\"s\":\"g\"}"; }
+			else { stream << ",\"ph\":\"X\",\"dur\":" << microseconds(event.duration) << '}'; }
+		}
+	});
+
+	stream << "\n]}\n";
+	stream.flush();
+	return file.error() == QFile::NoError;
+}
+
+
+
+
+void TraceRecorder::record(Category category, const char* name, JobProfiler::SourceId source, std::int64_t start,
+	std::int64_t duration)
+{
+	const auto event = Event{name, source, category, start, duration};
+	if (threadBuffer()->ring.write(&event, 1) == 0) { m_overflowCount.fetch_add(1, std::memory_order_relaxed); }
+}
+
+
+
+
+auto TraceRecorder::threadBuffer() -> Rings::Buffer*
+{
+	if (const auto buffer = Rings::existing()) { return buffer; }
+
+	// Threads may be named before their first event
+	const auto buffer = m_events.local();
+	buffer->data.name.store(t_threadName, std::memory_order_relaxed);
+	return buffer;
+}
+
+
+
+
+void TraceRecorder::collect()
+{
+	m_events.forEach([this](Rings::Buffer& buffer) {
+		const auto events = buffer.reader.read_max(m_events.capacity());
+		for (std::size_t i = 0; i < events.size(); ++i)
+		{
+			if (m_eventCount == MaxEvents)
+			{
+				++m_droppedCount;
+				continue;
+			}
+
+			buffer.data.events.push_back(events[i]);
+			++m_eventCount;
+		}
+	});
+}
+
+
+
+
+auto TraceRecorder::categoryName(Category category) -> const char*
+{
+	switch (category)
+	{
+		case Category::Engine: return "engine";
+		case Category::Job: return "job";
+		case Category::Effect: return "effect";
+		case Category::RemotePlugin: return "remote_plugin";
+		case Category::XRun: return "xrun";
+		case Category::Load: return "load";
+		case Category::Journal: return "journal";
+	}
+	return "";
+}
+
+} // namespace lmms
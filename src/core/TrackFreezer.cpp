@@ -0,0 +1,204 @@
+/*
+ * TrackFreezer.cpp - Offline rendering of tracks for freezing
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "TrackFreezer.h"
+
+#include "AudioDevice.h"
+#include "AudioEngine.h"
+#include "FrozenAudio.h"
+#include "InstrumentTrack.h"
+#include "PatternStore.h"
+#include "PerfLog.h"
+#include "ProjectJournal.h"
+#include "Song.h"
+
+namespace lmms
+{
+
+
+TrackFreezer::TrackFreezer(InstrumentTrack* track)
+	: m_track(track)
+	, m_audio(std::make_unique<FrozenAudio>())
+{
+	connect(this, &QThread::finished, this, &TrackFreezer::finishProcessing);
+}
+
+
+
+
+TrackFreezer::~TrackFreezer()
+{
+	abortProcessing();
+	finishProcessing();
+}
+
+
+
+
+void TrackFreezer::startProcessing()
+{
+	if (!m_track || m_processing) { return; }
+	m_processing = true;
+
+	m_track->unfreeze();
+
+	// Muting the other tracks is part of rendering, not an edit to undo
+	const auto journal = Engine::projectJournal();
+	const auto journalling = journal->isJournalling();
+	journal->setJournalling(false);
+
+	m_trackWasMuted = m_track->isMuted();
+	m_track->setMuted(false);
+	for (const auto container : std::initializer_list<TrackContainer*>{Engine::getSong(), Engine::patternStore()})
+	{
+		for (const auto track : container->tracks())
+		{
+			if (track != m_track.data() && !track->isMuted()
+				&& (track->type() == Track::Type::Instrument || track->type() == Track::Type::Sample))
+			{
+				track->setMuted(true);
+				m_mutedTracks.push_back(track);
+			}
+		}
+	}
+
+	journal->setJournalling(journalling);
+
+	// Render the song once from the start, including the bar after its end for release tails
+	const auto song = Engine::getSong();
+	m_renderBetweenMarkers = song->renderBetweenMarkers();
+	m_exportLoop = song->exportLoop();
+	m_loopRenderCount = song->getLoopRenderCount();
+	song->setRenderBetweenMarkers(false);
+	song->setExportLoop(false);
+	song->setLoopRenderCount(1);
+
+	// Have to do audio engine stuff with GUI-thread affinity, like ProjectRenderer does
+	const auto audioEngine = Engine::audioEngine();
+	audioEngine->storeAudioDevice();
+	m_device = new AudioDevice(DEFAULT_CHANNELS, audioEngine);
+	audioEngine->setAudioDevice(m_device, false, false);
+
+	audioEngine->requestChangeInModel();
+	m_track->audioBusHandle()->setFreezeCapture(m_audio.get());
+	audioEngine->doneChangeInModel();
+
+	connect(journal, &ProjectJournal::objectChanged, this, &TrackFreezer::checkChange, Qt::DirectConnection);
+
+	start(
+#ifndef LMMS_BUILD_WIN32
+		QThread::HighPriority
+#endif
+	);
+}
+
+
+
+
+void TrackFreezer::abortProcessing()
+{
+	m_abort = true;
+	wait();
+}
+
+
+
+
+void TrackFreezer::run()
+{
+	PerfLogTimer perfLog("Track Freeze");
+
+	const auto song = Engine::getSong();
+	song->startExport();
+	Engine::audioEngine()->startProcessing(false);
+
+	while (!song->isExportDone() && !m_abort && !m_outdated)
+	{
+		m_device->processNextBuffer();
+
+		const auto progress = song->getExportProgress();
+		if (progress != m_progress)
+		{
+			m_progress = progress;
+			emit progressChanged(progress);
+		}
+	}
+
+	Engine::audioEngine()->stopProcessing();
+	song->stopExport();
+}
+
+
+
+
+void TrackFreezer::finishProcessing()
+{
+	if (!m_processing) { return; }
+	m_processing = false;
+
+	disconnect(Engine::projectJournal(), &ProjectJournal::objectChanged, this, &TrackFreezer::checkChange);
+
+	const auto audioEngine = Engine::audioEngine();
+	if (m_track)
+	{
+		audioEngine->requestChangeInModel();
+		m_track->audioBusHandle()->setFreezeCapture(nullptr);
+		audioEngine->doneChangeInModel();
+	}
+
+	// Also deletes the device
+	audioEngine->restoreAudioDevice();
+	m_device = nullptr;
+
+	const auto song = Engine::getSong();
+	song->setRenderBetweenMarkers(m_renderBetweenMarkers);
+	song->setExportLoop(m_exportLoop);
+	song->setLoopRenderCount(m_loopRenderCount);
+
+	const auto journal = Engine::projectJournal();
+	const auto journalling = journal->isJournalling();
+	journal->setJournalling(false);
+
+	for (const auto& track : m_mutedTracks)
+	{
+		if (track) { track->setMuted(false); }
+	}
+	m_mutedTracks.clear();
+	if (m_track) { m_track->setMuted(m_trackWasMuted); }
+
+	journal->setJournalling(journalling);
+
+	if (m_track && !m_abort && !m_outdated && m_audio->finish()) { m_track->freeze(std::move(m_audio)); }
+}
+
+
+
+
+void TrackFreezer::checkChange(JournallingObject* object)
+{
+	if (m_track && m_track->frozenAudioDependsOn(object)) { m_outdated = true; }
+}
+
+
+} // namespace lmms
@@ -30,6 +30,7 @@
 #include "endian_handling.h"
 #include "AudioEngine.h"
 #include "ConfigManager.h"
+#include "TraceRecorder.h"
 
 namespace lmms
 {
@@ -192,6 +193,7 @@ int AudioAlsa::handleError( int _err )
 	if( _err == -EPIPE )
 	{
 		// under-run
+		TraceRecorder::instance().instant(TraceRecorder::Category::XRun, "ALSA underrun");
 		_err = snd_pcm_prepare( m_handle );
 		if( _err < 0 )
 			printf( "Can't recover from underrun, prepare "
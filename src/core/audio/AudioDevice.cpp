@@ -35,7 +35,8 @@ AudioDevice::AudioDevice( const ch_cnt_t _channels, AudioEngine*  _audioEngine )
 	m_sampleRate( _audioEngine->outputSampleRate() ),
 	m_channels( _channels ),
 	m_audioEngine( _audioEngine ),
-	m_buffer(new SampleFrame[audioEngine()->framesPerPeriod()])
+	// The period may still change to match the device, but never exceeds DEFAULT_BUFFER_SIZE
+	m_buffer(new SampleFrame[DEFAULT_BUFFER_SIZE])
 {
 }
 
@@ -26,6 +26,7 @@
 
 #ifdef LMMS_HAVE_JACK
 
+#include <QCheckBox>
 #include <QFormLayout>
 #include <QLabel>
 #include <QLineEdit>
@@ -34,12 +35,16 @@
 #include <QToolButton>
 #include <QStringList>
 
+#include "AudioBusHandle.h"
 #include "AudioEngine.h"
 #include "ConfigManager.h"
 #include "GuiApplication.h"
 #include "MainWindow.h"
 #include "MidiJack.h"
+#include "MixHelpers.h"
+#include "TraceRecorder.h"
 
+#include <algorithm>
 #include <cstdio>
 
 
@@ -47,6 +52,7 @@ namespace
 {
 static const QString audioJackClass("audiojack");
 static const QString clientNameKey("clientname");
+static const QString multiOutputKey("multioutput");
 static const QString disconnectedRepresentation("-");
 
 QString getOutputKeyByChannel(size_t channel)
@@ -101,10 +107,11 @@ AudioJack::AudioJack(bool& successful, AudioEngine* audioEngineParam)
 	, m_client(nullptr)
 	, m_active(false)
 	, m_midiClient(nullptr)
-	, m_tempOutBufs(new jack_default_audio_sample_t*[channels()])
-	, m_outBuf(new SampleFrame[audioEngine()->framesPerPeriod()])
+	, m_outBuf(new SampleFrame[DEFAULT_BUFFER_SIZE])
+	, m_curBuf(m_outBuf)
 	, m_framesDoneInCurBuf(0)
 	, m_framesToDoInCurBuf(0)
+	, m_multiOutput(ConfigManager::inst()->value(audioJackClass, multiOutputKey).toInt())
 {
 	m_stopped = true;
 
@@ -122,12 +129,12 @@ AudioJack::AudioJack(bool& successful, AudioEngine* audioEngineParam)
 AudioJack::~AudioJack()
 {
 	AudioJack::stopProcessing();
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-	while (m_portMap.size())
+	while (!m_busPorts.empty())
 	{
-		unregisterPort(m_portMap.begin().key());
+		unregisterPort(m_busPorts.back().bus);
 	}
-#endif
+	// The engine may not be using this device anymore, so it does not necessarily apply them
+	applyPortChanges();
 
 	if (m_client != nullptr)
 	{
@@ -135,8 +142,6 @@ AudioJack::~AudioJack()
 		jack_client_close(m_client);
 	}
 
-	delete[] m_tempOutBufs;
-
 	delete[] m_outBuf;
 }
 
@@ -145,8 +150,23 @@ AudioJack::~AudioJack()
 
 void AudioJack::restartAfterZombified()
 {
+	// The ports went away with the old client
+	auto buses = std::vector<AudioBusHandle*>{};
+	{
+		const auto guard = audioEngine()->requestChangesGuard();
+		const auto lock = std::lock_guard{m_portsMutex};
+		for (const auto& busPorts : m_busPorts) { buses.push_back(busPorts.bus); }
+		m_busPorts.clear();
+		std::erase_if(m_portChanges,
+			[](const PortChange& change) { return change.type == PortChange::Type::Unregister; });
+	}
+	m_outputPorts.clear();
+	m_inputPorts.clear();
+
 	if (initJackClient())
 	{
+		for (const auto& bus : buses) { registerPort(bus); }
+		applyPortChanges();
 		m_active = false;
 		startProcessing();
 		QMessageBox::information(gui::getGUI()->mainWindow(), tr("JACK client restarted"),
@@ -217,6 +237,14 @@ bool AudioJack::initJackClient()
 	// set shutdown-callback
 	jack_on_shutdown(m_client, shutdownCallback, this);
 
+	// set xrun-callback
+	jack_set_xrun_callback(m_client,
+		[](void*) -> int {
+			TraceRecorder::instance().instant(TraceRecorder::Category::XRun, "JACK xrun");
+			return 0;
+		},
+		this);
+
 	if (jack_get_sample_rate(m_client) != sampleRate()) { setSampleRate(jack_get_sample_rate(m_client)); }
 
 	for (ch_cnt_t ch = 0; ch < channels(); ++ch)
@@ -337,19 +365,16 @@ void AudioJack::stopProcessing()
 
 void AudioJack::registerPort(AudioBusHandle* port)
 {
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-	// make sure, port is not already registered
-	unregisterPort(port);
-	const QString name[2] = {port->name() + " L", port->name() + " R"};
+	if (!m_multiOutput || m_client == nullptr) { return; }
 
-	for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
-	{
-		m_portMap[port].ports[ch] = jack_port_register(
-			m_client, name[ch].toLatin1().constData(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
-	}
-#else
-	(void)port;
-#endif
+	// Releasing the guard applies the change unless the caller keeps the engine locked
+	const auto guard = audioEngine()->requestChangesGuard();
+	const auto lock = std::lock_guard{m_portsMutex};
+
+	// make sure, port is not already registered
+	forgetBus(port);
+	m_buses.push_back(port);
+	m_portChanges.push_back(PortChange{PortChange::Type::Register, port, port->name(), {}});
 }
 
 
@@ -357,38 +382,211 @@ void AudioJack::registerPort(AudioBusHandle* port)
 
 void AudioJack::unregisterPort(AudioBusHandle* port)
 {
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-	if (m_portMap.contains(port))
+	const auto guard = audioEngine()->requestChangesGuard();
+	const auto lock = std::lock_guard{m_portsMutex};
+	forgetBus(port);
+}
+
+
+
+
+void AudioJack::renamePort(AudioBusHandle* port)
+{
+	const auto guard = audioEngine()->requestChangesGuard();
+	const auto lock = std::lock_guard{m_portsMutex};
+	if (std::find(m_buses.begin(), m_buses.end(), port) == m_buses.end()) { return; }
+
+	m_portChanges.push_back(PortChange{PortChange::Type::Rename, port, port->name(), {}});
+}
+
+
+
+
+void AudioJack::forgetBus(AudioBusHandle* bus)
+{
+	std::erase(m_buses, bus);
+	std::erase_if(m_portChanges, [bus](const PortChange& change) { return change.bus == bus; });
+
+	const auto it = std::find_if(m_busPorts.begin(), m_busPorts.end(),
+		[bus](const BusPorts& busPorts) { return busPorts.bus == bus; });
+	if (it == m_busPorts.end()) { return; }
+
+	m_portChanges.push_back(PortChange{PortChange::Type::Unregister, nullptr, {}, it->ports});
+	m_busPorts.erase(it);
+}
+
+
+
+
+void AudioJack::applyPortChanges()
+{
+	const auto applying = std::lock_guard{m_applyMutex};
+	// Locking the engine below calls this again, which must not reorder the changes
+	if (m_applyingPortChanges) { return; }
+
+	m_applyingPortChanges = true;
+	while (m_client != nullptr)
 	{
-		for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+		auto changes = std::vector<PortChange>{};
+		{
+			const auto lock = std::lock_guard{m_portsMutex};
+			changes.swap(m_portChanges);
+		}
+		if (changes.empty()) { break; }
+
+		for (const auto& change : changes)
 		{
-			if (m_portMap[port].ports[ch] != nullptr) { jack_port_unregister(m_client, m_portMap[port].ports[ch]); }
+			applyPortChange(change);
 		}
-		m_portMap.erase(m_portMap.find(port));
 	}
-#else
-	(void)port;
-#endif
+	m_applyingPortChanges = false;
 }
 
-void AudioJack::renamePort(AudioBusHandle* port)
+
+
+
+void AudioJack::applyPortChange(const PortChange& change)
 {
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-	if (m_portMap.contains(port))
+	switch (change.type)
+	{
+	case PortChange::Type::Register:
 	{
-		const QString name[2] = {port->name() + " L", port->name() + " R"};
+		const QString name = uniqueBusPortName(change.name);
+		auto busPorts = BusPorts{change.bus, {}};
 		for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
 		{
+			const QString portName = name + " " + (ch % 2 ? "R" : "L");
+			busPorts.ports[ch] = jack_port_register(
+				m_client, portName.toLatin1().constData(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+		}
+
+		auto unused = busPorts.ports;
+		if (std::find(busPorts.ports.begin(), busPorts.ports.end(), nullptr) != busPorts.ports.end())
+		{
+			std::fprintf(stderr, "no more JACK-ports available!\n");
+		}
+		else
+		{
+			const auto guard = audioEngine()->requestChangesGuard();
+			const auto lock = std::lock_guard{m_portsMutex};
+			// The bus handle may have been unregistered while its ports were being registered
+			if (std::find(m_buses.begin(), m_buses.end(), change.bus) != m_buses.end())
+			{
+				const auto it = std::find_if(m_busPorts.begin(), m_busPorts.end(),
+					[&change](const BusPorts& other) { return other.bus == change.bus; });
+				if (it == m_busPorts.end())
+				{
+					m_busPorts.push_back(busPorts);
+					unused = {};
+				}
+				else { std::swap(it->ports, unused); }
+			}
+		}
+
+		for (const auto& jackPort : unused)
+		{
+			if (jackPort != nullptr) { jack_port_unregister(m_client, jackPort); }
+		}
+		break;
+	}
+	case PortChange::Type::Unregister:
+		for (const auto& jackPort : change.ports)
+		{
+			jack_port_unregister(m_client, jackPort);
+		}
+		break;
+	case PortChange::Type::Rename:
+	{
+		auto busPorts = BusPorts{};
+		{
+			const auto guard = audioEngine()->requestChangesGuard();
+			const auto it = std::find_if(m_busPorts.begin(), m_busPorts.end(),
+				[&change](const BusPorts& other) { return other.bus == change.bus; });
+			if (it == m_busPorts.end()) { break; }
+			busPorts = *it;
+		}
+
+		// Only this function unregisters ports, so they stay valid without the engine being locked
+		const QString name = uniqueBusPortName(change.name, &busPorts);
+		for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+		{
+			const QString portName = name + " " + (ch % 2 ? "R" : "L");
 #ifdef LMMS_HAVE_JACK_PRENAME
-			jack_port_rename(m_client, m_portMap[port].ports[ch], name[ch].toLatin1().constData());
+			jack_port_rename(m_client, busPorts.ports[ch], portName.toLatin1().constData());
 #else
-			jack_port_set_name(m_portMap[port].ports[ch], name[ch].toLatin1().constData());
+			jack_port_set_name(busPorts.ports[ch], portName.toLatin1().constData());
 #endif
 		}
+		break;
 	}
-#else
-	(void)port;
-#endif // AUDIO_BUS_HANDLE_SUPPORT
+	}
+}
+
+
+
+
+QString AudioJack::uniqueBusPortName(const QString& name, const BusPorts* own) const
+{
+	const auto clientName = QString{jack_get_client_name(m_client)};
+	const auto isTaken = [&](const QString& candidate) {
+		for (const auto& side : {" L", " R"})
+		{
+			const auto fullName = clientName + ":" + candidate + side;
+			const auto jackPort = jack_port_by_name(m_client, fullName.toLatin1().constData());
+			if (jackPort != nullptr
+				&& (own == nullptr || std::find(own->ports.begin(), own->ports.end(), jackPort) == own->ports.end()))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	auto candidate = name;
+	for (int i = 2; isTaken(candidate); ++i)
+	{
+		candidate = name + " " + QString::number(i);
+	}
+	return candidate;
+}
+
+
+
+
+fpp_t AudioJack::callbackFrames() const
+{
+	return m_client != nullptr ? jack_get_buffer_size(m_client) : 0;
+}
+
+
+
+
+f_cnt_t AudioJack::captureLatency() const
+{
+	return portLatency(m_inputPorts, JackCaptureLatency);
+}
+
+
+
+
+f_cnt_t AudioJack::playbackLatency() const
+{
+	return portLatency(m_outputPorts, JackPlaybackLatency);
+}
+
+
+
+
+f_cnt_t AudioJack::portLatency(const std::vector<jack_port_t*>& ports, jack_latency_callback_mode_t mode)
+{
+	auto latency = f_cnt_t{0};
+	for (const auto& jackPort : ports)
+	{
+		auto range = jack_latency_range_t{};
+		jack_port_get_latency_range(jackPort, mode, &range);
+		latency = std::max<f_cnt_t>(latency, range.max);
+	}
+	return latency;
 }
 
 
@@ -404,79 +602,91 @@ int AudioJack::processCallback(jack_nframes_t nframes)
 		m_midiClient.load()->JackMidiWrite(nframes);
 	}
 
-	for (int c = 0; c < channels(); ++c)
-	{
-		m_tempOutBufs[c] = (jack_default_audio_sample_t*)jack_port_get_buffer(m_outputPorts[c], nframes);
-	}
+	const auto port = [nframes](jack_port_t* jackPort) {
+		return static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer(jackPort, nframes));
+	};
 
-#ifdef AUDIO_BUS_HANDLE_SUPPORT
-	const int frames = std::min<int>(nframes, audioEngine()->framesPerPeriod());
-	for (JackPortMap::iterator it = m_portMap.begin(); it != m_portMap.end(); ++it)
+	// Hand over the input first, so that periods rendered below can already use it
+	MixHelpers::interleave(port(m_inputPorts[0]), port(m_inputPorts[1]), m_inputFrameBuffer.data(), nframes);
+	audioEngine()->pushInputFrames(m_inputFrameBuffer.data(), nframes);
+
+	// Without a FIFO writer, e.g. when matching the period of JACK, the engine renders right here. In multi-output
+	// mode, this also keeps the ports and buffers of the bus handles intact. The callback must not wait while the
+	// model is being changed though, so it outputs silence for this cycle then, for which it only locks the list of
+	// bus ports.
+	const bool lockModel = m_multiOutput || !audioEngine()->hasFifoWriter();
+	auto modelLock = lockModel ? audioEngine()->tryLockModel() : std::unique_lock<std::recursive_mutex>{};
+	const bool render = !lockModel || modelLock.owns_lock();
+	const auto portsLock = render ? std::unique_lock<std::mutex>{} : std::unique_lock{m_portsMutex};
+	// The bus handles only belong to the current period if the engine does not render ahead
+	const bool busOutputs = render && m_multiOutput && !audioEngine()->hasFifoWriter();
+
+	jack_nframes_t done = 0;
+	while (render && done < nframes && !m_stopped)
 	{
-		for (ch_cnt_t ch = 0; ch < channels(); ++ch)
+		if (m_framesDoneInCurBuf == m_framesToDoInCurBuf && !nextPeriod())
 		{
-			if (it.value().ports[ch] == nullptr) { continue; }
-			jack_default_audio_sample_t* buf
-				= (jack_default_audio_sample_t*)jack_port_get_buffer(it.value().ports[ch], nframes);
-			for (int frame = 0; frame < frames; ++frame)
-			{
-				buf[frame] = it.key()->buffer()[frame][ch];
-			}
+			m_stopped = true;
+			break;
 		}
-	}
-#endif
 
-	jack_nframes_t done = 0;
-	while (done < nframes && !m_stopped)
-	{
-		jack_nframes_t todo = std::min<jack_nframes_t>(nframes - done, m_framesToDoInCurBuf - m_framesDoneInCurBuf);
-		for (int c = 0; c < channels(); ++c)
+		const auto todo = std::min<jack_nframes_t>(nframes - done, m_framesToDoInCurBuf - m_framesDoneInCurBuf);
+		MixHelpers::deinterleave(m_curBuf + m_framesDoneInCurBuf,
+			port(m_outputPorts[0]) + done, port(m_outputPorts[1]) + done, todo);
+
+		if (busOutputs)
 		{
-			jack_default_audio_sample_t* o = m_tempOutBufs[c];
-			for (jack_nframes_t frame = 0; frame < todo; ++frame)
+			for (const auto& busPorts : m_busPorts)
 			{
-				o[done + frame] = m_outBuf[m_framesDoneInCurBuf + frame][c];
+				MixHelpers::deinterleave(busPorts.bus->buffer() + m_framesDoneInCurBuf,
+					port(busPorts.ports[0]) + done, port(busPorts.ports[1]) + done, todo);
 			}
 		}
+
 		done += todo;
 		m_framesDoneInCurBuf += todo;
-		if (m_framesDoneInCurBuf == m_framesToDoInCurBuf)
-		{
-			m_framesToDoInCurBuf = getNextBuffer(m_outBuf);
-			m_framesDoneInCurBuf = 0;
-			if (!m_framesToDoInCurBuf)
-			{
-				m_stopped = true;
-				break;
-			}
-		}
 	}
 
-	if (nframes != done)
+	for (const auto& jackPort : m_outputPorts)
 	{
-		for (int c = 0; c < channels(); ++c)
-		{
-			jack_default_audio_sample_t* b = m_tempOutBufs[c] + done;
-			memset(b, 0, sizeof(*b) * (nframes - done));
-		}
+		std::fill(port(jackPort) + done, port(jackPort) + nframes, 0.f);
 	}
-
-	for (int c = 0; c < channels(); ++c)
+	for (const auto& busPorts : m_busPorts)
 	{
-		jack_default_audio_sample_t* jack_input_buffer = (jack_default_audio_sample_t*) jack_port_get_buffer(m_inputPorts[c], nframes);
-
-		for (jack_nframes_t frame = 0; frame < nframes; frame++)
+		const auto busDone = busOutputs ? done : 0;
+		for (const auto& jackPort : busPorts.ports)
 		{
-			m_inputFrameBuffer[frame][c] = static_cast<sample_t>(jack_input_buffer[frame]);
+			std::fill(port(jackPort) + busDone, port(jackPort) + nframes, 0.f);
 		}
 	}
-	audioEngine()->pushInputFrames (m_inputFrameBuffer.data(), nframes);
+
 	return 0;
 }
 
 
 
 
+bool AudioJack::nextPeriod()
+{
+	if (m_multiOutput && !audioEngine()->hasFifoWriter())
+	{
+		// The engine renders right here, so its buffer stays valid until the next period and need not be copied
+		m_curBuf = audioEngine()->nextBuffer();
+		m_framesToDoInCurBuf = m_curBuf ? audioEngine()->framesPerPeriod() : 0;
+	}
+	else
+	{
+		m_curBuf = m_outBuf;
+		m_framesToDoInCurBuf = getNextBuffer(m_outBuf);
+	}
+
+	m_framesDoneInCurBuf = 0;
+	return m_framesToDoInCurBuf > 0;
+}
+
+
+
+
 int AudioJack::staticProcessCallback(jack_nframes_t nframes, void* udata)
 {
 	return static_cast<AudioJack*>(udata)->processCallback(nframes);
@@ -519,6 +729,10 @@ AudioJack::setupWidget::setupWidget(QWidget* parent)
 
 	form->addRow(tr("Client name"), m_clientName);
 
+	m_multiOutput = new QCheckBox(tr("Separate outputs for each track"), this);
+	m_multiOutput->setChecked(cm->value(audioJackClass, multiOutputKey).toInt());
+	form->addRow(m_multiOutput);
+
 	auto buildToolButton = [this](QWidget* parent, const QString& currentSelection, const std::vector<std::string>& names, const QString& filteredLMMSClientName)
 	{
 		auto toolButton = new QToolButton(parent);
@@ -569,6 +783,7 @@ AudioJack::setupWidget::setupWidget(QWidget* parent)
 void AudioJack::setupWidget::saveSettings()
 {
 	ConfigManager::inst()->setValue(audioJackClass, clientNameKey, m_clientName->text());
+	ConfigManager::inst()->setValue(audioJackClass, multiOutputKey, QString::number(m_multiOutput->isChecked()));
 
 	for (size_t i = 0; i < m_outputDevices.size(); ++i)
 	{
@@ -63,14 +63,17 @@
 #include "NotePlayHandle.h"
 #include "embed.h"
 #include "Engine.h"
+#include "EngineBenchmark.h"
 #include "GuiApplication.h"
 #include "ImportFilter.h"
+#include "JobProfiler.h"
 #include "MainWindow.h"
 #include "MixHelpers.h"
 #include "OutputSettings.h"
 #include "ProjectRenderer.h"
 #include "RenderManager.h"
 #include "Song.h"
+#include "TraceRecorder.h"
 
 #ifdef LMMS_DEBUG_FPE
 #include <fenv.h> // For feenableexcept
@@ -172,6 +175,9 @@ void printHelp()
 		"  makebundle <in> [out]                 Make a project bundle from the project\n"
 		"                                        file <in> saving the resulting bundle\n"
 		"                                        as <out>\n"
+		"  benchmark [options...] [<project>...] Render synthetic stress projects and the\n"
+		"                                        given projects as fast as possible and\n"
+		"                                        report the performance as JSON\n"
 		"\nGlobal options:\n"
 		"      --allowroot                Bypass root user startup check (use with\n"
 		"          caution).\n"
@@ -203,10 +209,26 @@ void printHelp()
 		"          If not specified, render will overwrite the input file\n"
 		"          For \"rendertracks\", this might be required\n"
 		"  -p, --profile <out>            Dump profiling information to file <out>\n"
+		"      --profile-jobs <out>       Dump the processing time of each track, effect\n"
+		"          and mixer channel to file <out> (JSON if it ends with .json, else CSV)\n"
+		"      --trace <out>              Record a timeline of the audio engine threads,\n"
+		"          the project loading phases and undo check points to file <out>\n"
+		"          in Chrome trace format, viewable at https://ui.perfetto.dev\n"
 		"  -s, --samplerate <samplerate>  Specify output samplerate in Hz\n"
 		"          Range: 44100 (default) to 192000\n"
 		"          Possible values: 1, 2, 4, 8\n"
-		"          Default: 2\n\n",
+		"          Default: 2\n"
+		"\nOptions for \"benchmark\":\n"
+		"  -o, --output <path>            Write the report to <path> instead of\n"
+		"          standard out\n"
+		"      --baseline <report>        Compare with an earlier report and fail if\n"
+		"          a project got slower than the tolerance allows\n"
+		"      --tolerance <percent>      Allowed slowdown compared to the baseline\n"
+		"          Default: 10\n"
+		"      --seconds <seconds>        Render at most <seconds> of each project,\n"
+		"          or all of it if 0\n"
+		"          Default: 60\n"
+		"      --no-synthetic             Only measure the given projects\n\n",
 		LMMS_VERSION, LMMS_PROJECT_COPYRIGHT );
 }
 
@@ -254,7 +276,10 @@ int main( int argc, char * * argv )
 	bool allowRoot = false;
 	bool renderLoop = false;
 	bool renderTracks = false;
-	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
+	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, jobProfilerOutputFile, traceOutputFile, configFile;
+	bool benchmark = false;
+	auto benchmarkOptions = EngineBenchmark::Options{};
+	QString benchmarkGenerateDir, benchmarkMeasureProject;
 
 	// first of two command-line parsing stages
 	for (int i = 1; i < argc; ++i)
@@ -280,6 +305,10 @@ int main( int argc, char * * argv )
 			coreOnly = true;
 			renderTracks = true;
 		}
+		else if (arg == "benchmark")
+		{
+			coreOnly = true;
+		}
 		else if (arg == "--allowroot")
 		{
 			allowRoot = true;
@@ -483,6 +512,70 @@ int main( int argc, char * * argv )
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 			renderOut = fileToLoad;
 		}
+		else if (arg == "benchmark")
+		{
+			benchmark = true;
+		}
+		else if (arg == "--baseline")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No baseline specified");
+			}
+
+			benchmarkOptions.baselineFile = QString::fromLocal8Bit(argv[i]);
+		}
+		else if (arg == "--tolerance")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No tolerance specified");
+			}
+
+			bool ok = false;
+			const auto tolerance = QString{argv[i]}.toFloat(&ok);
+			if (!ok || tolerance < 0 || tolerance > 100)
+			{
+				return usageError(QString{"Invalid tolerance %1"}.arg(argv[i]));
+			}
+			benchmarkOptions.tolerance = tolerance / 100;
+		}
+		else if (arg == "--seconds")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No duration specified");
+			}
+
+			bool ok = false;
+			benchmarkOptions.maxSeconds = QString{argv[i]}.toInt(&ok);
+			if (!ok || benchmarkOptions.maxSeconds < 0)
+			{
+				return usageError(QString{"Invalid duration %1"}.arg(argv[i]));
+			}
+		}
+		else if (arg == "--no-synthetic")
+		{
+			benchmarkOptions.synthetic = false;
+		}
+		else if (arg == "--generate" || arg == "--measure")
+		{
+			// Used internally by the benchmark, which measures each project in a separate process
+			++i;
+
+			if (i == argc)
+			{
+				return noInputFileError();
+			}
+
+			(arg == "--generate" ? benchmarkGenerateDir : benchmarkMeasureProject) = QString::fromLocal8Bit(argv[i]);
+		}
 		else if( arg == "--loop" || arg == "-l" )
 		{
 			renderLoop = true;
@@ -639,6 +732,28 @@ int main( int argc, char * * argv )
 
 			profilerOutputFile = QString::fromLocal8Bit( argv[i] );
 		}
+		else if (arg == "--profile-jobs")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No job profile specified");
+			}
+
+			jobProfilerOutputFile = QString::fromLocal8Bit(argv[i]);
+		}
+		else if (arg == "--trace")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No trace file specified");
+			}
+
+			traceOutputFile = QString::fromLocal8Bit(argv[i]);
+		}
 		else if( arg == "--config" || arg == "-c" )
 		{
 			++i;
@@ -656,6 +771,11 @@ int main( int argc, char * * argv )
 			{
 				return usageError( QString( "Invalid option %1" ).arg( argv[i] ) );
 			}
+			if (benchmark)
+			{
+				benchmarkOptions.projects << QString::fromLocal8Bit(argv[i]);
+				continue;
+			}
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 		}
 	}
@@ -708,6 +828,49 @@ int main( int argc, char * * argv )
 	}
 #endif
 
+	if (benchmark)
+	{
+		benchmarkOptions.outputFile = renderOut;
+		if (allowRoot) { benchmarkOptions.globalArguments << "--allowroot"; }
+		if (!configFile.isEmpty()) { benchmarkOptions.globalArguments << "--config" << configFile; }
+
+		const int ret = !benchmarkGenerateDir.isEmpty() ? EngineBenchmark::generateSyntheticProjects(benchmarkGenerateDir)
+			: !benchmarkMeasureProject.isEmpty()
+				? EngineBenchmark::measure(benchmarkMeasureProject, benchmarkOptions.maxSeconds, renderOut)
+				: EngineBenchmark::run(benchmarkOptions);
+		delete app;
+		return ret;
+	}
+
+	if (!jobProfilerOutputFile.isEmpty())
+	{
+		JobProfiler::instance().setEnabled(true);
+
+		// The sources, and with them their statistics, go away with the project. In GUI mode, that already happens
+		// when the main window is closed, before the event loop returns.
+		QObject::connect(Engine::inst(), &Engine::aboutToDestroy, [jobProfilerOutputFile] {
+			JobProfiler::instance().setEnabled(false);
+			if (!JobProfiler::instance().writeStats(jobProfilerOutputFile))
+			{
+				fprintf(stderr, "Could not write job profile to %s\n", jobProfilerOutputFile.toUtf8().constData());
+			}
+		});
+	}
+
+	if (!traceOutputFile.isEmpty())
+	{
+		TraceRecorder::instance().setEnabled(true);
+
+		// The names of the jobs in the trace come from the profiler sources, which go away with the project
+		QObject::connect(Engine::inst(), &Engine::aboutToDestroy, [traceOutputFile] {
+			TraceRecorder::instance().setEnabled(false);
+			if (!TraceRecorder::instance().writeTrace(traceOutputFile))
+			{
+				fprintf(stderr, "Could not write trace to %s\n", traceOutputFile.toUtf8().constData());
+			}
+		});
+	}
+
 	bool destroyEngine = false;
 
 	// if we have an output file for rendering, just render the song
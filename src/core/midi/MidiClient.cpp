@@ -25,7 +25,9 @@
 
 #include "MidiClient.h"
 
+#include <algorithm>
 #include <array>
+#include <utility>
 
 #include "MidiPort.h"
 
@@ -60,6 +62,7 @@ void MidiClient::applyPortName( MidiPort* )
 
 void MidiClient::addPort( MidiPort* port )
 {
+	const auto lock = std::lock_guard{m_portsMutex};
 	m_midiPorts.push_back( port );
 }
 
@@ -73,6 +76,7 @@ void MidiClient::removePort( MidiPort* port )
 		return;
 	}
 
+	const auto lock = std::lock_guard{m_portsMutex};
 	auto it = std::find(m_midiPorts.begin(), m_midiPorts.end(), port);
 	if( it != m_midiPorts.end() )
 	{
@@ -83,6 +87,27 @@ void MidiClient::removePort( MidiPort* port )
 
 
 
+void MidiClient::processQueuedInEvents(sample_rate_t sampleRate, fpp_t frames)
+{
+	const auto periodStart = MidiPort::now();
+	const auto periodLength = static_cast<std::int64_t>(frames) * 1'000'000'000 / sampleRate;
+
+	// After the engine was idle, only the events of the last period length are spread out, older ones play at once
+	const auto previousStart = std::max(std::exchange(m_lastPeriodStart, periodStart), periodStart - periodLength);
+
+	// If a port is being added or removed right now, the events wait for the next period
+	const auto lock = std::unique_lock{m_portsMutex, std::try_to_lock};
+	if (!lock.owns_lock()) { return; }
+
+	for (auto port : m_midiPorts)
+	{
+		port->processQueuedInEvents(previousStart, sampleRate, frames);
+	}
+}
+
+
+
+
 void MidiClient::subscribeReadablePort( MidiPort*, const QString& , bool )
 {
 }
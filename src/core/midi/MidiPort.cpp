@@ -24,6 +24,8 @@
  */
 
 #include <QDomElement>
+#include <algorithm>
+#include <chrono>
 
 #include "MidiPort.h"
 #include "MidiClient.h"
@@ -63,7 +65,9 @@ MidiPort::MidiPort( const QString& name,
 	m_outputProgramModel( 1, 1, MidiProgramCount, this, tr( "Output MIDI program" ) ),
 	m_baseVelocityModel( MidiMaxVelocity/2, 1, MidiMaxVelocity, this, tr( "Base velocity" ) ),
 	m_readableModel( false, this, tr( "Receive MIDI-events" ) ),
-	m_writableModel( false, this, tr( "Send MIDI-events" ) )
+	m_writableModel( false, this, tr( "Send MIDI-events" ) ),
+	m_inQueue(InQueueSize),
+	m_inQueueReader(m_inQueue)
 {
 	m_midiClient->addPort( this );
 
@@ -149,6 +153,19 @@ void MidiPort::processInEvent( const MidiEvent& event, const TimePos& time )
 			}
 		}
 
+		// SysEx data is owned by the client and only valid during this call
+		if (m_midiEventProcessor->queuesLiveInput() && inEvent.type() != MidiSysEx)
+		{
+			// The source port is only valid during this call as well
+			inEvent.setSourcePort(nullptr);
+
+			const auto queued = QueuedInEvent{inEvent, time, now()};
+			const auto lock = std::lock_guard{m_inQueueWriteMutex};
+			// Events are dropped if the audio thread stalls for long enough to fill the queue
+			m_inQueue.write(&queued, 1);
+			return;
+		}
+
 		m_midiEventProcessor->processInEvent( inEvent, time );
 	}
 }
@@ -156,6 +173,30 @@ void MidiPort::processInEvent( const MidiEvent& event, const TimePos& time )
 
 
 
+void MidiPort::processQueuedInEvents(std::int64_t periodStart, sample_rate_t sampleRate, fpp_t frames)
+{
+	const auto events = m_inQueueReader.read_max(InQueueSize);
+	for (std::size_t i = 0; i < events.size(); ++i)
+	{
+		const auto& queued = events[i];
+		const auto elapsed = std::clamp<std::int64_t>(queued.timestamp - periodStart, 0, 1'000'000'000);
+		const auto offset = std::min<std::int64_t>(elapsed * sampleRate / 1'000'000'000, frames - 1);
+		m_midiEventProcessor->processInEvent(queued.event, queued.time, static_cast<f_cnt_t>(offset));
+	}
+}
+
+
+
+
+std::int64_t MidiPort::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+
 void MidiPort::processOutEvent( const MidiEvent& event, const TimePos& time )
 {
 	// When output is enabled, route midi events if the selected channel matches
@@ -28,6 +28,7 @@
 #include <QMouseEvent>
 #include <QPushButton>
 #include <QPainter>
+#include <QToolTip>
 
 #include "EffectView.h"
 #include "DummyEffect.h"
@@ -243,6 +244,27 @@ void EffectView::mouseMoveEvent(QMouseEvent* event)
 
 
 
+// Show the processing time of the effect as the tooltip of the whole view
+bool EffectView::event(QEvent* event)
+{
+	if (event->type() == QEvent::ToolTip)
+	{
+		auto helpEvent = static_cast<QHelpEvent*>(event);
+		const auto& timing = effect()->timing();
+
+		QToolTip::showText(helpEvent->globalPos(),
+			tr("Processing time per period: %1 µs average, %2 µs max")
+				.arg(timing.meanTime(), 0, 'f', 1)
+				.arg(timing.maxTime()));
+		return true;
+	}
+
+	return PluginView::event(event);
+}
+
+
+
+
 void EffectView::paintEvent( QPaintEvent * )
 {
 	QPainter p( this );
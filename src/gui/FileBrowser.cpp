@@ -139,6 +139,10 @@ FileBrowser::FileBrowser(Type type, const QString& directories, const QString& f
 
 	m_previousFilterValue = "";
 
+	// Browsers of whole drives or the home directory are searched by walking them instead, as indexing them would
+	// take long and use up the filesystem watches of the system
+	if (!m_userDir.isEmpty() || !m_factoryDir.isEmpty()) { m_searchIndex = std::make_unique<FileIndex>(); }
+
 	if (m_type == Type::Favorites)
 	{
 		connect(ConfigManager::inst(), &ConfigManager::favoritesChanged, [this] {
@@ -235,7 +239,8 @@ void FileBrowser::onSearch(const QString& filter)
 	const auto searchTask = FileSearchJob::Task{.filter = filter,
 		.paths = directories,
 		.extensions = FileItem::defaultFilters().split(" "),
-		.dirFilters = directoryFilters};
+		.dirFilters = directoryFilters,
+		.index = m_searchIndex.get()};
 
 	m_searchTreeWidget->clear();
 	m_searchTreeWidget->show();
@@ -273,6 +278,7 @@ void FileBrowser::reloadTree()
 	m_fileBrowserTreeWidget->clear();
 
 	auto paths = m_directories.isEmpty() ? QStringList{} : m_directories.split('*');
+	if (m_searchIndex) { m_searchIndex->setRoots(paths); }
 
 	if (m_showUserContent && !m_showUserContent->isChecked())
 	{
@@ -1223,7 +1229,7 @@ void FileItem::determineFileType()
 	m_handling = FileHandling::NotSupported;
 
 	const QString ext = extension();
-	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" )
+	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" || ext == "mmpb" )
 	{
 		m_type = FileType::Project;
 		m_handling = FileHandling::LoadAsProject;
@@ -1307,7 +1313,7 @@ QString FileItem::extension(const QString & file )
 
 QString FileItem::defaultFilters()
 {
-	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz"};
+	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz", "*.mmpb"};
 	const auto presetFilters = QStringList{"*.xpf", "*.xml", "*.xiz", "*.lv2"};
 	const auto soundFontFilters = QStringList{"*.sf2", "*.sf3"};
 	const auto patchFilters = QStringList{"*.pat"};
@@ -0,0 +1,677 @@
+/*
+ * FileIndex.cpp - Persistent index of the files below the file browser roots
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "FileIndex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace lmms::gui {
+
+namespace {
+
+constexpr auto CacheMagic = quint32{0x4c4d4958}; // "LMIX"
+constexpr auto CacheVersion = quint32{1};
+constexpr auto RescanDelayMs = 500;
+//! Rescans of changed directories are saved once no more changes happened for this long
+constexpr auto SaveDelayMs = 30000;
+//! Directories beyond this are not watched, so that the index does not use up the inotify watches of the system
+constexpr auto MaxWatchedDirectories = 2048;
+constexpr auto AudioProbeBatchSize = std::size_t{256};
+
+auto normalizedPath(const QString& path) -> QString
+{
+	return QDir::cleanPath(QFileInfo{path}.absoluteFilePath());
+}
+
+auto fileName(const QString& path) -> QString
+{
+	return path.mid(path.lastIndexOf('/') + 1);
+}
+
+auto parentPath(const QString& path) -> QString
+{
+	return path.left(path.lastIndexOf('/'));
+}
+
+auto makeEntry(const QFileInfo& info, bool parentHidden) -> FileIndex::Entry
+{
+	auto entry = FileIndex::Entry{};
+	entry.path = info.filePath();
+	entry.foldedName = info.fileName().toCaseFolded();
+	entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+	entry.isDir = info.isDir();
+	entry.isHidden = parentHidden || info.isHidden();
+	return entry;
+}
+
+} // namespace
+
+FileIndex::FileIndex(QObject* parent)
+	: QObject(parent)
+{
+	m_rescanTimer.setSingleShot(true);
+	m_rescanTimer.setInterval(RescanDelayMs);
+	m_saveTimer.setSingleShot(true);
+	m_saveTimer.setInterval(SaveDelayMs);
+
+	connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &FileIndex::onDirectoryChanged);
+	connect(&m_rescanTimer, &QTimer::timeout, this, &FileIndex::rescanPendingDirectories);
+	connect(&m_saveTimer, &QTimer::timeout, this, [this] { enqueue([this] { save(); }); });
+}
+
+FileIndex::~FileIndex()
+{
+	stopJobs();
+}
+
+void FileIndex::setRoots(QStringList roots)
+{
+	for (auto& root : roots)
+	{
+		root = normalizedPath(root);
+	}
+
+	roots.removeDuplicates();
+	roots.sort();
+	if (roots == m_roots) { return; }
+
+	stopJobs();
+	m_rescanTimer.stop();
+	m_saveTimer.stop();
+	m_pendingDirs.clear();
+	if (!m_watcher.directories().isEmpty()) { m_watcher.removePaths(m_watcher.directories()); }
+
+	{
+		const auto lock = std::unique_lock{m_dataMutex};
+		m_entries.clear();
+		m_idByPath.clear();
+		m_childrenByDir.clear();
+		m_postings.clear();
+		m_numRemoved = 0;
+		m_readyRoots.clear();
+	}
+
+	m_roots = std::move(roots);
+	if (m_roots.isEmpty()) { return; }
+
+	enqueue([this] {
+		auto dirs = QStringList{};
+		if (load())
+		{
+			{
+				const auto lock = std::unique_lock{m_dataMutex};
+				for (const auto& root : m_roots)
+				{
+					m_readyRoots.insert(root);
+				}
+			}
+
+			// The persisted index is usable right away, and only the directories that changed since it
+			// was saved need to be listed again
+			for (const auto& root : m_roots)
+			{
+				verifyRoot(root);
+			}
+
+			for (const auto& entry : m_entries)
+			{
+				if (entry.isDir && !entry.removed) { dirs.push_back(entry.path); }
+			}
+		}
+		else
+		{
+			for (const auto& root : m_roots)
+			{
+				dirs += scanRoot(root);
+			}
+		}
+
+		if (m_stop.test(std::memory_order_relaxed)) { return; }
+		QMetaObject::invokeMethod(this, [this, dirs] { watchDirectories(dirs); }, Qt::QueuedConnection);
+
+		probeAudio();
+		compact();
+		save();
+	});
+}
+
+auto FileIndex::isReady(const QString& root) const -> bool
+{
+	const auto lock = std::shared_lock{m_dataMutex};
+	return m_readyRoots.contains(normalizedPath(root));
+}
+
+void FileIndex::query(
+	const Query& query, const std::function<void(const Entry&)>& onMatch, const std::atomic_flag& stop) const
+{
+	auto tokens = QStringList{};
+	for (const auto& token : query.tokens)
+	{
+		tokens.push_back(token.toCaseFolded());
+	}
+
+	const auto root = normalizedPath(query.root);
+	const auto prefix = root.endsWith('/') ? root : root + '/';
+
+	const auto matches = [&](const Entry& entry) {
+		if (entry.removed || !entry.path.startsWith(prefix)) { return false; }
+		if (entry.isHidden && !query.includeHidden) { return false; }
+
+		const auto containsTokens = std::all_of(tokens.begin(), tokens.end(),
+			[&](const auto& token) { return entry.foldedName.contains(token); });
+		if (!containsTokens) { return false; }
+
+		if (entry.isDir) { return true; }
+
+		const auto name = fileName(entry.path);
+		const auto dot = name.indexOf('.');
+		const auto suffix = dot < 0 ? QString{} : name.mid(dot + 1);
+		return query.extensions.contains(QString{"*.%1"}.arg(suffix), Qt::CaseInsensitive);
+	};
+
+	const auto lock = std::shared_lock{m_dataMutex};
+
+	// Every trigram of every token has to occur in a matching name, so only the entries that are present
+	// in all of their posting lists need to be checked
+	auto postings = std::vector<const std::vector<EntryId>*>{};
+	for (const auto& token : tokens)
+	{
+		for (const auto trigram : trigrams(token))
+		{
+			const auto it = m_postings.find(trigram);
+			if (it == m_postings.end()) { return; }
+			postings.push_back(&it->second);
+		}
+	}
+
+	if (postings.empty())
+	{
+		// All tokens are too short to be looked up, so fall back to checking every entry
+		for (const auto& entry : m_entries)
+		{
+			if (stop.test(std::memory_order_relaxed)) { return; }
+			if (matches(entry)) { onMatch(entry); }
+		}
+		return;
+	}
+
+	std::sort(postings.begin(), postings.end(), [](const auto a, const auto b) { return a->size() < b->size(); });
+
+	for (const auto id : *postings.front())
+	{
+		if (stop.test(std::memory_order_relaxed)) { return; }
+
+		const auto inAllPostings = std::all_of(postings.begin() + 1, postings.end(),
+			[id](const auto list) { return std::binary_search(list->begin(), list->end(), id); });
+
+		if (inAllPostings && matches(m_entries[id])) { onMatch(m_entries[id]); }
+	}
+}
+
+auto FileIndex::audioInfo(const QString& path) const -> std::optional<SampleDecoder::AudioInfo>
+{
+	const auto lock = std::shared_lock{m_dataMutex};
+
+	const auto id = m_idByPath.value(normalizedPath(path), InvalidEntryId);
+	if (id == InvalidEntryId) { return std::nullopt; }
+
+	const auto& entry = m_entries[id];
+	if (!entry.audioProbed || entry.audio.sampleRate == 0) { return std::nullopt; }
+	return entry.audio;
+}
+
+void FileIndex::enqueue(std::function<void()> fn)
+{
+	const auto lock = std::lock_guard{m_jobMutex};
+	m_jobQueue.push_back(std::move(fn));
+
+	if (m_workerActive) { return; }
+	m_workerActive = true;
+
+	// The previous worker already left runJobs() and is about to finish
+	if (m_worker) { m_worker->wait(); }
+
+	// Indexing can take minutes, so it runs on its own thread instead of the thread pool, where it would delay
+	// loading projects and samples. It only needs the CPU time that is left.
+	m_worker.reset(QThread::create([this] { runJobs(); }));
+	m_worker->start(QThread::IdlePriority);
+}
+
+void FileIndex::runJobs()
+{
+	while (true)
+	{
+		auto job = std::function<void()>{};
+		{
+			const auto lock = std::lock_guard{m_jobMutex};
+			if (m_jobQueue.empty() || m_stop.test(std::memory_order_relaxed))
+			{
+				m_workerActive = false;
+				return;
+			}
+
+			job = std::move(m_jobQueue.front());
+			m_jobQueue.pop_front();
+		}
+
+		job();
+	}
+}
+
+void FileIndex::stopJobs()
+{
+	m_stop.test_and_set(std::memory_order_acquire);
+
+	{
+		const auto lock = std::lock_guard{m_jobMutex};
+		m_jobQueue.clear();
+	}
+
+	if (m_worker) { m_worker->wait(); }
+	m_stop.clear(std::memory_order_release);
+}
+
+auto FileIndex::scanRoot(const QString& root) -> QStringList
+{
+	const auto info = QFileInfo{root};
+	if (!info.isDir()) { return {}; }
+
+	if (!m_idByPath.contains(root))
+	{
+		auto entry = makeEntry(info, false);
+		entry.isHidden = false;
+
+		const auto lock = std::unique_lock{m_dataMutex};
+		addEntry(std::move(entry));
+	}
+
+	auto dirs = scanDirectory(root, true);
+	dirs.push_front(root);
+
+	if (!m_stop.test(std::memory_order_relaxed))
+	{
+		const auto lock = std::unique_lock{m_dataMutex};
+		m_readyRoots.insert(root);
+	}
+
+	return dirs;
+}
+
+auto FileIndex::scanDirectory(const QString& dir, bool recursive) -> QStringList
+{
+	auto newDirs = QStringList{};
+	auto pending = QStringList{dir};
+	auto visited = QSet<QString>{};
+
+	while (!pending.isEmpty() && !m_stop.test(std::memory_order_relaxed))
+	{
+		const auto current = pending.takeLast();
+		const auto currentInfo = QFileInfo{current};
+		if (!currentInfo.isDir()) { continue; }
+
+		// Guard against symlink cycles
+		const auto canonicalPath = currentInfo.canonicalFilePath();
+		if (visited.contains(canonicalPath)) { continue; }
+		visited.insert(canonicalPath);
+
+		const auto listing
+			= QDir{current}.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+
+		const auto lock = std::unique_lock{m_dataMutex};
+
+		auto parentHidden = false;
+		const auto currentId = m_idByPath.value(current, InvalidEntryId);
+		if (currentId != InvalidEntryId)
+		{
+			m_entries[currentId].lastModified = currentInfo.lastModified().toMSecsSinceEpoch();
+			parentHidden = m_entries[currentId].isHidden;
+		}
+
+		auto listed = QSet<QString>{};
+		for (const auto& info : listing)
+		{
+			const auto path = info.filePath();
+			listed.insert(path);
+
+			auto id = m_idByPath.value(path, InvalidEntryId);
+			if (id != InvalidEntryId && m_entries[id].isDir != info.isDir())
+			{
+				removeEntry(id);
+				id = InvalidEntryId;
+			}
+
+			if (id == InvalidEntryId)
+			{
+				addEntry(makeEntry(info, parentHidden));
+				if (info.isDir())
+				{
+					pending.push_back(path);
+					newDirs.push_back(path);
+				}
+				continue;
+			}
+
+			auto& entry = m_entries[id];
+			if (entry.isDir)
+			{
+				// Modified subdirectories update their own time stamp once they are listed
+				if (recursive) { pending.push_back(path); }
+				continue;
+			}
+
+			const auto lastModified = info.lastModified().toMSecsSinceEpoch();
+			if (entry.lastModified != lastModified)
+			{
+				entry.lastModified = lastModified;
+				entry.audioProbed = false;
+				entry.audio = {};
+			}
+		}
+
+		const auto children = m_childrenByDir.value(current);
+		for (const auto id : children)
+		{
+			if (!listed.contains(m_entries[id].path)) { removeEntry(id); }
+		}
+	}
+
+	return newDirs;
+}
+
+auto FileIndex::verifyRoot(const QString& root) -> QStringList
+{
+	const auto prefix = root + '/';
+
+	auto changedDirs = QStringList{};
+	for (const auto& entry : m_entries)
+	{
+		if (m_stop.test(std::memory_order_relaxed)) { return {}; }
+		if (entry.removed || !entry.isDir) { continue; }
+		if (entry.path != root && !entry.path.startsWith(prefix)) { continue; }
+
+		const auto lastModified = QFileInfo{entry.path}.lastModified().toMSecsSinceEpoch();
+		if (entry.lastModified != lastModified) { changedDirs.push_back(entry.path); }
+	}
+
+	auto newDirs = QStringList{};
+	for (const auto& dir : changedDirs)
+	{
+		newDirs += scanDirectory(dir, false);
+	}
+
+	return newDirs;
+}
+
+void FileIndex::probeAudio()
+{
+	auto pending = std::vector<EntryId>{};
+	for (auto id = EntryId{0}; id < m_entries.size(); ++id)
+	{
+		const auto& entry = m_entries[id];
+		if (!entry.removed && !entry.isDir && !entry.audioProbed && isAudioFile(entry.path)) { pending.push_back(id); }
+	}
+
+	auto results = std::vector<SampleDecoder::AudioInfo>{};
+	for (auto batch = std::size_t{0}; batch < pending.size(); batch += AudioProbeBatchSize)
+	{
+		if (m_stop.test(std::memory_order_relaxed)) { return; }
+
+		const auto batchEnd = std::min(batch + AudioProbeBatchSize, pending.size());
+
+		results.clear();
+		for (auto i = batch; i < batchEnd; ++i)
+		{
+			results.push_back(SampleDecoder::probe(m_entries[pending[i]].path).value_or(SampleDecoder::AudioInfo{}));
+		}
+
+		const auto lock = std::unique_lock{m_dataMutex};
+		for (auto i = batch; i < batchEnd; ++i)
+		{
+			auto& entry = m_entries[pending[i]];
+			entry.audio = results[i - batch];
+			entry.audioProbed = true;
+		}
+	}
+}
+
+void FileIndex::compact()
+{
+	if (m_numRemoved * 2 < m_entries.size()) { return; }
+
+	const auto lock = std::unique_lock{m_dataMutex};
+
+	auto entries = std::move(m_entries);
+	m_entries.clear();
+	m_idByPath.clear();
+	m_childrenByDir.clear();
+	m_postings.clear();
+	m_numRemoved = 0;
+
+	for (auto& entry : entries)
+	{
+		if (!entry.removed) { addEntry(std::move(entry)); }
+	}
+}
+
+void FileIndex::addEntry(Entry entry)
+{
+	const auto id = static_cast<EntryId>(m_entries.size());
+
+	// Ids are handed out in increasing order, which keeps every posting list sorted
+	for (const auto trigram : trigrams(entry.foldedName))
+	{
+		m_postings[trigram].push_back(id);
+	}
+
+	m_idByPath.insert(entry.path, id);
+	m_childrenByDir[parentPath(entry.path)].push_back(id);
+	m_entries.push_back(std::move(entry));
+}
+
+void FileIndex::removeEntry(EntryId id)
+{
+	auto& entry = m_entries[id];
+	if (entry.removed) { return; }
+
+	entry.removed = true;
+	++m_numRemoved;
+	m_idByPath.remove(entry.path);
+
+	const auto siblings = m_childrenByDir.find(parentPath(entry.path));
+	if (siblings != m_childrenByDir.end())
+	{
+		siblings->erase(std::remove(siblings->begin(), siblings->end(), id), siblings->end());
+	}
+
+	if (entry.isDir)
+	{
+		const auto children = m_childrenByDir.take(entry.path);
+		for (const auto child : children)
+		{
+			removeEntry(child);
+		}
+	}
+}
+
+void FileIndex::watchDirectories(const QStringList& dirs)
+{
+	// Directories that are not watched (e.g. due to the inotify watch limit) are still picked up
+	// by the incremental scan the next time the index is loaded
+	const auto available = MaxWatchedDirectories - m_watcher.directories().size();
+	if (dirs.isEmpty() || available <= 0) { return; }
+
+	m_watcher.addPaths(dirs.mid(0, available));
+}
+
+void FileIndex::onDirectoryChanged(const QString& dir)
+{
+	m_pendingDirs.insert(dir);
+	m_rescanTimer.start();
+}
+
+void FileIndex::rescanPendingDirectories()
+{
+	const auto dirs = m_pendingDirs.values();
+	m_pendingDirs.clear();
+
+	enqueue([this, dirs] {
+		auto newDirs = QStringList{};
+		for (const auto& dir : dirs)
+		{
+			newDirs += scanDirectory(dir, false);
+		}
+
+		if (m_stop.test(std::memory_order_relaxed)) { return; }
+		QMetaObject::invokeMethod(this, [this, newDirs] { watchDirectories(newDirs); }, Qt::QueuedConnection);
+
+		probeAudio();
+		compact();
+
+		// Not saved right away, as directories with files being written to keep changing. If the index is not
+		// saved at all, the changed directories are listed again when it is loaded the next time.
+		QMetaObject::invokeMethod(this, &FileIndex::scheduleSave, Qt::QueuedConnection);
+	});
+}
+
+void FileIndex::scheduleSave()
+{
+	m_saveTimer.start();
+}
+
+auto FileIndex::cacheFile() const -> QString
+{
+	const auto key = QCryptographicHash::hash(m_roots.join('*').toUtf8(), QCryptographicHash::Sha1).toHex();
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/fileindex/" + key + ".idx";
+}
+
+auto FileIndex::load() -> bool
+{
+	auto file = QFile{cacheFile()};
+	if (!file.open(QIODevice::ReadOnly)) { return false; }
+
+	auto stream = QDataStream{&file};
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	auto magic = quint32{};
+	auto version = quint32{};
+	auto roots = QStringList{};
+	auto numEntries = quint64{};
+	stream >> magic >> version >> roots >> numEntries;
+	if (stream.status() != QDataStream::Ok || magic != CacheMagic || version != CacheVersion || roots != m_roots)
+	{
+		return false;
+	}
+
+	auto entries = std::vector<Entry>{};
+	entries.reserve(numEntries);
+
+	for (auto i = quint64{0}; i < numEntries && stream.status() == QDataStream::Ok; ++i)
+	{
+		auto entry = Entry{};
+		auto frames = qint64{};
+		auto sampleRate = qint32{};
+		auto channels = qint32{};
+		stream >> entry.path >> entry.lastModified >> entry.isDir >> entry.isHidden >> entry.audioProbed >> frames
+			>> sampleRate >> channels;
+
+		entry.foldedName = fileName(entry.path).toCaseFolded();
+		entry.audio = SampleDecoder::AudioInfo{frames, sampleRate, channels};
+		entries.push_back(std::move(entry));
+	}
+
+	if (stream.status() != QDataStream::Ok) { return false; }
+
+	const auto lock = std::unique_lock{m_dataMutex};
+	for (auto& entry : entries)
+	{
+		addEntry(std::move(entry));
+	}
+
+	return true;
+}
+
+void FileIndex::save() const
+{
+	if (m_stop.test(std::memory_order_relaxed)) { return; }
+
+	const auto path = cacheFile();
+	if (!QDir{}.mkpath(QFileInfo{path}.path())) { return; }
+
+	auto file = QSaveFile{path};
+	if (!file.open(QIODevice::WriteOnly)) { return; }
+
+	auto stream = QDataStream{&file};
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << CacheMagic << CacheVersion << m_roots << static_cast<quint64>(m_entries.size() - m_numRemoved);
+
+	for (const auto& entry : m_entries)
+	{
+		if (entry.removed) { continue; }
+		stream << entry.path << entry.lastModified << entry.isDir << entry.isHidden << entry.audioProbed
+			<< static_cast<qint64>(entry.audio.frames) << static_cast<qint32>(entry.audio.sampleRate)
+			<< static_cast<qint32>(entry.audio.channels);
+	}
+
+	file.commit();
+}
+
+auto FileIndex::trigrams(const QString& foldedText) -> std::vector<Trigram>
+{
+	auto result = std::vector<Trigram>{};
+	for (auto i = 0; i + 2 < foldedText.size(); ++i)
+	{
+		result.push_back(Trigram{foldedText[i].unicode()} << 32 | Trigram{foldedText[i + 1].unicode()} << 16
+			| Trigram{foldedText[i + 2].unicode()});
+	}
+
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+auto FileIndex::isAudioFile(const QString& path) -> bool
+{
+	static const auto s_extensions = [] {
+		auto extensions = QSet<QString>{};
+		for (const auto& type : SampleDecoder::supportedAudioTypes())
+		{
+			// DrumSynth files are synthesized on load and have no header to probe
+			if (type.extension != "ds") { extensions.insert(QString::fromStdString(type.extension).toLower()); }
+		}
+		return extensions;
+	}();
+
+	const auto dot = path.lastIndexOf('.');
+	return dot >= 0 && s_extensions.contains(path.mid(dot + 1).toLower());
+}
+
+} // namespace lmms::gui
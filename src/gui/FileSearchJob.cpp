@@ -27,6 +27,7 @@
 #include <QDirIterator>
 #include <QRegularExpression>
 
+#include "FileIndex.h"
 #include "ThreadPool.h"
 
 namespace lmms::gui {
@@ -79,6 +80,18 @@ void FileSearchJob::runSearch(Task task)
 
 	for (const auto& path : task.paths)
 	{
+		if (task.index && task.index->isReady(path))
+		{
+			const auto query = FileIndex::Query{.tokens = tokens,
+				.root = path,
+				.extensions = task.extensions,
+				.includeHidden = task.dirFilters.testFlag(QDir::Hidden)};
+
+			task.index->query(
+				query, [this](const FileIndex::Entry& entry) { emit foundMatch(entry.path); }, m_stop);
+			continue;
+		}
+
 		auto dirIt = QDirIterator{path, task.dirFilters,
 			QDirIterator::IteratorFlag::Subdirectories | QDirIterator::IteratorFlag::FollowSymlinks};
 
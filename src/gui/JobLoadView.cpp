@@ -0,0 +1,99 @@
+/*
+ * JobLoadView.cpp - Window listing the processing time of the audio engine jobs
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "JobLoadView.h"
+
+#include <QHeaderView>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "JobProfiler.h"
+
+namespace lmms::gui
+{
+
+JobLoadView::JobLoadView(QWidget* parent)
+	: QWidget(parent, Qt::Tool)
+	, m_table(new QTableWidget(this))
+{
+	setWindowTitle(tr("DSP load per job"));
+	resize(560, 400);
+
+	m_table->setColumnCount(5);
+	m_table->setHorizontalHeaderLabels(
+		{tr("Name"), tr("Type"), tr("Mean (µs)"), tr("99th percentile (µs)"), tr("Max (µs)")});
+	m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+	m_table->verticalHeader()->hide();
+	m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	m_table->setSelectionMode(QAbstractItemView::NoSelection);
+
+	auto layout = new QVBoxLayout(this);
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->addWidget(m_table);
+
+	connect(&m_updateTimer, &QTimer::timeout, this, &JobLoadView::updateStats);
+}
+
+void JobLoadView::showEvent(QShowEvent* event)
+{
+	JobProfiler::instance().setEnabled(true);
+	m_updateTimer.start(500);
+	QWidget::showEvent(event);
+}
+
+void JobLoadView::hideEvent(QHideEvent* event)
+{
+	m_updateTimer.stop();
+	JobProfiler::instance().setEnabled(false);
+	QWidget::hideEvent(event);
+}
+
+void JobLoadView::updateStats()
+{
+	const auto stats = JobProfiler::instance().stats();
+
+	m_table->setRowCount(static_cast<int>(stats.size()));
+	for (auto row = 0; row < static_cast<int>(stats.size()); ++row)
+	{
+		const auto& jobStats = stats[row];
+		const auto setItem = [&](int column, const QString& text) {
+			auto item = m_table->item(row, column);
+			if (!item)
+			{
+				item = new QTableWidgetItem;
+				if (column > 1) { item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter); }
+				m_table->setItem(row, column, item);
+			}
+			item->setText(text);
+		};
+
+		setItem(0, jobStats.name);
+		setItem(1, JobProfiler::typeName(jobStats.type));
+		setItem(2, QString::number(jobStats.meanTime, 'f', 1));
+		setItem(3, QString::number(jobStats.p99Time));
+		setItem(4, QString::number(jobStats.maxTime));
+	}
+}
+
+} // namespace lmms::gui
@@ -150,8 +150,9 @@ ClipView::~ClipView()
 	// we have to give our track-container the focus because otherwise the
 	// op-buttons of our track-widgets could become focus and when the user
 	// presses space for playing song, just one of these buttons is pressed
-	// which results in unwanted effects
-	m_trackView->trackContainerView()->setFocus();
+	// which results in unwanted effects. Views of clips that were scrolled
+	// out of view are deleted as well, which must not steal the focus.
+	if (hasFocus()) { m_trackView->trackContainerView()->setFocus(); }
 }
 
 
@@ -28,12 +28,15 @@
 #include <QMenu>
 #include <QPainter>
 
+#include "AudioEngine.h"
 #include "FileDialog.h"
 #include "GuiApplication.h"
 #include "AutomationEditor.h"
 #include "embed.h"
+#include "MainWindow.h"
 #include "PathUtil.h"
 #include "SampleClip.h"
+#include "SampleRecorder.h"
 #include "SampleThumbnail.h"
 #include "Song.h"
 #include "StringPairDrag.h"
@@ -58,6 +61,11 @@ SampleClipView::SampleClipView( SampleClip * _clip, TrackView * _tv ) :
 
 	connect(m_clip, SIGNAL(wasReversed()), this, SLOT(update()));
 
+	// show the take growing while it is recorded
+	connect(getGUI()->mainWindow(), &MainWindow::periodicUpdate, this, [this] {
+		if (Engine::audioEngine()->sampleRecorder().isRecording(m_clip->id())) { update(); }
+	});
+
 	setStyle( QApplication::style() );
 }
 
@@ -286,7 +294,27 @@ void SampleClipView::paintEvent( QPaintEvent * pe )
 
 	const auto sampleRextX = static_cast<int>(offsetStart) - m_paintPixmapXPosition;
 
-	if (sample.sampleSize() > 0)
+	const auto& recorder = Engine::audioEngine()->sampleRecorder();
+	if (recorder.isRecording(m_clip->id()))
+	{
+		// Draw what was recorded so far, one peak per pixel
+		const auto framesPerPixel = Engine::framesPerTick(Engine::audioEngine()->inputSampleRate()) * ticksPerBar / ppb;
+		const auto mergedPeaks = std::max(static_cast<f_cnt_t>(framesPerPixel / SampleRecorder::PeakFrames), f_cnt_t{1});
+		const auto framesPerPeak = mergedPeaks * SampleRecorder::PeakFrames;
+		const auto peaks = recorder.peaks(m_clip->id(), framesPerPeak);
+
+		const float centerY = (spacing + height()) / 2.f;
+		const float halfHeight = (height() - spacing) / 2.f;
+		for (std::size_t i = 0; i < peaks.size(); ++i)
+		{
+			const float x = sampleRextX + i * framesPerPeak / framesPerPixel;
+			if (x < 0) { continue; }
+			if (x > viewPortRect.right()) { break; }
+			p.drawLine(QPointF(x, centerY - peaks[i].max * halfHeight),
+				QPointF(x, centerY - peaks[i].min * halfHeight));
+		}
+	}
+	else if (sample.sampleSize() > 0)
 	{
 		const auto param = SampleThumbnail::VisualizeParameters{
 			.sampleRect = QRect(sampleRextX, spacing, sampleLength, height() - spacing),
@@ -164,6 +164,7 @@ PianoRoll::PianoRoll() :
 	m_currentPosition(),
 	m_recording( false ),
 	m_doAutoQuantization(ConfigManager::inst()->value("midi", "autoquantize").toInt() != 0),
+	m_drawNoteNames(ConfigManager::inst()->value("ui", "printnotelabels").toInt() != 0),
 	m_currentNote( nullptr ),
 	m_action( Action::None ),
 	m_noteEditMode( NoteEditMode::Volume ),
@@ -251,11 +252,15 @@ PianoRoll::PianoRoll() :
 	connect(ConfigManager::inst(), &ConfigManager::valueChanged,
 		[this](QString const& cls, QString const& attribute, QString const& value)
 		{
-			if (!(cls == "midi" && attribute == "autoquantize"))
+			if (cls == "midi" && attribute == "autoquantize")
 			{
-				return;
+				this->m_doAutoQuantization = (value.toInt() != 0);
+			}
+			else if (cls == "ui" && attribute == "printnotelabels")
+			{
+				this->m_drawNoteNames = (value.toInt() != 0);
+				update();
 			}
-			this->m_doAutoQuantization = (value.toInt() != 0);
 		});
 
 	markScaleAction->setEnabled( false );
@@ -752,6 +757,7 @@ void PianoRoll::fitNoteLengths(bool fill)
 		}
 	}
 
+	m_midiClip->dataChanged();
 	update();
 	getGUI()->songEditor()->update();
 	Engine::getSong()->setModified();
@@ -775,6 +781,7 @@ void PianoRoll::constrainNoteLengths(bool constrainMax)
 		}
 	}
 
+	m_midiClip->dataChanged();
 	update();
 	getGUI()->songEditor()->update();
 	Engine::getSong()->setModified();
@@ -2300,14 +2307,14 @@ void PianoRoll::computeSelectedNotes(bool shift)
 	//int y_base = noteEditTop() - 1;
 	if( hasValidMidiClip() )
 	{
-		for( Note *note : m_midiClip->notes() )
+		// make a new selection unless they're holding shift
+		if( ! shift )
 		{
-			// make a new selection unless they're holding shift
-			if( ! shift )
-			{
-				note->setSelected( false );
-			}
+			for (Note* note : m_midiClip->notes()) { note->setSelected(false); }
+		}
 
+		for (Note* note : m_midiClip->noteIndex().notesInRange(sel_pos_start, sel_pos_end))
+		{
 			int len_ticks = note->length();
 
 			if( len_ticks == 0 )
@@ -2671,34 +2678,12 @@ void PianoRoll::mouseMoveEvent( QMouseEvent * me )
 			int pos_ticks = ( x * TimePos::ticksPerBar() ) /
 						m_ppb + m_currentPosition;
 
-			// get note-vector of current MIDI clip
-			const NoteVector & notes = m_midiClip->notes();
-
-			// will be our iterator in the following loop
-			auto it = notes.rbegin();
-
-			// loop through whole note-vector...
-			while (it != notes.rend())
+			// check whether the cursor is over an existing note,
+			// preferring the one that starts last
+			const auto notes = m_midiClip->noteIndex().notesAt(pos_ticks, key_num);
+			if (!notes.empty())
 			{
-				Note *note = *it;
-				// and check whether the cursor is over an
-				// existing note
-				if( pos_ticks >= note->pos() &&
-			    		pos_ticks <= note->pos() +
-							note->length() &&
-					note->key() == key_num &&
-					note->length() > 0 )
-				{
-					break;
-				}
-				++it;
-			}
-
-			// did it reach end of vector because there's
-			// no note??
-			if (it != notes.rend())
-			{
-				Note *note = *it;
+				Note *note = notes.back();
 				// x coordinate of the right edge of the note
 				int noteRightX = ( note->pos() + note->length() -
 					m_currentPosition) * m_ppb/TimePos::ticksPerBar();
@@ -3278,7 +3263,7 @@ void PianoRoll::dragNotes(int x, int y, bool alt, bool shift, bool ctrl)
 
 void PianoRoll::paintEvent(QPaintEvent * pe )
 {
-	bool drawNoteNames = ConfigManager::inst()->value( "ui", "printnotelabels").toInt();
+	const bool drawNoteNames = m_drawNoteNames;
 
 	QStyleOption opt;
 	opt.initFrom( this );
@@ -3730,7 +3715,12 @@ void PianoRoll::paintEvent(QPaintEvent * pe )
 		}
 		// -- End ghost MIDI clip
 
-		for( const Note *note : m_midiClip->notes() )
+		// Only look at the notes in the visible range, widened by a pixel on either side for rounding
+		const int ticksPerPixel = TimePos::ticksPerBar() / m_ppb + 1;
+		const auto visibleNotes = m_midiClip->noteIndex().notesInRange(
+			m_currentPosition - ticksPerPixel,
+			m_currentPosition + (width() - m_whiteKeyWidth + 1) * TimePos::ticksPerBar() / m_ppb + ticksPerPixel);
+		for (const Note* note : visibleNotes)
 		{
 			int len_ticks = note->length();
 
@@ -5066,21 +5056,9 @@ Note * PianoRoll::noteUnderMouse()
 	int pos_ticks = (pos.x() - m_whiteKeyWidth) *
 			TimePos::ticksPerBar() / m_ppb + m_currentPosition;
 
-	// loop through whole note-vector...
-	for( Note* const& note : m_midiClip->notes() )
-	{
-		// and check whether the cursor is over an
-		// existing note
-		if( pos_ticks >= note->pos()
-				&& pos_ticks <= note->endPos()
-				&& note->key() == key_num
-				&& note->length() > 0 )
-		{
-			return note;
-		}
-	}
-
-	return nullptr;
+	// check whether the cursor is over an existing note
+	const auto notes = m_midiClip->noteIndex().notesAt(pos_ticks, key_num);
+	return notes.empty() ? nullptr : notes.front();
 }
 
 
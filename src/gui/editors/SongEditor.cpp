@@ -25,6 +25,7 @@
 #include "SongEditor.h"
 
 #include <cmath>
+#include <limits>
 
 #include <QAction>
 #include <QKeyEvent>
@@ -408,6 +409,15 @@ void SongEditor::updateRubberband()
 											  / pixelsPerBar() * TimePos::ticksPerBar())
 											  + m_currentPosition;
 
+		//clips off screen only have a view once they are selected
+		const TimePos selectionStart = qMin(m_rubberbandStartTimePos, rubberbandTimePos);
+		const TimePos selectionEnd = qMax(m_rubberbandStartTimePos, rubberbandTimePos);
+		for (int i = std::max(qMin(m_rubberBandStartTrackview, rubberBandTrackview), 0);
+			i <= qMax(m_rubberBandStartTrackview, rubberBandTrackview) && i < trackViews().size(); ++i)
+		{
+			trackViews()[i]->getTrackContentWidget()->createClipViews(selectionStart, selectionEnd);
+		}
+
 		//are clips in the rect of selection?
 		for (auto &it : findChildren<selectableObject *>())
 		{
@@ -869,6 +879,14 @@ void SongEditor::zoomingChanged()
 
 void SongEditor::selectAllClips( bool select )
 {
+	if (select)
+	{
+		// Clips off screen only have a view once they are selected
+		for (const auto& trackView : trackViews())
+		{
+			trackView->getTrackContentWidget()->createClipViews(0, std::numeric_limits<tick_t>::max());
+		}
+	}
 	QVector<selectableObject *> so = select ? rubberBand()->selectableObjects() : rubberBand()->selectedObjects();
 	for( int i = 0; i < so.count(); ++i )
 	{
@@ -145,6 +145,10 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 			"app", "nanhandler", "1").toInt()),
 	m_bufferSize(ConfigManager::inst()->value(
 			"audioengine", "framesperaudiobuffer").toInt()),
+	m_matchDevicePeriod(ConfigManager::inst()->value(
+			"audioengine", "matchdeviceperiod").toInt()),
+	m_resampleSamples(ConfigManager::inst()->value(
+			"audioengine", "resamplesamples").toInt()),
 	m_sampleRate(ConfigManager::inst()->value(
 			"audioengine", "samplerate").toInt()),
 	m_midiAutoQuantize(ConfigManager::inst()->value(
@@ -609,6 +613,9 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 	connect(sampleRateResetButton, &QPushButton::clicked, this,
 		[setSampleRate] { setSampleRate(SUPPORTED_SAMPLERATES.front()); });
 
+	addCheckBox(tr("Resample samples of other sample rates in the background"), sampleRateBox, sampleRateLayout,
+		m_resampleSamples, SLOT(toggleResampleSamples(bool)), true);
+
 	// Buffer size group
 	QGroupBox * bufferSizeBox = new QGroupBox(tr("Buffer size"), audio_w);
 	QVBoxLayout * bufferSizeLayout = new QVBoxLayout(bufferSizeBox);
@@ -646,6 +653,19 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 
 	setBufferSize(m_bufferSizeSlider->value());
 
+	addCheckBox(tr("Use the buffer size of the audio device if it has a fixed one (JACK)"), bufferSizeBox,
+		bufferSizeLayout, m_matchDevicePeriod, SLOT(toggleMatchDevicePeriod(bool)), true);
+
+	const auto latency = Engine::audioEngine()->latencyReport();
+	const auto ms = [&latency](f_cnt_t frames) { return QString::number(latency.milliseconds(frames), 'f', 1); };
+	auto latencyLbl = new QLabel(bufferSizeBox);
+	latencyLbl->setText(tr("Current round trip latency: %1 ms\n"
+		"Capture: %2 ms, input: %3 ms, period: %4 ms, rendered ahead: %5 ms, output: %6 ms, playback: %7 ms")
+		.arg(ms(latency.total()), ms(latency.capture), ms(latency.input), ms(latency.period), ms(latency.fifo),
+			ms(latency.output), ms(latency.playback)));
+	latencyLbl->setWordWrap(true);
+	bufferSizeLayout->addWidget(latencyLbl);
+
 
 	// Audio layout ordering.
 	audio_layout->addWidget(audioInterfaceBox);
@@ -1018,6 +1038,10 @@ void SetupDialog::accept()
 					QString::number(m_sampleRate));
 	ConfigManager::inst()->setValue("audioengine", "framesperaudiobuffer",
 					QString::number(m_bufferSize));
+	ConfigManager::inst()->setValue("audioengine", "matchdeviceperiod",
+					QString::number(m_matchDevicePeriod));
+	ConfigManager::inst()->setValue("audioengine", "resamplesamples",
+					QString::number(m_resampleSamples));
 	ConfigManager::inst()->setValue("audioengine", "mididev",
 					m_midiIfaceNames[m_midiInterfaces->currentText()]);
 	ConfigManager::inst()->setValue("midi", "midiautoassign",
@@ -1285,6 +1309,18 @@ void SetupDialog::resetBufferSize()
 }
 
 
+void SetupDialog::toggleMatchDevicePeriod(bool enabled)
+{
+	m_matchDevicePeriod = enabled;
+}
+
+
+void SetupDialog::toggleResampleSamples(bool enabled)
+{
+	m_resampleSamples = enabled;
+}
+
+
 // MIDI settings slots.
 
 void SetupDialog::midiInterfaceChanged(const QString & iface)
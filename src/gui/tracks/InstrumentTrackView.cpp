@@ -30,7 +30,9 @@
 #include <QHBoxLayout>
 #include <QMdiArea>
 #include <QMdiSubWindow>
+#include <QEventLoop>
 #include <QMenu>
+#include <QProgressDialog>
 #include <QSpacerItem>
 #include <QVBoxLayout>
 
@@ -49,6 +51,7 @@
 #include "Mixer.h"
 #include "MixerChannelLcdSpinBox.h"
 #include "MixerView.h"
+#include "TrackFreezer.h"
 #include "TrackLabelButton.h"
 
 
@@ -396,6 +399,29 @@ QMenu * InstrumentTrackView::createMixerMenu(QString title, QString newMixerLabe
 	return mixerMenu;
 }
 
+void InstrumentTrackView::toggleFreeze()
+{
+	auto track = model();
+	if (track->isFrozen())
+	{
+		track->unfreeze();
+		return;
+	}
+
+	auto freezer = TrackFreezer{track};
+	auto progress = QProgressDialog{tr("Freezing %1...").arg(track->name()), tr("Cancel"), 0, 100, this};
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setMinimumDuration(0);
+
+	auto loop = QEventLoop{};
+	connect(&freezer, &TrackFreezer::progressChanged, &progress, &QProgressDialog::setValue);
+	connect(&progress, &QProgressDialog::canceled, &freezer, &TrackFreezer::abortProcessing);
+	connect(&freezer, &QThread::finished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+
+	freezer.startProcessing();
+	loop.exec();
+}
+
 QPixmap InstrumentTrackView::determinePixmap(InstrumentTrack* instrumentTrack)
 {
 	if (instrumentTrack)
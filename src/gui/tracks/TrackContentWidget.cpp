@@ -24,6 +24,8 @@
 
 #include "TrackContentWidget.h"
 
+#include <algorithm>
+#include <utility>
 #include <QApplication>
 #include <QContextMenuEvent>
 #include <QMenu>
@@ -54,6 +56,16 @@ const int BARS_PER_GROUP = 4;
 	if there are less than 4 pixels between lines)*/
 const int MIN_PIXELS_BETWEEN_LINES = 4;
 
+//! Whether @p clip is at least partly within the ticks [begin, end]
+static bool isInView(const Clip* clip, int begin, int end)
+{
+	const int ts = clip->startPosition();
+	const int te = clip->endPosition()-3;
+	return ( ts >= begin && ts <= end ) ||
+		( te >= begin && te <= end ) ||
+		( ts <= begin && te >= end );
+}
+
 /*! \brief Create a new trackContentWidget
  *
  *  Creates a new track content widget for the given track.
@@ -91,6 +103,11 @@ TrackContentWidget::TrackContentWidget( TrackView * parent ) :
 	connect(getGUI()->songEditor()->m_editor, &SongEditor::proportionalSnapChanged,
 			this, &TrackContentWidget::updateBackground);
 
+	// Zooming out may reveal clips that have no view yet
+	connect(getGUI()->songEditor()->m_editor, &SongEditor::pixelsPerBarChanged, this, [this] {
+		if (virtualizesClips()) { changePosition(); }
+	});
+
 	setStyle( QApplication::style() );
 
 	updateBackground();
@@ -165,6 +182,41 @@ void TrackContentWidget::updateBackground()
 
 
 
+void TrackContentWidget::addClip(Clip* clip)
+{
+	// Keep the index up to date, also for clips that have no view
+	connect(clip, &Clip::positionChanged, this, [this, clip] { clipChanged(clip); });
+	connect(clip, &Clip::lengthChanged, this, [this, clip] { clipChanged(clip); });
+	connect(clip, &Clip::destroyedClip, this, [this] { m_clipIndexValid = false; });
+	m_clipIndexValid = false;
+
+	if (virtualizesClips() && !clip->getSelectViewOnCreate())
+	{
+		const TimePos pos = m_trackView->trackContainerView()->currentPosition();
+		if (!isInView(clip, pos, endPosition(pos))) { return; }
+	}
+
+	createClipView(clip);
+}
+
+
+
+
+void TrackContentWidget::createClipViews(const TimePos& first, const TimePos& last)
+{
+	if (!virtualizesClips()) { return; }
+
+	auto clips = std::vector<Clip*>{};
+	clipIndex().forEachInRange(first, last, [&](Clip* clip) {
+		if (!hasClipView(clip)) { clips.push_back(clip); }
+	});
+	// The index is not iterated while creating views, which may rebuild it
+	for (const auto& clip : clips) { createClipView(clip); }
+}
+
+
+
+
 /*! \brief Adds a ClipView to this widget.
  *
  *  Adds a(nother) ClipView to our list of views.  We also
@@ -178,6 +230,14 @@ void TrackContentWidget::addClipView( ClipView * clipv )
 
 	m_clipViews.push_back( clipv );
 
+	if (virtualizesClips())
+	{
+		// Only place the new view instead of going through all of them
+		const TimePos pos = m_trackView->trackContainerView()->currentPosition();
+		positionClipView(clipv, pos, endPosition(pos), m_trackView->trackContainerView()->pixelsPerBar());
+		return;
+	}
+
 	clip->saveJournallingState( false );
 	changePosition();
 	clip->restoreJournallingState();
@@ -256,6 +316,9 @@ void TrackContentWidget::changePosition( const TimePos & newPos )
 		return;
 	}
 
+	if (m_changingPosition) { return; }
+	m_changingPosition = true;
+
 	TimePos pos = newPos;
 	if( pos < 0 )
 	{
@@ -267,30 +330,31 @@ void TrackContentWidget::changePosition( const TimePos & newPos )
 	const float ppb = m_trackView->trackContainerView()->pixelsPerBar();
 
 	setUpdatesEnabled( false );
-	for (const auto& clipView : m_clipViews)
-	{
-		Clip* clip = clipView->getClip();
-
-		clip->changeLength( clip->length() );
 
-		const int ts = clip->startPosition();
-		const int te = clip->endPosition()-3;
-		if( ( ts >= begin && ts <= end ) ||
-			( te >= begin && te <= end ) ||
-			( ts <= begin && te >= end ) )
-		{
-			clipView->move(static_cast<int>((ts - begin) * ppb / TimePos::ticksPerBar()), clipView->y());
-			if (!clipView->isVisible())
-			{
-				clipView->show();
-			}
-		}
-		else
+	// Drop the views of clips that left the screen, unless the user works with them
+	for (auto it = m_clipViews.begin(); it != m_clipViews.end();)
+	{
+		ClipView* clipView = *it;
+		if (isInView(clipView->getClip(), begin, end)
+			|| clipView->isSelected() || clipView->isBeingEdited() || clipView->hasFocus())
 		{
-			clipView->move(-clipView->width() - 10, clipView->y());
+			++it;
+			continue;
 		}
+		it = m_clipViews.erase(it);
+		clipView->hide();
+		clipView->deleteLater();
+	}
+
+	// Create the views of clips that entered it
+	createClipViews(begin, end);
+
+	for (const auto& clipView : m_clipViews)
+	{
+		positionClipView(clipView, begin, end, ppb);
 	}
 	setUpdatesEnabled( true );
+	m_changingPosition = false;
 
 	// redraw background
 	updateBackground();
@@ -300,6 +364,84 @@ void TrackContentWidget::changePosition( const TimePos & newPos )
 
 
 
+bool TrackContentWidget::virtualizesClips() const
+{
+	// The pattern editor shows one clip per track at a time
+	return m_trackView->trackContainerView() == getGUI()->songEditor()->m_editor;
+}
+
+
+
+
+void TrackContentWidget::createClipView(Clip* clip)
+{
+	// New views place themselves, and going through all views now could drop this one before it is selected
+	const auto changingPosition = std::exchange(m_changingPosition, true);
+	ClipView* clipView = clip->createView(m_trackView);
+	m_changingPosition = changingPosition;
+
+	if (clip->getSelectViewOnCreate()) { clipView->setSelected(true); }
+	clip->selectViewOnCreate(false);
+}
+
+
+
+
+bool TrackContentWidget::hasClipView(const Clip* clip) const
+{
+	return std::any_of(m_clipViews.begin(), m_clipViews.end(),
+		[clip](ClipView* clipView) { return clipView->getClip() == clip; });
+}
+
+
+
+
+void TrackContentWidget::positionClipView(ClipView* clipView, int begin, int end, float ppb)
+{
+	if (isInView(clipView->getClip(), begin, end))
+	{
+		const int ts = clipView->getClip()->startPosition();
+		clipView->move(static_cast<int>((ts - begin) * ppb / TimePos::ticksPerBar()), clipView->y());
+		if (!clipView->isVisible())
+		{
+			clipView->show();
+		}
+	}
+	else
+	{
+		clipView->move(-clipView->width() - 10, clipView->y());
+	}
+}
+
+
+
+
+void TrackContentWidget::clipChanged(const Clip* clip)
+{
+	m_clipIndexValid = false;
+
+	// Views follow their clips themselves, but a clip without a view may have moved into the screen
+	if (virtualizesClips() && !hasClipView(clip)) { changePosition(); }
+}
+
+
+
+
+const IntervalIndex<Clip*>& TrackContentWidget::clipIndex()
+{
+	if (!m_clipIndexValid)
+	{
+		m_clipIndex.rebuild(getTrack()->getClips(), [](const Clip* clip) {
+			return std::pair{clip->startPosition().getTicks(), clip->endPosition().getTicks()};
+		});
+		m_clipIndexValid = true;
+	}
+	return m_clipIndex;
+}
+
+
+
+
 /*! \brief Return the position of the trackContentWidget in bars.
  *
  * \param mouseX the mouse's current X position in pixels.
@@ -648,8 +790,9 @@ void TrackContentWidget::paintEvent( QPaintEvent * pe )
  */
 void TrackContentWidget::resizeEvent( QResizeEvent * resizeEvent )
 {
-	// Update background
-	updateBackground();
+	// Clips may have become visible, which also updates the background
+	if (virtualizesClips()) { changePosition(); }
+	else { updateBackground(); }
 	// Force redraw
 	QWidget::resizeEvent( resizeEvent );
 }
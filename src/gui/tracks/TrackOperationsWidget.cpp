@@ -322,6 +322,8 @@ void TrackOperationsWidget::updateMenu()
 	{
 		toMenu->addSeparator();
 		toMenu->addMenu(trackView->midiMenu());
+		toMenu->addAction(trackView->model()->isFrozen() ? tr("Unfreeze") : tr("Freeze"),
+			trackView, SLOT(toggleFreeze()));
 	}
 	if( dynamic_cast<AutomationTrackView *>( m_trackView ) )
 	{
@@ -418,19 +418,15 @@ void TrackView::paintEvent( QPaintEvent * pe )
 
 
 
-/*! \brief Create a Clip View in this track View.
+/*! \brief Show a Clip in this track View.
  *
- *  \param clip the Clip to create the view for.
- *  \todo is this a good description for what this method does?
+ *  The view of the clip may only be created once it is scrolled into view.
+ *
+ *  \param clip the Clip to show.
  */
 void TrackView::createClipView( Clip * clip )
 {
-	ClipView * tv = clip->createView( this );
-	if( clip->getSelectViewOnCreate() == true )
-	{
-		tv->setSelected( true );
-	}
-	clip->selectViewOnCreate( false );
+	m_trackContentWidget.addClip(clip);
 }
 
 
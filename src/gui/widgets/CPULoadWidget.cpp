@@ -25,12 +25,14 @@
 
 
 #include <algorithm>
+#include <QMouseEvent>
 #include <QPainter>
 
 #include "AudioEngine.h"
 #include "CPULoadWidget.h"
 #include "embed.h"
 #include "Engine.h"
+#include "JobLoadView.h"
 
 
 namespace lmms::gui
@@ -88,6 +90,21 @@ void CPULoadWidget::paintEvent( QPaintEvent *  )
 
 
 
+void CPULoadWidget::mousePressEvent(QMouseEvent* event)
+{
+	if (event->button() != Qt::LeftButton)
+	{
+		QWidget::mousePressEvent(event);
+		return;
+	}
+
+	if (!m_jobLoadView) { m_jobLoadView = new JobLoadView(this); }
+	m_jobLoadView->setVisible(!m_jobLoadView->isVisible());
+}
+
+
+
+
 void CPULoadWidget::updateCpuLoad()
 {
 	// Additional display smoothing for the main load-value. Stronger averaging
@@ -103,7 +120,8 @@ void CPULoadWidget::updateCpuLoad()
 			+ tr(" - Notes and setup: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::NoteSetup)) + "\n"
 			+ tr(" - Instruments: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Instruments)) + "\n"
 			+ tr(" - Effects: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Effects)) + "\n"
-			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing))
+			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing)) + "\n"
+			+ tr("Click for the load of each track and effect")
 		);
 		m_currentLoad = new_load;
 		m_changed = true;
@@ -28,6 +28,8 @@
 #include "ConfigManager.h"
 #include "ControllerConnection.h"
 #include "DataFile.h"
+#include "EffectChain.h"
+#include "FrozenAudio.h"
 #include "GuiApplication.h"
 #include "Mixer.h"
 #include "InstrumentTrackView.h"
@@ -40,6 +42,7 @@
 #include "PatternTrack.h"
 #include "PianoRoll.h"
 #include "Pitch.h"
+#include "ProjectJournal.h"
 #include "Song.h"
 
 namespace lmms
@@ -81,6 +84,8 @@ InstrumentTrack::InstrumentTrack(TrackContainer* tc) :
 
 	m_mixerChannelModel.setRange( 0, Engine::mixer()->numChannels()-1, 1);
 
+	m_audioBusHandle.setExtOutputEnabled(true);
+
 	for( int i = 0; i < NumKeys; ++i )
 	{
 		m_notes[i] = nullptr;
@@ -389,8 +394,10 @@ void InstrumentTrack::processInEvent( const MidiEvent& event, const TimePos& tim
 
 		case MidiPitchBend:
 			// updatePitch() is connected to m_pitchModel::dataChanged() which will send out
-			// MidiPitchBend events
-			m_pitchModel.setValue( m_pitchModel.minValue() + event.pitchBend() * m_pitchModel.range() / MidiMaxPitchBend );
+			// MidiPitchBend events. Live input is played on the audio thread, so like automation, this must not
+			// add a journal checkpoint.
+			m_pitchModel.setValue(
+				m_pitchModel.minValue() + event.pitchBend() * m_pitchModel.range() / MidiMaxPitchBend, true);
 			break;
 
 		case MidiControlChange:
@@ -701,6 +708,9 @@ void InstrumentTrack::removeMidiPortNode( DataFile & _dataFile )
 bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 							const f_cnt_t _offset, int _clip_num )
 {
+	// The notes of a frozen track are part of its frozen audio
+	if (playsFrozen()) { return false; }
+
 	if( ! m_instrument || ! tryLock() )
 	{
 		return false;
@@ -1009,6 +1019,8 @@ void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement
 void InstrumentTrack::setPreviewMode( const bool value )
 {
 	m_previewMode = value;
+	// Previews of presets do not get their own outputs
+	m_audioBusHandle.setExtOutputEnabled(!m_previewMode);
 }
 
 
@@ -1107,4 +1119,109 @@ void InstrumentTrack::autoAssignMidiDevice(bool assign)
 }
 
 
+
+
+void InstrumentTrack::freeze(std::unique_ptr<FrozenAudio> audio)
+{
+	unfreeze();
+
+	Engine::audioEngine()->requestChangeInModel();
+	m_frozenAudio = std::move(audio);
+	m_audioBusHandle.setFrozenAudio(m_frozenAudio.get());
+	Engine::audioEngine()->doneChangeInModel();
+
+	connect(Engine::projectJournal(), &ProjectJournal::objectChanged,
+		this, &InstrumentTrack::checkFrozenAudio, Qt::DirectConnection);
+	connect(Engine::audioEngine(), &AudioEngine::sampleRateChanged, this, &InstrumentTrack::checkFrozenSampleRate);
+	connect(Engine::getSong(), &Song::timeSignatureChanged, this, &InstrumentTrack::unfreeze);
+
+	emit frozenChanged();
+}
+
+
+
+
+void InstrumentTrack::unfreeze()
+{
+	if (!m_frozenAudio) { return; }
+
+	disconnect(Engine::projectJournal(), &ProjectJournal::objectChanged, this, &InstrumentTrack::checkFrozenAudio);
+	disconnect(Engine::audioEngine(), &AudioEngine::sampleRateChanged, this, &InstrumentTrack::checkFrozenSampleRate);
+	disconnect(Engine::getSong(), &Song::timeSignatureChanged, this, &InstrumentTrack::unfreeze);
+
+	Engine::audioEngine()->requestChangeInModel();
+	m_audioBusHandle.setFrozenAudio(nullptr);
+	m_frozenAudio.reset();
+	Engine::audioEngine()->doneChangeInModel();
+
+	emit frozenChanged();
+}
+
+
+
+
+bool InstrumentTrack::playsFrozen() const
+{
+	return m_frozenAudio && FrozenAudio::isSongPlaying();
+}
+
+
+
+
+bool InstrumentTrack::frozenAudioDependsOn(JournallingObject* object)
+{
+	// Muting, soloing and routing the track happen after the frozen audio
+	if (object == &m_mutedModel || object == &m_soloModel || object == &m_mixerChannelModel) { return false; }
+
+	const auto inPatternStore = trackContainer() == Engine::patternStore();
+	const auto affects = [this, inPatternStore](const QObject* changed) {
+		// The tempo and master pitch are models of the song itself
+		if (changed->parent() == Engine::getSong() && dynamic_cast<const AutomatableModel*>(changed)) { return true; }
+
+		for (auto owner = changed; owner != nullptr; owner = owner->parent())
+		{
+			// The effects are not children of the track. Tracks in the pattern store are played by the pattern
+			// tracks of the song.
+			if (owner == this || owner == m_audioBusHandle.effects()) { return true; }
+			if (inPatternStore && dynamic_cast<const PatternTrack*>(owner)) { return true; }
+		}
+		return false;
+	};
+
+	const auto changed = dynamic_cast<QObject*>(object);
+	if (changed == nullptr) { return false; }
+	if (affects(changed)) { return true; }
+
+	if (const auto clip = dynamic_cast<AutomationClip*>(object))
+	{
+		for (const auto& model : clip->objects())
+		{
+			if (model && affects(model)) { return true; }
+		}
+	}
+	return false;
+}
+
+
+
+
+void InstrumentTrack::checkFrozenAudio(JournallingObject* object)
+{
+	// Changes may be made on any thread, so unfreeze from the event loop
+	if (frozenAudioDependsOn(object))
+	{
+		QMetaObject::invokeMethod(this, &InstrumentTrack::unfreeze, Qt::QueuedConnection);
+	}
+}
+
+
+
+
+void InstrumentTrack::checkFrozenSampleRate()
+{
+	// Freezing and exporting swap the audio device, which does not always change the sample rate
+	if (m_frozenAudio && m_frozenAudio->sampleRate() != Engine::audioEngine()->outputSampleRate()) { unfreeze(); }
+}
+
+
 } // namespace lmms
@@ -26,8 +26,12 @@
 #include "MidiClip.h"
 
 #include <algorithm>
+#include <iterator>
+#include <tuple>
 #include <QDomElement>
 
+#include "AutomationClip.h"
+#include "DetuningHelper.h"
 #include "GuiApplication.h"
 #include "InstrumentTrack.h"
 #include "MidiClipView.h"
@@ -114,6 +118,8 @@ void MidiClip::init()
 {
 	connect( Engine::getSong(), SIGNAL(timeSignatureChanged(int,int)),
 				this, SLOT(changeTimeSignature()));
+	// Every change of the notes is followed by this signal, including the piano roll moving them in place
+	connect(this, &MidiClip::dataChanged, this, [this] { m_noteIndexValid = false; });
 	saveJournallingState( false );
 
 	updateLength();
@@ -254,6 +260,19 @@ void MidiClip::rearrangeAllNotes()
 {
 	// sort notes by start time
 	std::sort(m_notes.begin(), m_notes.end(), Note::lessThan);
+	m_noteIndexValid = false;
+}
+
+
+
+const NoteIndex& MidiClip::noteIndex() const
+{
+	if (!m_noteIndexValid)
+	{
+		m_noteIndex.rebuild(m_notes);
+		m_noteIndexValid = true;
+	}
+	return m_noteIndex;
 }
 
 
@@ -532,6 +551,199 @@ void MidiClip::loadSettings( const QDomElement & _this )
 
 
 
+//! Records which notes a change added and removed, along with the properties of the clip before and after it.
+//! Until the entry is sealed, it keeps all notes from before the change instead.
+class MidiClip::DeltaJournalEntry : public JournalEntry
+{
+public:
+	explicit DeltaJournalEntry(const MidiClip& clip) :
+		m_before(Properties::of(clip)),
+		m_removed(copyNotes(clip))
+	{
+	}
+
+	void seal(JournallingObject& object) override
+	{
+		const auto& clip = static_cast<const MidiClip&>(object);
+		m_after = Properties::of(clip);
+
+		const auto before = std::move(m_removed);
+		const auto after = copyNotes(clip);
+		m_removed = {};
+		std::set_difference(before.begin(), before.end(), after.begin(), after.end(),
+			std::back_inserter(m_removed), lessThan);
+		std::set_difference(after.begin(), after.end(), before.begin(), before.end(),
+			std::back_inserter(m_added), lessThan);
+	}
+
+	void restore(JournallingObject& object) override
+	{
+		auto& clip = static_cast<MidiClip&>(object);
+
+		clip.instrumentTrack()->lock();
+
+		// Remove the notes the change added, each matching at most one note of the clip
+		auto matched = std::vector<bool>(m_added.size(), false);
+		const auto added = [&](const Note* note) {
+			const auto [first, last] = std::equal_range(m_added.begin(), m_added.end(), NoteCopy{*note}, lessThan);
+			for (auto it = first; it != last; ++it)
+			{
+				const auto index = it - m_added.begin();
+				if (!matched[index])
+				{
+					matched[index] = true;
+					return true;
+				}
+			}
+			return false;
+		};
+
+		auto notes = NoteVector{};
+		for (const auto& note : clip.m_notes)
+		{
+			if (added(note)) { delete note; }
+			else { notes.push_back(note); }
+		}
+		clip.m_notes = std::move(notes);
+
+		for (const auto& copy : m_removed)
+		{
+			clip.m_notes.push_back(copy.restore());
+		}
+		clip.rearrangeAllNotes();
+
+		clip.instrumentTrack()->unlock();
+
+		m_before.applyTo(clip);
+		emit clip.dataChanged();
+
+		std::swap(m_removed, m_added);
+		std::swap(m_before, m_after);
+	}
+
+	std::size_t memoryUsage() const override
+	{
+		return sizeof(*this) + (m_removed.capacity() + m_added.capacity()) * sizeof(NoteCopy)
+			+ (m_before.name.capacity() + m_after.name.capacity()) * sizeof(QChar);
+	}
+
+private:
+	struct Properties
+	{
+		QString name;
+		std::optional<QColor> color;
+		TimePos position;
+		TimePos length;
+		TimePos startTimeOffset;
+		bool muted = false;
+		bool autoResize = false;
+		int steps = 0;
+		Type type = Type::BeatClip;
+
+		static Properties of(const MidiClip& clip)
+		{
+			return {clip.name(), clip.color(), clip.startPosition(), clip.length(), clip.startTimeOffset(),
+				clip.isMuted(), clip.getAutoResize(), clip.m_steps, clip.m_clipType};
+		}
+
+		//! Same order as in loadSettings()
+		void applyTo(MidiClip& clip) const
+		{
+			clip.setName(name);
+			clip.setColor(color);
+			clip.movePosition(position);
+			if (clip.isMuted() != muted) { clip.toggleMute(); }
+			clip.m_steps = steps;
+			clip.m_clipType = type;
+			clip.changeLength(length);
+			clip.setAutoResize(autoResize);
+			clip.setStartTimeOffset(startTimeOffset);
+		}
+	};
+
+	//! A note along with a snapshot of its detuning. Copies of a note share its detuning, which is edited in place.
+	struct NoteCopy
+	{
+		explicit NoteCopy(const Note& note) :
+			note(note),
+			detuning(note.detuning()->automationClip()->getTimeMap()),
+			progression(note.detuning()->automationClip()->progressionType())
+		{
+			this->note.setSelected(false);
+		}
+
+		//! A new note in the state of the snapshot, with a detuning of its own
+		Note* restore() const
+		{
+			const auto restored = note.clone();
+			const auto clip = restored->detuning()->automationClip();
+			clip->getTimeMap() = detuning;
+			for (auto& node : clip->getTimeMap())
+			{
+				node.setClip(clip);
+			}
+			clip->setProgressionType(progression);
+			return restored;
+		}
+
+		Note note;
+		//! Implicitly shared with the detuning of the note until either is changed
+		AutomationClip::timeMap detuning;
+		AutomationClip::ProgressionType progression;
+	};
+
+	//! Orders notes by everything that is saved of them, so that the notes of two states can be compared
+	static bool lessThan(const NoteCopy& lhs, const NoteCopy& rhs)
+	{
+		const auto order = [](const NoteCopy& copy) {
+			const auto& note = copy.note;
+			return std::tuple{static_cast<int>(note.pos()), note.key(), static_cast<int>(note.length()),
+				note.getVolume(), note.getPanning(), note.type(), copy.progression};
+		};
+		if (order(lhs) != order(rhs)) { return order(lhs) < order(rhs); }
+
+		const auto node = [](AutomationClip::timeMap::const_iterator it) {
+			return std::tuple{it.key(), it->getInValue(), it->getOutValue(), it->getInTangent(), it->getOutTangent()};
+		};
+		auto left = lhs.detuning.cbegin();
+		auto right = rhs.detuning.cbegin();
+		for (; left != lhs.detuning.cend() && right != rhs.detuning.cend(); ++left, ++right)
+		{
+			if (node(left) != node(right)) { return node(left) < node(right); }
+		}
+		return left == lhs.detuning.cend() && right != rhs.detuning.cend();
+	}
+
+	static std::vector<NoteCopy> copyNotes(const MidiClip& clip)
+	{
+		auto notes = std::vector<NoteCopy>{};
+		notes.reserve(clip.m_notes.size());
+		for (const auto& note : clip.m_notes)
+		{
+			notes.emplace_back(*note);
+		}
+		std::sort(notes.begin(), notes.end(), lessThan);
+		return notes;
+	}
+
+	Properties m_before;
+	Properties m_after;
+	//! Notes of the state before the change that are not part of the state after it, and the other way round
+	std::vector<NoteCopy> m_removed;
+	std::vector<NoteCopy> m_added;
+};
+
+
+
+
+std::unique_ptr<JournalEntry> MidiClip::createJournalEntry()
+{
+	return std::make_unique<DeltaJournalEntry>(*this);
+}
+
+
+
+
 MidiClip *  MidiClip::previousMidiClip() const
 {
 	return adjacentMidiClipByOffset(-1);
@@ -57,6 +57,9 @@ SampleTrack::SampleTrack(TrackContainer* tc) :
 	m_mixerChannelModel.setRange(0, Engine::mixer()->numChannels()-1, 1);
 
 	connect(&m_mixerChannelModel, SIGNAL(dataChanged()), this, SLOT(updateMixerChannel()));
+	connect(this, &Track::nameChanged, this, [this] { m_audioBusHandle.setName(name()); });
+
+	m_audioBusHandle.setExtOutputEnabled(true);
 }
 
 
@@ -0,0 +1,150 @@
+/*
+ * AudioResamplerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AudioResampler.h"
+
+#include <QObject>
+#include <QtTest>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+using lmms::AudioResampler;
+using lmms::f_cnt_t;
+
+namespace
+{
+
+//! Stereo sine and cosine with @p frequency cycles per frame
+auto quadratureSine(f_cnt_t frames, double frequency) -> std::vector<float>
+{
+	auto result = std::vector<float>(frames * 2);
+	for (auto i = f_cnt_t{0}; i < frames; ++i)
+	{
+		const auto phase = 2 * std::numbers::pi * frequency * i;
+		result[i * 2] = static_cast<float>(std::sin(phase));
+		result[i * 2 + 1] = static_cast<float>(std::cos(phase));
+	}
+	return result;
+}
+
+//! Resample all of @p input in small, uneven pieces, the way Sample::play does
+auto resampleInPieces(AudioResampler& resampler, const std::vector<float>& input) -> std::vector<float>
+{
+	auto result = std::vector<float>{};
+	auto buffer = std::vector<float>(100 * 2);
+	auto position = f_cnt_t{0};
+	const auto frames = input.size() / 2;
+	while (true)
+	{
+		const auto available = std::min<f_cnt_t>(frames - position, 77);
+		const auto [used, generated]
+			= resampler.process({input.data() + position * 2, 2, available}, {buffer.data(), 2, 100});
+		if (used == 0 && generated == 0) { break; }
+
+		position += used;
+		result.insert(result.end(), buffer.begin(), buffer.begin() + generated * 2);
+	}
+	return result;
+}
+
+} // namespace
+
+class AudioResamplerTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void unityRatioReproducesInput()
+	{
+		const auto input = quadratureSine(1000, 0.01);
+		for (const auto mode : {AudioResampler::Mode::ZOH, AudioResampler::Mode::Linear, AudioResampler::Mode::Cubic,
+			AudioResampler::Mode::SincFastest})
+		{
+			auto resampler = AudioResampler{mode};
+			const auto output = resampleInPieces(resampler, input);
+
+			QVERIFY(output.size() > input.size() - 40);
+			for (auto i = std::size_t{0}; i < output.size(); ++i) { QCOMPARE(output[i], input[i]); }
+		}
+	}
+
+	void resampledSineStaysInTune()
+	{
+		constexpr auto Frequency = 0.01;
+		const auto input = quadratureSine(20000, Frequency);
+		for (const auto mode : {AudioResampler::Mode::Cubic, AudioResampler::Mode::SincFastest})
+		{
+			for (const auto ratio : {0.3, 0.84, 1.37, 2.0})
+			{
+				auto resampler = AudioResampler{mode};
+				resampler.setRatio(ratio);
+				const auto output = resampleInPieces(resampler, input);
+
+				const auto frames = output.size() / 2;
+				QVERIFY(std::abs(static_cast<double>(frames) - 20000 * ratio) < 40);
+
+				// Output frame i is at input frame i / ratio. Near the ends, the filters see the silence around
+				// the input.
+				for (auto i = std::size_t{64}; i + 64 < frames; ++i)
+				{
+					const auto phase = 2 * std::numbers::pi * Frequency * i / ratio;
+					QVERIFY(std::abs(output[i * 2] - std::sin(phase)) < 1e-3);
+					QVERIFY(std::abs(output[i * 2 + 1] - std::cos(phase)) < 1e-3);
+				}
+			}
+		}
+	}
+
+	void downsamplingFiltersAliases()
+	{
+		// Above the Nyquist frequency once downsampled by an octave
+		const auto input = quadratureSine(4000, 0.35);
+		auto resampler = AudioResampler{AudioResampler::Mode::SincFastest};
+		resampler.setRatio(0.5);
+		const auto output = resampleInPieces(resampler, input);
+
+		// Skip the start, where the filter sees the silence before the input
+		for (auto i = std::size_t{64}; i < output.size(); ++i) { QVERIFY(std::abs(output[i]) < 1e-3); }
+	}
+
+	void resetForgetsPreviousInput()
+	{
+		const auto first = quadratureSine(500, 0.02);
+		const auto second = quadratureSine(500, 0.03);
+
+		auto resampler = AudioResampler{AudioResampler::Mode::SincFastest};
+		resampler.setRatio(1.5);
+		resampleInPieces(resampler, first);
+		resampler.reset();
+		const auto afterReset = resampleInPieces(resampler, second);
+
+		auto fresh = AudioResampler{AudioResampler::Mode::SincFastest};
+		fresh.setRatio(1.5);
+		QCOMPARE(afterReset, resampleInPieces(fresh, second));
+	}
+};
+
+QTEST_GUILESS_MAIN(AudioResamplerTest)
+#include "AudioResamplerTest.moc"
@@ -0,0 +1,119 @@
+/*
+ * DataFileUpgradeTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#include "DataFile.h"
+#include "Note.h"
+
+#include <QDomDocument>
+#include <QObject>
+#include <QtTest>
+
+using lmms::DataFile;
+
+class DataFileUpgradeTest : public QObject
+{
+	Q_OBJECT
+
+private:
+	//! A song saved with the given file version, i.e. before the upgrade routine with that index
+	static QByteArray makeProject(int version)
+	{
+		return QString{R"(<?xml version="1.0"?>
+<lmms-project version="%1" type="song">
+	<head/>
+	<song>
+		<trackcontainer>
+			<track type="0" name="Synth">
+				<instrumenttrack fxch="2">
+					<instrument name="tripleoscillator"><tripleoscillator/></instrument>
+				</instrumenttrack>
+				<pattern pos="0" name="Synth"><note pos="0" len="-192" key="57"/></pattern>
+			</track>
+			<track type="1" name="Beat/Bassline 0">
+				<bbtrack><trackcontainer/></bbtrack>
+				<bbtco pos="0"/>
+			</track>
+			<track type="2" name="Sample">
+				<sampletrack fxch="1"/>
+				<sampletco pos="0" src="bassloops/briff01.ogg"/>
+			</track>
+		</trackcontainer>
+		<fxmixer><fxchannel num="0"/></fxmixer>
+		<controllers><Midicontroller inputcontroller="5"/></controllers>
+	</song>
+</lmms-project>
+)"}.arg(version).toUtf8();
+	}
+
+	static QDomElement element(const DataFile& file, const QString& tag)
+	{
+		return file.elementsByTagName(tag).item(0).toElement();
+	}
+
+private slots:
+	void elementUpgradesShareOnePass()
+	{
+		// Every upgrade from the triple oscillator one on only changes single elements
+		const auto file = DataFile{makeProject(20)};
+
+		QVERIFY(file.elementsByTagName("fxmixer").isEmpty());
+		QVERIFY(!element(file, "mixer").isNull());
+		QVERIFY(!element(file, "mixerchannel").isNull());
+		QCOMPARE(element(file, "instrumenttrack").attribute("mixch"), QString{"2"});
+		QVERIFY(!element(file, "instrumenttrack").hasAttribute("fxch"));
+		QCOMPARE(element(file, "tripleoscillator").attribute("useWaveTable1"), QString{"0"});
+
+		QVERIFY(!element(file, "patterntrack").isNull());
+		QVERIFY(!element(file, "patternclip").isNull());
+		QCOMPARE(file.elementsByTagName("track").item(1).toElement().attribute("name"), QString{"Pattern 0"});
+
+		// Notes are upgraded after their clips were renamed
+		QVERIFY(!element(file, "midiclip").isNull());
+		QCOMPARE(element(file, "note").attribute("len"), QString::number(lmms::DefaultTicksPerBar / 16));
+		QCOMPARE(element(file, "note").attribute("type"), QString::number(static_cast<int>(lmms::Note::Type::Step)));
+
+		// Renaming <sampletco> to <sampleclip> makes the later loop renaming apply to it
+		QCOMPARE(element(file, "sampleclip").attribute("src"), QString{"bassloops/briff01 - 140 BPM.ogg"});
+
+		QCOMPARE(element(file, "Midicontroller").attribute("inputcontroller"), QString{"4"});
+	}
+
+	void upgradesBeforeTheFileVersionAreSkipped()
+	{
+		// Saved after the MIDI controller upgrade, but before the loop renaming
+		auto project = QString{makeProject(25)};
+		project.replace("sampletco", "sampleclip");
+		const auto file = DataFile{project.toUtf8()};
+
+		QCOMPARE(element(file, "Midicontroller").attribute("inputcontroller"), QString{"5"});
+		QCOMPARE(element(file, "instrumenttrack").attribute("fxch"), QString{"2"});
+		QCOMPARE(element(file, "sampleclip").attribute("src"), QString{"bassloops/briff01 - 140 BPM.ogg"});
+		QCOMPARE(element(file, "note").attribute("type"), QString::number(static_cast<int>(lmms::Note::Type::Step)));
+	}
+};
+
+QTEST_GUILESS_MAIN(DataFileUpgradeTest)
+#include "DataFileUpgradeTest.moc"
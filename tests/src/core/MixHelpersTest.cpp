@@ -0,0 +1,70 @@
+/*
+ * MixHelpersTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include "MixHelpers.h"
+
+#include <QObject>
+#include <QtTest>
+#include <vector>
+
+#include "SampleFrame.h"
+
+using lmms::SampleFrame;
+using lmms::sample_t;
+
+class MixHelpersTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void deinterleaveAndInterleaveRoundTrip()
+	{
+		// Not a multiple of the vector width, so that the remainder is handled as well
+		constexpr auto Frames = 11;
+
+		auto frames = std::vector<SampleFrame>(Frames);
+		for (auto f = 0; f < Frames; ++f) { frames[f] = SampleFrame{1.f * f, -1.f * f}; }
+
+		auto left = std::vector<sample_t>(Frames);
+		auto right = std::vector<sample_t>(Frames);
+		lmms::MixHelpers::deinterleave(frames.data(), left.data(), right.data(), Frames);
+		for (auto f = 0; f < Frames; ++f)
+		{
+			QCOMPARE(left[f], 1.f * f);
+			QCOMPARE(right[f], -1.f * f);
+		}
+
+		auto result = std::vector<SampleFrame>(Frames);
+		lmms::MixHelpers::interleave(left.data(), right.data(), result.data(), Frames);
+		for (auto f = 0; f < Frames; ++f)
+		{
+			QCOMPARE(result[f][0], frames[f][0]);
+			QCOMPARE(result[f][1], frames[f][1]);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(MixHelpersTest)
+#include "MixHelpersTest.moc"
@@ -0,0 +1,115 @@
+/*
+ * NoteIndexTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <QtTest>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Engine.h"
+#include "Note.h"
+#include "NoteIndex.h"
+
+class NoteIndexTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void rangesMatchAllOverlappingNotes()
+	{
+		using namespace lmms;
+
+		// A long note at the start must not hide the short ones after it
+		auto notes = std::vector<std::unique_ptr<Note>>{};
+		notes.push_back(std::make_unique<Note>(TimePos{1000}, TimePos{0}, 60));
+		for (int i = 0; i < 100; ++i)
+		{
+			notes.push_back(std::make_unique<Note>(TimePos{10 + i % 7}, TimePos{(i * 37) % 900}, 40 + i % 12));
+		}
+		notes.push_back(std::make_unique<Note>(TimePos{-1}, TimePos{950}, 50));
+
+		auto noteVector = NoteVector{};
+		for (const auto& note : notes) { noteVector.push_back(note.get()); }
+
+		auto index = NoteIndex{};
+		index.rebuild(noteVector);
+
+		const auto ranges = {std::pair{0, 0}, std::pair{100, 200}, std::pair{953, 960}, std::pair{2000, 3000}};
+		for (const auto& [first, last] : ranges)
+		{
+			auto expected = NoteVector{};
+			for (const auto& note : noteVector)
+			{
+				const auto start = note->pos().getTicks();
+				const auto length = note->length().getTicks() < 0 ? 4 : note->length().getTicks();
+				if (start <= last && start + length >= first) { expected.push_back(note); }
+			}
+
+			auto found = index.notesInRange(first, last);
+			QCOMPARE(found.size(), expected.size());
+			QVERIFY(std::is_sorted(found.begin(), found.end(),
+				[](const Note* lhs, const Note* rhs) { return lhs->pos().getTicks() < rhs->pos().getTicks(); }));
+
+			std::sort(found.begin(), found.end());
+			std::sort(expected.begin(), expected.end());
+			QVERIFY(found == expected);
+		}
+	}
+
+	void pointsMatchNotesOnTheirKey()
+	{
+		using namespace lmms;
+
+		auto first = Note{TimePos{10}, TimePos{0}, 60};
+		auto second = Note{TimePos{10}, TimePos{5}, 60};
+		auto otherKey = Note{TimePos{10}, TimePos{0}, 61};
+		auto empty = Note{TimePos{0}, TimePos{5}, 60};
+
+		auto index = NoteIndex{};
+		index.rebuild({&second, &otherKey, &empty, &first});
+
+		QVERIFY(index.notesAt(7, 60) == (NoteVector{&first, &second}));
+		QVERIFY(index.notesAt(10, 60) == (NoteVector{&first, &second}));
+		QVERIFY(index.notesAt(11, 60) == (NoteVector{&second}));
+		QVERIFY(index.notesAt(16, 60).empty());
+		QVERIFY(index.notesAt(0, 62).empty());
+	}
+};
+
+QTEST_GUILESS_MAIN(NoteIndexTest)
+#include "NoteIndexTest.moc"
@@ -0,0 +1,143 @@
+/*
+ * ProjectContainerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include "ProjectContainer.h"
+
+#include <QDomDocument>
+#include <QObject>
+#include <QTemporaryFile>
+#include <QtTest>
+
+using lmms::ProjectContainer;
+
+class ProjectContainerTest : public QObject
+{
+	Q_OBJECT
+
+private:
+	static QDomDocument makeProject(const QByteArray& sample)
+	{
+		auto document = QDomDocument{"lmms-project"};
+		auto root = document.createElement("lmms-project");
+		root.setAttribute("type", "song");
+		document.appendChild(root);
+
+		auto song = document.createElement("song");
+		root.appendChild(song);
+		auto tracks = document.createElement("trackcontainer");
+		song.appendChild(tracks);
+
+		for (auto i = 0; i < 3; ++i)
+		{
+			auto track = document.createElement("track");
+			track.setAttribute("name", QString{"Track %1"}.arg(i));
+			tracks.appendChild(track);
+
+			auto clip = document.createElement("midiclip");
+			clip.setAttribute("pos", i * 192);
+			track.appendChild(clip);
+
+			auto note = document.createElement("note");
+			note.setAttribute("key", 57 + i);
+			clip.appendChild(note);
+		}
+
+		auto sampleTrack = document.createElement("track");
+		tracks.appendChild(sampleTrack);
+		auto sampleClip = document.createElement("sampleclip");
+		sampleClip.setAttribute("data", QString{sample.toBase64()});
+		sampleTrack.appendChild(sampleClip);
+
+		return document;
+	}
+
+	static QByteArray makeSample()
+	{
+		auto sample = QByteArray{};
+		for (auto i = 0; i < 4096; ++i) { sample.append(static_cast<char>(i * 7)); }
+		return sample;
+	}
+
+private slots:
+	void roundTripIsLossless()
+	{
+		const auto sample = makeSample();
+		const auto original = makeProject(sample);
+
+		auto file = QTemporaryFile{};
+		QVERIFY(file.open());
+		QVERIFY(ProjectContainer::write(original, file));
+		file.close();
+
+		auto device = QFile{file.fileName()};
+		QVERIFY(device.open(QIODevice::ReadOnly));
+		QVERIFY(ProjectContainer::isContainer(device));
+
+		auto container = ProjectContainer{file.fileName()};
+		QVERIFY(container.isValid());
+
+		auto loaded = QDomDocument{};
+		QVERIFY(container.read(loaded, nullptr));
+
+		ProjectContainer::expandBlobs(loaded);
+		QCOMPARE(loaded.toString(-1), original.toString(-1));
+	}
+
+	void samplesAreReadFromTheContainer()
+	{
+		const auto sample = makeSample();
+
+		auto file = QTemporaryFile{};
+		QVERIFY(file.open());
+		QVERIFY(ProjectContainer::write(makeProject(sample), file));
+		file.close();
+
+		auto reference = QString{};
+		{
+			auto container = ProjectContainer{file.fileName()};
+			auto loaded = QDomDocument{};
+			QVERIFY(container.read(loaded, nullptr));
+
+			reference = loaded.elementsByTagName("sampleclip").item(0).toElement().attribute("data");
+			QVERIFY(ProjectContainer::isBlobReference(reference));
+			QCOMPARE(ProjectContainer::blob(reference), sample);
+		}
+
+		// The reference is invalid once the container is gone
+		QVERIFY(ProjectContainer::blob(reference).isEmpty());
+	}
+
+	void xmlIsNotAContainer()
+	{
+		auto file = QTemporaryFile{};
+		QVERIFY(file.open());
+		file.write("<?xml version=\"1.0\"?><lmms-project/>");
+		file.seek(0);
+		QVERIFY(!ProjectContainer::isContainer(file));
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectContainerTest)
+#include "ProjectContainerTest.moc"
@@ -0,0 +1,156 @@
+/*
+ * ProjectJournalTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <QtTest>
+
+#include "AutomatableModel.h"
+#include "AutomationClip.h"
+#include "DetuningHelper.h"
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "ProjectJournal.h"
+#include "Song.h"
+
+class ProjectJournalTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void init()
+	{
+		using namespace lmms;
+		Engine::projectJournal()->clearJournal();
+		Engine::projectJournal()->setJournalling(true);
+	}
+
+	void cleanup()
+	{
+		using namespace lmms;
+		Engine::projectJournal()->setJournalling(false);
+		Engine::projectJournal()->clearJournal();
+	}
+
+	void modelValuesAreUndoneAndRedone()
+	{
+		using namespace lmms;
+		auto journal = Engine::projectJournal();
+
+		FloatModel model(0.f, 0.f, 10.f, 1.f);
+		model.setValue(3.f);
+		model.setValue(5.f);
+
+		journal->undo();
+		QCOMPARE(model.value(), 3.f);
+		journal->undo();
+		QCOMPARE(model.value(), 0.f);
+		QVERIFY(!journal->canUndo());
+
+		journal->redo();
+		QCOMPARE(model.value(), 3.f);
+		journal->redo();
+		QCOMPARE(model.value(), 5.f);
+
+		const auto statistics = journal->statistics();
+		QCOMPARE(statistics.checkPoints, std::size_t{2});
+		QCOMPARE(statistics.snapshots, std::size_t{0});
+	}
+
+	void noteChangesAreUndoneAndRedone()
+	{
+		using namespace lmms;
+		auto journal = Engine::projectJournal();
+
+		InstrumentTrack instrumentTrack(Engine::getSong());
+		MidiClip midiClip(&instrumentTrack);
+		midiClip.addNote(Note(TimePos(1, 0), TimePos(0, 0), 60), false);
+		midiClip.addNote(Note(TimePos(1, 0), TimePos(1, 0), 62), false);
+		journal->clearJournal();
+
+		// Move one note, remove another and add a third
+		midiClip.addJournalCheckPoint();
+		midiClip.notes()[0]->setKey(64);
+		midiClip.removeNote(midiClip.notes()[1]);
+		midiClip.addNote(Note(TimePos(2, 0), TimePos(2, 0), 67), false);
+		midiClip.setName("changed");
+
+		const auto keys = [&midiClip] {
+			auto result = std::vector<int>{};
+			for (const auto& note : midiClip.notes()) { result.push_back(note->key()); }
+			return result;
+		};
+
+		journal->undo();
+		QCOMPARE(keys(), (std::vector<int>{60, 62}));
+		QCOMPARE(midiClip.name(), QString{});
+
+		journal->redo();
+		QCOMPARE(keys(), (std::vector<int>{64, 67}));
+		QCOMPARE(midiClip.notes()[1]->length().getTicks(), TimePos(2, 0).getTicks());
+		QCOMPARE(midiClip.name(), QString{"changed"});
+
+		QCOMPARE(journal->statistics().snapshots, std::size_t{0});
+	}
+
+	void detuningChangesAreUndoneAndRedone()
+	{
+		using namespace lmms;
+		auto journal = Engine::projectJournal();
+
+		InstrumentTrack instrumentTrack(Engine::getSong());
+		MidiClip midiClip(&instrumentTrack);
+		midiClip.addNote(Note(TimePos(1, 0), TimePos(0, 0), 60), false);
+		journal->clearJournal();
+
+		// The detuning is edited in place, while the journal holds a copy of the note
+		midiClip.addJournalCheckPoint();
+		midiClip.notes()[0]->detuning()->automationClip()->putValue(TimePos(0, 96), 5.f);
+
+		const auto detuning = [&midiClip] {
+			return midiClip.notes()[0]->detuning()->automationClip()->getTimeMap().size();
+		};
+
+		journal->undo();
+		QCOMPARE(detuning(), 0);
+
+		journal->redo();
+		QCOMPARE(detuning(), 1);
+		QCOMPARE(midiClip.notes()[0]->detuning()->automationClip()->valueAt(TimePos(0, 96)), 5.f);
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectJournalTest)
+#include "ProjectJournalTest.moc"
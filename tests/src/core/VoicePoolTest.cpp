@@ -0,0 +1,107 @@
+/*
+ * VoicePoolTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "VoicePool.h"
+
+#include <QObject>
+#include <QtTest>
+#include <vector>
+
+using lmms::VoicePool;
+
+struct Voice
+{
+	Voice(int value, int* alive) : value{value}, alive{alive} { ++*alive; }
+	~Voice() { --*alive; }
+	int value;
+	int* alive;
+};
+
+class VoicePoolTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void acquireConstructsAndReleaseDestructs()
+	{
+		auto alive = 0;
+		auto pool = VoicePool<Voice>{4};
+
+		const auto voice = pool.acquire(42, &alive);
+		QCOMPARE(voice->value, 42);
+		QCOMPARE(alive, 1);
+
+		pool.release(voice);
+		QCOMPARE(alive, 0);
+
+		pool.release(nullptr);
+	}
+
+	void releasedStorageIsReused()
+	{
+		auto alive = 0;
+		auto pool = VoicePool<Voice>{1};
+
+		const auto first = pool.acquire(1, &alive);
+		pool.release(first);
+
+		const auto second = pool.acquire(2, &alive);
+		QCOMPARE(second, first);
+		pool.release(second);
+	}
+
+	void voicesBeyondCapacityComeFromTheHeap()
+	{
+		auto alive = 0;
+		auto pool = VoicePool<Voice>{2};
+
+		auto voices = std::vector<Voice*>{};
+		for (auto i = 0; i < 100; ++i) { voices.push_back(pool.acquire(i, &alive)); }
+		QCOMPARE(alive, 100);
+
+		for (auto i = 0; i < 100; ++i) { QCOMPARE(voices[i]->value, i); }
+
+		for (const auto voice : voices) { pool.release(voice); }
+		QCOMPARE(alive, 0);
+	}
+
+	void pointersReleaseIntoThePool()
+	{
+		auto alive = 0;
+		auto pool = VoicePool<Voice>{2};
+
+		{
+			auto voice = pool.make(7, &alive);
+			QCOMPARE(voice->value, 7);
+			QCOMPARE(alive, 1);
+		}
+		QCOMPARE(alive, 0);
+
+		auto empty = VoicePool<Voice>::Ptr{};
+		QVERIFY(!empty);
+	}
+};
+
+QTEST_GUILESS_MAIN(VoicePoolTest)
+#include "VoicePoolTest.moc"